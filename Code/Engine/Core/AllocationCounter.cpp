@@ -0,0 +1,51 @@
+#include "Engine/Core/AllocationCounter.hpp"
+#include "Game/EngineBuildPreferences.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+
+#ifdef ENGINE_COUNT_ALLOCATIONS
+static std::atomic<size_t> sAllocationCount = 0;
+
+//////////////////////////////////////////////////////////////////////////
+static void* CountedAllocate(size_t size)
+{
+    sAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    void* memory = malloc(size == 0 ? 1 : size);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void* operator new(size_t size) { return CountedAllocate(size); }
+void* operator new[](size_t size) { return CountedAllocate(size); }
+void operator delete(void* memory) noexcept { free(memory); }
+void operator delete[](void* memory) noexcept { free(memory); }
+void operator delete(void* memory, size_t) noexcept { free(memory); }
+void operator delete[](void* memory, size_t) noexcept { free(memory); }
+#endif // ENGINE_COUNT_ALLOCATIONS
+
+
+//////////////////////////////////////////////////////////////////////////
+bool IsAllocationCountingEnabled()
+{
+#ifdef ENGINE_COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif // ENGINE_COUNT_ALLOCATIONS
+}
+
+//////////////////////////////////////////////////////////////////////////
+size_t GetAllocationCount()
+{
+#ifdef ENGINE_COUNT_ALLOCATIONS
+    return sAllocationCount.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif // ENGINE_COUNT_ALLOCATIONS
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include <cstddef>
+
+
+//////////////////////////////////////////////////////////////////////////
+// counts global operator new calls when ENGINE_COUNT_ALLOCATIONS is defined
+// in the game's EngineBuildPreferences.hpp, used by allocation benchmarks
+//////////////////////////////////////////////////////////////////////////
+bool IsAllocationCountingEnabled();
+size_t GetAllocationCount();    //total heap allocations since program start, 0 if disabled
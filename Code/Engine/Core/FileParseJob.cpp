@@ -0,0 +1,251 @@
+#include "Engine/Core/FileParseJob.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/NamedProperties.hpp"
+#include "Engine/Core/Time.hpp"
+#include <atomic>
+#include <cstdio>
+
+//////////////////////////////////////////////////////////////////////////
+// definitions
+//////////////////////////////////////////////////////////////////////////
+// reads the file of one parse job on the JOB_DISK lane, the parse job waits on it
+class FileReadJob : public Job
+{
+public:
+    FileReadJob(FileParseJob* parseJob)
+        : Job(eJobFlag::JOB_DISK, parseJob->GetPriority())
+        , m_parseJob(parseJob) {}
+
+    virtual void Execute() override
+    {
+        //parse job can't run or be deleted before this finished, it's a successor
+        size_t fileSize = 0;
+        void* fileData = FileReadToNewBuffer(m_parseJob->m_filePath, &fileSize, m_parseJob->m_isBinary);
+        m_parseJob->m_fileData = (char*)fileData;
+        m_parseJob->m_fileSize = fileData != nullptr ? fileSize : 0;
+    }
+
+private:
+    FileParseJob* m_parseJob = nullptr;
+};
+
+//////////////////////////////////////////////////////////////////////////
+class XmlParseJob : public FileParseJob
+{
+public:
+    XmlParseJob(std::string const& filePath, XmlDocument* document, XmlError* outError)
+        : FileParseJob(filePath)
+        , m_document(document)
+        , m_error(outError) {}
+
+    virtual void ParseFile(char const* fileData, size_t fileSize) override
+    {
+        if (fileData == nullptr) {
+            *m_error = XmlError::XML_ERROR_FILE_NOT_FOUND;
+            return;
+        }
+        *m_error = m_document->Parse(fileData, fileSize);
+    }
+
+private:
+    XmlDocument* m_document = nullptr;
+    XmlError* m_error = nullptr;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// benchmark
+//////////////////////////////////////////////////////////////////////////
+static size_t CountLines(char const* fileData, size_t fileSize)
+{
+    size_t lineCount = 0;
+    for (size_t i = 0; i < fileSize; i++) {  //stands in for the parse cost
+        lineCount += fileData[i] == '\n' ? 1 : 0;
+    }
+    return lineCount;
+}
+
+//////////////////////////////////////////////////////////////////////////
+class LineCountJob : public FileParseJob
+{
+public:
+    LineCountJob(std::string const& filePath, std::atomic<size_t>* totalLines)
+        : FileParseJob(filePath)
+        , m_totalLines(totalLines) {}
+
+    virtual void ParseFile(char const* fileData, size_t fileSize) override
+    {
+        if (fileData != nullptr) {
+            *m_totalLines += CountLines(fileData, fileSize);
+        }
+    }
+
+private:
+    std::atomic<size_t>* m_totalLines = nullptr;
+};
+
+//////////////////////////////////////////////////////////////////////////
+COMMAND(file_read_benchmark, "blocking loads vs reads on JOB_DISK lane overlapped with parsing, files=32 kb=512", eEventFlag::EVENT_CONSOLE)
+{
+    int fileCount = args.GetValue("files", 32);
+    int fileKB = args.GetValue("kb", 512);
+    if (fileCount <= 0 || fileKB <= 0) {
+        g_theConsole->PrintError(Stringf("files %i or kb %i invalid", fileCount, fileKB));
+        return false;
+    }
+
+    std::string line = "v 0.125000 -1.500000 2.750000\n";
+    std::string content;
+    while (content.size() < (size_t)fileKB * 1024) {
+        content += line;
+    }
+    std::vector<std::string> filePaths;
+    for (int i = 0; i < fileCount; i++) {
+        filePaths.push_back(Stringf("file_read_benchmark_%i.tmp", i));
+        if (!FileWriteToDisk(filePaths.back(), content.c_str(), content.size())) {
+            g_theConsole->PrintError(Stringf("Failed to write %s", filePaths.back().c_str()));
+            return false;
+        }
+    }
+
+    //one after another on this thread, like a worker blocked per file
+    size_t blockingLines = 0;
+    double startTime = GetCurrentTimeSeconds();
+    for (std::string const& filePath : filePaths) {
+        size_t fileSize = 0;
+        char* fileData = (char*)FileReadToNewBuffer(filePath, &fileSize);
+        if (fileData != nullptr) {
+            blockingLines += CountLines(fileData, fileSize);
+            delete[] fileData;
+        }
+    }
+    double blockingSeconds = GetCurrentTimeSeconds() - startTime;
+
+    //reads queued on the disk lane, each parse starts as soon as its file is in
+    std::atomic<size_t> asyncLines = 0;
+    std::vector<FileParseJob*> jobs;
+    std::vector<int> jobIDs;
+    for (std::string const& filePath : filePaths) {
+        jobs.push_back(new LineCountJob(filePath, &asyncLines));
+        jobIDs.push_back(jobs.back()->GetJobID());
+    }
+    startTime = GetCurrentTimeSeconds();
+    PostFileParseJobs(jobs);
+    for (int jobID : jobIDs) {
+        WaitForJob(jobID);
+    }
+    double asyncSeconds = GetCurrentTimeSeconds() - startTime;
+
+    for (std::string const& filePath : filePaths) {
+        remove(filePath.c_str());
+    }
+
+    g_theConsole->PrintString(Rgba8(255, 255, 0), Stringf("%i files of %i KB", fileCount, fileKB));
+    g_theConsole->PrintString(Rgba8::WHITE, Stringf("blocking: %.2f ms, %zu lines", blockingSeconds * 1000.0, blockingLines));
+    g_theConsole->PrintString(Rgba8::WHITE, Stringf("disk lane: %.2f ms, %zu lines", asyncSeconds * 1000.0, (size_t)asyncLines));
+    return true;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// methods
+//////////////////////////////////////////////////////////////////////////
+FileParseJob::FileParseJob(std::string const& filePath, bool isBinary, unsigned int jobFlags, int priority)
+    : Job(jobFlags, priority)
+    , m_filePath(filePath)
+    , m_isBinary(isBinary)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
+FileParseJob::~FileParseJob()
+{
+    delete[] m_fileData;
+    m_fileData = nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void FileParseJob::Execute()
+{
+    ParseFile(m_fileData, m_fileSize);
+    delete[] m_fileData;
+    m_fileData = nullptr;
+    m_fileSize = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void PostFileParseJob(FileParseJob& job)
+{
+    FileReadJob* readJob = new FileReadJob(&job);
+    job.AddPredecessor(*readJob);
+    PostJob(job);   //held until its read executed
+    PostJob(*readJob);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void PostFileParseJobs(std::vector<FileParseJob*> const& jobs)
+{
+    std::vector<FileReadJob*> readJobs;
+    for (FileParseJob* job : jobs) {
+        FileReadJob* readJob = new FileReadJob(job);
+        job->AddPredecessor(*readJob);
+        PostJob(*job);
+        readJobs.push_back(readJob);
+    }
+    for (FileReadJob* readJob : readJobs) {
+        PostJob(*readJob);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void RunFileParseJobs(std::vector<FileParseJob*> const& jobs)
+{
+    //a read or parse no worker group takes would never finish, waiting on it would hang the load
+    bool canRunJobs = CanRunJobsOfType(eJobFlag::JOB_DISK);
+    for (FileParseJob* job : jobs) {
+        canRunJobs = canRunJobs && CanRunJobsOfType(job->GetJobFlags());
+    }
+    if (!canRunJobs) {
+        for (FileParseJob* job : jobs) {
+            size_t fileSize = 0;
+            char* fileData = (char*)FileReadToNewBuffer(job->GetFilePath(), &fileSize, job->IsBinary());
+            job->ParseFile(fileData, fileData != nullptr ? fileSize : 0);
+            delete[] fileData;
+            delete job;
+        }
+        return;
+    }
+
+    std::vector<int> jobIDs;
+    for (FileParseJob* job : jobs) {
+        jobIDs.push_back(job->GetJobID());
+    }
+    PostFileParseJobs(jobs);
+    for (int jobID : jobIDs) {
+        WaitForJob(jobID);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void LoadXmlFiles(std::vector<std::string> const& filePaths, std::vector<XmlDocument*> const& outDocuments, std::vector<XmlError>& outErrors)
+{
+    GUARANTEE_OR_DIE(filePaths.size() == outDocuments.size(), "one document per xml file");
+    outErrors.assign(filePaths.size(), XmlError::XML_SUCCESS);
+    std::vector<FileParseJob*> jobs;
+    for (size_t fileIdx = 0; fileIdx < filePaths.size(); fileIdx++) {
+        jobs.push_back(new XmlParseJob(filePaths[fileIdx], outDocuments[fileIdx], &outErrors[fileIdx]));
+    }
+    RunFileParseJobs(jobs);
+}
+
+//////////////////////////////////////////////////////////////////////////
+XmlError LoadXmlFile(std::string const& filePath, XmlDocument& outDocument)
+{
+    std::vector<XmlError> errors;
+    LoadXmlFiles({ filePath }, { &outDocument }, errors);
+    return errors[0];
+}
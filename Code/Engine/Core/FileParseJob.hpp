@@ -0,0 +1,48 @@
+#pragma once
+#include "Engine/Core/Job.hpp"
+#include "Engine/Core/XMLUtils.hpp"
+#include <string>
+#include <vector>
+
+
+//////////////////////////////////////////////////////////////////////////
+// job that runs on CPU workers once its file has been read on the JOB_DISK
+// lane, so loading overlaps reading with parsing and never blocks a CPU
+// worker on disk. Reads get their own workers once CreateWorkerThreads(n,
+// JOB_DISK) made some, until then they share the general workers.
+//////////////////////////////////////////////////////////////////////////
+class FileParseJob : public Job
+{
+public:
+    FileParseJob(std::string const& filePath, bool isBinary = false,
+        unsigned int jobFlags = eJobFlag::JOB_GENERAL, int priority = JOB_PRIO_MEDIUM);
+    virtual ~FileParseJob();
+
+    virtual void Execute() override final;
+    virtual void ParseFile(char const* fileData, size_t fileSize) = 0;  //fileData nullptr when the read failed
+
+    std::string const& GetFilePath() const { return m_filePath; }
+    bool IsBinary() const { return m_isBinary; }
+
+private:
+    friend class FileReadJob;
+
+    std::string m_filePath;
+    bool m_isBinary = false;
+    char* m_fileData = nullptr; //freed right after ParseFile
+    size_t m_fileSize = 0;
+};
+
+void PostFileParseJob(FileParseJob& job);
+void PostFileParseJobs(std::vector<FileParseJob*> const& jobs);    //all reads queued before any parse
+//posts the batch and helps until every parse ran, results have to be written out
+//by ParseFile. Unless worker groups take both the reads and the parses, reads and
+//parses here, then deletes the jobs
+void RunFileParseJobs(std::vector<FileParseJob*> const& jobs);
+
+//////////////////////////////////////////////////////////////////////////
+// XML loading through the disk lane, each file parsed into its document
+// on a CPU worker. Errors match XmlDocument::LoadFile
+//////////////////////////////////////////////////////////////////////////
+void LoadXmlFiles(std::vector<std::string> const& filePaths, std::vector<XmlDocument*> const& outDocuments, std::vector<XmlError>& outErrors);
+XmlError LoadXmlFile(std::string const& filePath, XmlDocument& outDocument);
@@ -6,10 +6,10 @@
 #include <stdlib.h>
 #include <io.h>
 
-void* FileReadToNewBuffer( std::string const& filename, size_t* out_size )
+void* FileReadToNewBuffer( std::string const& filename, size_t* out_size, bool isBinary )
 {
 	FILE* fp = nullptr;
-	fopen_s( &fp, filename.c_str(), "r" );
+	fopen_s( &fp, filename.c_str(), isBinary ? "rb" : "r" );
 	if( fp == nullptr )
 	{
 		g_theConsole->PrintError(Stringf("Failed to open file %s", filename.c_str()));
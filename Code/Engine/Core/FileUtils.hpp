@@ -3,7 +3,7 @@
 #include <string>
 #include <vector>
 
-void* FileReadToNewBuffer( std::string const& filename, size_t* out_size );
+void* FileReadToNewBuffer( std::string const& filename, size_t* out_size, bool isBinary = false );
 std::vector<std::string> FileReadLines(std::string const& filename);
 std::string FileReadString(std::string const& filename);
 
@@ -14,6 +14,28 @@ Image::Image( const char* imageFilePath )
 	//stbi_set_flip_vertically_on_load( 1 ); // We prefer m_uvTexCoords has origin (0,0) at BOTTOM LEFT
 	unsigned char* imageData = stbi_load( imageFilePath, &imageTexelSizeX, &imageTexelSizeY, &numComponents, numComponentsRequested );
 
+	SetFromDecodedData( imageFilePath, imageData, imageTexelSizeX, imageTexelSizeY, numComponents );
+	stbi_image_free( imageData );
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+Image::Image( const char* imageFilePath, unsigned char const* fileData, size_t fileSize )
+{
+	int imageTexelSizeX = 0;
+	int imageTexelSizeY = 0;
+	int numComponents = 0;
+	int numComponentsRequested = 0;
+	unsigned char* imageData = stbi_load_from_memory( fileData, (int)fileSize, &imageTexelSizeX, &imageTexelSizeY, &numComponents, numComponentsRequested );
+
+	SetFromDecodedData( imageFilePath, imageData, imageTexelSizeX, imageTexelSizeY, numComponents );
+	stbi_image_free( imageData );
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void Image::SetFromDecodedData( const char* imageFilePath, unsigned char const* imageData, int imageTexelSizeX, int imageTexelSizeY, int numComponents )
+{
 	// Check if the load was successful
 	GUARANTEE_OR_DIE( imageData, Stringf( "Failed to load image \"%s\"", imageFilePath ) );
 	GUARANTEE_OR_DIE( numComponents >= 3 && numComponents <= 4 && imageTexelSizeX > 0 && imageTexelSizeY > 0, Stringf( "ERROR loading image \"%s\" (Bpp=%i, size=%i,%i)", imageFilePath, numComponents, imageTexelSizeX, imageTexelSizeY ) );
@@ -10,6 +10,7 @@ class Image
 {
 public:
 	Image( const char* imageFilePath );
+	Image( const char* imageFilePath, unsigned char const* fileData, size_t fileSize ); // file already in memory
 
 	const std::string& GetImageFilePath() const;
 	IntVec2		       GetDimensions() const;
@@ -21,6 +22,9 @@ public:
 	void               RotateByNumber( int rotationNumber = 0 );
 	void               MirrorByXAxis();
 
+private:
+	void               SetFromDecodedData( const char* imageFilePath, unsigned char const* imageData, int imageTexelSizeX, int imageTexelSizeY, int numComponents );
+
 private:
 	IntVec2            m_dimensions;
 	std::string        m_imageFilePath;	
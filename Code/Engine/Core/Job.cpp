@@ -1,75 +1,153 @@
 #include "Engine/Core/Job.hpp"
+#include "Engine/Core/JobSystemInternal.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/DevConsole.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/NamedProperties.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/AllocationCounter.hpp"
+#include "Engine/Core/JobProfiler.hpp"
+#include "Engine/Core/WorkStealingQueue.hpp"
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 #include <deque>
+#include <algorithm>
+#include <new>
+#include <intrin.h>
+
+static JobSystem* sJobSystem = nullptr;
+static thread_local JobSystemWorkerThread* tCurrentWorker = nullptr;
 
 //////////////////////////////////////////////////////////////////////////
-// definitions
+// one shot wake up for a thread blocked on a job
+class JobSignal
+{
+public:
+    void Wait();
+    void Set();
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_isSet = false;
+};
+
+static JobSignal sJobCompletingSignal;  //placed in a job once its worker is completing it
+
 //////////////////////////////////////////////////////////////////////////
-class JobSystem;
+struct ParallelForContext
+{
+    ParallelRangeFunction function = nullptr;
+    void* context = nullptr;
+    std::atomic<int> nextIndex = 0;
+    int endIndex = 0;
+    int grainSize = 1;
+    int participantCount = 1;
+};
+
+static void RunParallelForChunks(ParallelForContext& context, int participantIndex);
+
+//parallel loops are compute, they never run on a group only taking disk jobs
+constexpr unsigned int PARALLEL_FOR_JOB_FLAGS = eJobFlag::JOB_GENERAL & ~eJobFlag::JOB_DISK;
 
-static JobSystem* sJobSystem = nullptr;
 
 //////////////////////////////////////////////////////////////////////////
-class JobSystemWorkerThread
+// lives on the stack of the ParallelFor caller, never claimed or deleted
+class ParallelForJob : public Job
 {
 public:
-    void WorkerThreadMain();
+    ParallelForJob(ParallelForContext* context, int participantIndex)
+        : Job(PARALLEL_FOR_JOB_FLAGS, JOB_PRIO_HIGH)
+        , m_context(context)
+        , m_participantIndex(participantIndex) {}
 
-    JobSystemWorkerThread(unsigned int jobFlags);
-    ~JobSystemWorkerThread();
+    virtual void Execute() override { RunParallelForChunks(*m_context, m_participantIndex); }
 
 private:
-    std::thread* m_threadObject = nullptr;
-    unsigned int m_jobFlags=0;
-    int m_threadID = 0;
+    ParallelForContext* m_context = nullptr;
+    int m_participantIndex = 0;
 };
 
 //////////////////////////////////////////////////////////////////////////
-class JobSystem
+// jobs posted from outside a group's workers, keyed by priority + frame
+// posted. Aging is just the frame clock moving on: a job's effective priority
+// is key - frame for every job alike, so key order is effective priority
+// order and nothing queued is touched when a frame starts.
+// Keys fall in a ring of coarse bands. A band is a lock free stack of posted
+// jobs plus the sorted leftovers of the last worker that took it. Workers take
+// a whole band at once and sort it into their own deque, nothing locks here.
+class JobPriorityInbox
 {
 public:
-    JobSystem();
-    ~JobSystem();
+    void Push(Job* job, int frame);
+    void ReturnSorted(Job* sorted, int band);   //smallest key first, what a taker couldn't fit
+    int TakeFirstBand(int frame, Job*& outPosted, Job*& outSorted);  //-1 when empty
+    Job* TakeFirstJob(int frame);   //for threads without a deque
+    void Reprioritize(Job* job, int frame);    //moves the job's band, no-op if the job already left
+
+    bool HasBandBefore(int band, int frame) const;
 
-    void UpdatePrioritiesForQueuedJobs();
+private:
+    void PushBand(Job* first, Job* last, int band);  //newest first, last may be unknown
+    bool TakeBand(int band, Job*& outPosted, Job*& outSorted);
+    bool TrySetSorted(Job* sorted, int band);
+    void MarkBandUsed(int band);
 
-    void CreateWorkerThread(unsigned int jobFlags);
-    void PostJob(Job* job);
-    void ClaimAndDeleteAllCompletedJobs();
+private:
+    std::atomic<Job*> m_postedBands[JOB_PRIORITY_BANDS] = {};
+    std::atomic<Job*> m_sortedBands[JOB_PRIORITY_BANDS] = {};
+    std::atomic<uint64_t> m_usedBands = 0;  //may keep the bit of a band just emptied, never misses one
+};
 
-    Job* FetchOneJob(unsigned int jobFlags);
-    void ReturnCompleteJob(Job* job);
+//////////////////////////////////////////////////////////////////////////
+// workers sharing the exact same job flags, they only steal from each other
+struct JobWorkerGroup
+{
+    explicit JobWorkerGroup(unsigned int flags);
 
-    void FinishJob(int jobID);
-    void FinishAnyJobOfType(unsigned int jobFlags);
-    void FinishAllJobsOfType(unsigned int jobFlags);
+    unsigned int jobFlags = 0;
+    JobPriorityInbox postedJobs;        //posted from outside the group's workers
 
-    Job* GetJob(int jobID) const;
-    Job* GetJobOfType(unsigned int jobFlags) const;
-    void GetAllJobsOfType(std::vector<Job*>& allJobs, unsigned int jobFlags) const;
-    bool IsQuiting() const {return m_isQuiting;}
-    bool IsJobComplete(int jobID) const;
+    JobSystemWorkerThread* workers[MAX_WORKERS_PER_GROUP] = {};
+    std::atomic<int> workerCount = 0;
 
-private:
-    void MakeJobUrgent(int jobID);  //assume job is in queuing
-    void DoJobCallback(int jobID);  //assume job is complete
+    std::mutex sleepMutex;              //idle workers park here until a job is posted
+    std::condition_variable sleepCondition;
+    std::atomic<int> sleepingCount = 0;
+    int pendingWakes = 0;               //guarded by sleepMutex
+};
 
-private:
-    std::atomic<bool> m_isQuiting = false;
+//////////////////////////////////////////////////////////////////////////
+class JobSystemWorkerThread
+{
+public:
+    void WorkerThreadMain();
+
+    JobSystemWorkerThread(JobSystem* owner, JobWorkerGroup* group, int indexInGroup);
+    ~JobSystemWorkerThread();
+
+    void Join();
 
-    std::deque<Job*> m_jobsQueued;
-    std::deque<Job*> m_jobsRunning;
-    std::deque<Job*> m_jobsCompleted;
-    mutable std::mutex m_jobsQueuedMutex;
-    mutable std::mutex m_jobsRunningMutex;
-    mutable std::mutex m_jobsCompleteMutex;
+    JobSystem* GetOwner() const { return m_owner; }
+    JobWorkerGroup* GetGroup() const { return m_group; }
+    int GetIndexInGroup() const { return m_indexInGroup; }
+    int GetThreadID() const { return m_threadID; }
 
-    std::vector<JobSystemWorkerThread*> m_workerThreads;
+public:
+    WorkStealingQueue<Job*> m_localJobs;    //jobs posted by this worker or taken from the inbox, others steal
+    std::vector<Job*> m_inboxJobs;          //band being sorted into m_localJobs, as taken then as moved
+    std::vector<Job*> m_inboxSorted;        //newly posted ones in key order
+    int m_inboxBand = -1;                   //last band sorted into m_localJobs, -1 once it ran dry
+
+private:
+    JobSystem* m_owner = nullptr;
+    JobWorkerGroup* m_group = nullptr;
+    std::thread* m_threadObject = nullptr;
+    int m_indexInGroup = 0;
+    int m_threadID = 0;
 };
 
 
@@ -78,6 +156,10 @@ private:
 //////////////////////////////////////////////////////////////////////////
 void InitJobSystem()
 {
+    if (sJobSystem != nullptr) {
+        ERROR_AND_DIE("Multiple Job system existed at same time");
+    }
+
     sJobSystem = new JobSystem();
 }
 
@@ -101,7 +183,7 @@ void JobSystemBeginFrame()
         return;
     }
 
-    sJobSystem->UpdatePrioritiesForQueuedJobs();
+    sJobSystem->BeginFrame();
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -160,427 +242,1393 @@ void WaitForAllJobsOfType(unsigned int jobFlags)
 }
 
 //////////////////////////////////////////////////////////////////////////
-void CloseJobSystem()
+InlineJob* AllocateInlineJob(unsigned int jobFlags, int priority)
 {
-    if(sJobSystem!=nullptr){
-        delete sJobSystem;
-        sJobSystem = nullptr;
+    if (sJobSystem == nullptr) {
+        return nullptr;
     }
+
+    return sJobSystem->AllocateInlineJob(jobFlags, priority);
 }
 
 //////////////////////////////////////////////////////////////////////////
-unsigned int GetHardwareConcurrency()
+JobHandle PostInlineJob(InlineJob& job)
 {
-    return std::thread::hardware_concurrency();
+    if (sJobSystem == nullptr) {
+        g_theConsole->PrintError("Job System not exist while post inline job");
+        return JobHandle();
+    }
+
+    return sJobSystem->PostInlineJob(&job);
 }
 
 //////////////////////////////////////////////////////////////////////////
-Job::Job(unsigned int jobFlags, int priority)
-    : m_jobFlags(jobFlags)
-    , m_priority(priority)
+void WaitForJob(JobHandle handle)
 {
-    static int s_nextJobID = 0;
-    m_jobID = s_nextJobID++;
+    if (sJobSystem == nullptr) {
+        g_theConsole->PrintError("Job System not exist while wait for job handle");
+        return;
+    }
+
+    sJobSystem->FinishJob(handle);
 }
 
 //////////////////////////////////////////////////////////////////////////
-void Job::MakeUrgent()
+bool IsJobComplete(JobHandle handle)
 {
-    m_priority=-1;
+    if (sJobSystem == nullptr) {
+        return true;
+    }
+
+    return sJobSystem->IsJobComplete(handle);
 }
 
 //////////////////////////////////////////////////////////////////////////
-void Job::UpdatePriority()
+void CloseJobSystem()
 {
-    m_priority--;
+    if(sJobSystem!=nullptr){
+        delete sJobSystem;
+        sJobSystem = nullptr;
+    }
 }
 
 //////////////////////////////////////////////////////////////////////////
-void Job::ProgressStatus()
+bool IsJobSystemRunning()
 {
-    m_jobStatus++;
+    return sJobSystem != nullptr;
 }
 
 //////////////////////////////////////////////////////////////////////////
-eJobStatus Job::GetJobStatus() const
+bool CanRunJobsOfType(unsigned int jobFlags)
 {
-    return (eJobStatus)(int)m_jobStatus;
+    return sJobSystem != nullptr && sJobSystem->CanRunJobsOfType(jobFlags);
 }
 
 //////////////////////////////////////////////////////////////////////////
-void JobSystemWorkerThread::WorkerThreadMain()
-{    
-    Rgba8 yellow(255,255,0);
-    std::string printText = Stringf("worker thread #%i...", m_threadID);
-    g_theConsole->PrintString(yellow, "Start " + printText);
+unsigned int GetHardwareConcurrency()
+{
+    return std::thread::hardware_concurrency();
+}
 
-    while (!sJobSystem->IsQuiting()) {
-        Job* newJob = sJobSystem->FetchOneJob(m_jobFlags);
-        if (newJob != nullptr) {
-            newJob->Execute();  
-            sJobSystem->ReturnCompleteJob(newJob);
+//////////////////////////////////////////////////////////////////////////
+void ParallelForRanges(int begin, int end, int grainSize, ParallelRangeFunction function, void* context)
+{
+    if (begin >= end) {
+        return;
+    }
 
-            g_theConsole->PrintString(Rgba8(255,255,255), "Job "+std::to_string(newJob->GetJobID())+" done by %s"+printText);
-        }
-        else {
-            std::this_thread::sleep_for(std::chrono::microseconds(10));
-        }
+    grainSize = grainSize < 1 ? 1 : grainSize;
+    if (sJobSystem == nullptr || sJobSystem->IsQuiting() || end - begin <= grainSize) {
+        function(context, 0, begin, end);
+        return;
     }
 
-    g_theConsole->PrintString(yellow, "End "+printText);
+    ParallelForContext parallelContext;
+    parallelContext.function = function;
+    parallelContext.context = context;
+    parallelContext.nextIndex = begin;
+    parallelContext.endIndex = end;
+    parallelContext.grainSize = grainSize;
+    sJobSystem->RunParallelFor(parallelContext);
 }
 
 //////////////////////////////////////////////////////////////////////////
-JobSystemWorkerThread::JobSystemWorkerThread(unsigned int jobFlags)
-    : m_jobFlags(jobFlags)
+static void RunParallelForChunks(ParallelForContext& context, int participantIndex)
 {
-    m_threadObject = new std::thread(&JobSystemWorkerThread::WorkerThreadMain, this);
-    static int s_nextThreadID = 0;
-    m_threadID = s_nextThreadID++;
+    //guided chunking: big chunks first, down to grain size near the end
+    int current = context.nextIndex.load(std::memory_order_relaxed);
+    while (current < context.endIndex) {
+        int remaining = context.endIndex - current;
+        int chunkSize = std::max(context.grainSize, remaining / (2 * context.participantCount));
+        chunkSize = std::min(chunkSize, remaining);
+        if (context.nextIndex.compare_exchange_weak(current, current + chunkSize, std::memory_order_relaxed)) {
+            context.function(context.context, participantIndex, current, current + chunkSize);
+            current = context.nextIndex.load(std::memory_order_relaxed);
+        }
+    }
 }
 
 //////////////////////////////////////////////////////////////////////////
-JobSystemWorkerThread::~JobSystemWorkerThread()
+JobGraph::~JobGraph()
 {
-    m_threadObject->join();
-    delete m_threadObject;
-    m_threadObject = nullptr;
+    if (!m_jobs.empty()) {
+        g_theConsole->PrintError(Stringf("Job graph destroyed with %i jobs never submitted", (int)m_jobs.size()));
+    }
 }
 
 //////////////////////////////////////////////////////////////////////////
-JobSystem::JobSystem()
+void JobGraph::AddJob(Job* job)
 {
-    if (sJobSystem != nullptr) {
-        ERROR_AND_DIE("Multiple Job system existed at same time");
+    for (Job* existing : m_jobs) {
+        if (existing == job) {
+            return;
+        }
     }
+    m_jobs.push_back(job);
 }
 
 //////////////////////////////////////////////////////////////////////////
-JobSystem::~JobSystem()
+void JobGraph::AddDependency(Job* before, Job* after)
 {
-    m_isQuiting = true;
-    for (size_t i = 0; i < m_workerThreads.size(); i++) {
-        delete m_workerThreads[i];
-        m_workerThreads[i] = nullptr;
-    }
-    ClaimAndDeleteAllCompletedJobs();
+    AddJob(before);
+    AddJob(after);
+    after->AddPredecessor(*before);
 }
 
 //////////////////////////////////////////////////////////////////////////
-void JobSystem::UpdatePrioritiesForQueuedJobs()
+void JobGraph::Submit()
 {
-    m_jobsQueuedMutex.lock();
-    for (Job* job : m_jobsQueued)    {
-        job->UpdatePriority();
+    if (sJobSystem == nullptr) {
+        g_theConsole->PrintError("Job System not exist while submit job graph");
+        return;
+    }
+
+    //posting order doesn't matter, a job is held until posted and all predecessors executed
+    for (Job* job : m_jobs) {
+        sJobSystem->PostJob(job);
     }
-    m_jobsQueuedMutex.unlock();
+    m_jobs.clear();
 }
 
 //////////////////////////////////////////////////////////////////////////
-void JobSystem::CreateWorkerThread(unsigned int jobFlags)
+InlineJob::InlineJob(unsigned int jobFlags, int priority, unsigned int poolSlot)
+    : Job(jobFlags, priority)
+    , m_poolSlot(poolSlot)
 {
-    JobSystemWorkerThread* newThread = new JobSystemWorkerThread(jobFlags);
-    m_workerThreads.push_back(newThread);
 }
 
 //////////////////////////////////////////////////////////////////////////
-void JobSystem::PostJob(Job* job)
+InlineJob::~InlineJob()
 {
-    m_jobsQueuedMutex.lock();
-    for (std::deque<Job*>::iterator it = m_jobsQueued.begin(); it != m_jobsQueued.end(); ++it) {
-        if (job->GetPriority() < (*it)->GetPriority()) {
-            m_jobsQueued.insert(it,job);
-            m_jobsQueuedMutex.unlock();
-            job->ProgressStatus();  //init -> queuing
-            return;
-        }
+    if (m_destroy != nullptr) {
+        m_destroy(m_capture);
     }
-
-    m_jobsQueued.push_back(job);
-    m_jobsQueuedMutex.unlock();
-    job->ProgressStatus();//init -> queuing
 }
 
 //////////////////////////////////////////////////////////////////////////
-void JobSystem::ClaimAndDeleteAllCompletedJobs()
+void InlineJob::Execute()
 {
-    std::deque<Job*> completeJobs;
-    m_jobsCompleteMutex.lock();
-    m_jobsCompleted.swap(completeJobs);
-    m_jobsCompleteMutex.unlock();
-
-    for (Job* job : completeJobs) {
-        job->ProgressStatus();  //complete->callback
-        job->OnCompleteCallback();
-        job->ProgressStatus();  //callback -> finish
-        delete job;
+    if (m_invoke != nullptr) {
+        m_invoke(m_capture);
     }
 }
 
 //////////////////////////////////////////////////////////////////////////
-Job* JobSystem::FetchOneJob(unsigned int jobFlags)
+JobPool::JobPool(int capacity)
+    : m_capacity((unsigned int)capacity)
 {
-    Job* result = nullptr;
-    {
-        std::scoped_lock lock(m_jobsQueuedMutex, m_jobsRunningMutex);
-        if (!m_jobsQueued.empty()) {
-            for (std::deque<Job*>::iterator it = m_jobsQueued.begin(); it != m_jobsQueued.end(); ++it) {
-                Job* job = *it;
-                if (job->GetJobFlags() & jobFlags) {
-                    result = job;
-                    m_jobsQueued.erase(it);
-                    m_jobsRunning.push_back(result);
-                    job->ProgressStatus();  //queuing -> running
-                    break;
-                }
-            }            
-        }
+    m_slots = new Slot[m_capacity];
+    for (unsigned int i = 0; i < m_capacity; i++) {
+        m_slots[i].nextFree = i + 1 < m_capacity ? i + 1 : NO_FREE_SLOT;
     }
-    return result;
+    m_freeHead = 0;
 }
 
 //////////////////////////////////////////////////////////////////////////
-void JobSystem::ReturnCompleteJob(Job* job)
+JobPool::~JobPool()
 {
-    std::scoped_lock lock(m_jobsRunningMutex, m_jobsCompleteMutex);
-    m_jobsCompleted.push_back(job);
-    for (std::deque<Job*>::iterator it = m_jobsRunning.begin(); it != m_jobsRunning.end(); ++it) {
-        if (*it == job) {
-            m_jobsRunning.erase(it);
-            job->ProgressStatus(); //running -> complete
-            return;
-        }
-    }
+    delete[] m_slots;
+    m_slots = nullptr;
 }
 
 //////////////////////////////////////////////////////////////////////////
-void JobSystem::FinishJob(int jobID)
+InlineJob* JobPool::Allocate(unsigned int jobFlags, int priority)
 {
-    Job* thisJob = nullptr;
-    thisJob = GetJob(jobID);
-    if (thisJob == nullptr) {
-        g_theConsole->PrintString(Rgba8::MAGENTA,Stringf("job of id %i doesn't exist in job system", jobID));
-        return;
-    }
+    uint64_t head = m_freeHead.load(std::memory_order_acquire);
+    for (;;) {
+        unsigned int index = (unsigned int)(head & 0xffffffff);
+        if (index == NO_FREE_SLOT) {
+            return nullptr;
+        }
 
-    if (thisJob->GetJobStatus() == JOB_STAT_QUEUING && thisJob->GetPriority()>=0) {
-        MakeJobUrgent(jobID);
+        unsigned int next = m_slots[index].nextFree.load(std::memory_order_relaxed);
+        uint64_t newHead = (((head >> 32) + 1) << 32) | next;
+        if (m_freeHead.compare_exchange_weak(head, newHead, std::memory_order_acquire, std::memory_order_acquire)) {
+            Slot& slot = m_slots[index];
+            slot.jobFlags.store(jobFlags, std::memory_order_relaxed);
+            return new(slot.storage) InlineJob(jobFlags, priority, index);
+        }
     }
-
-    while(thisJob->GetJobStatus()!=JOB_STAT_COMPLETE){
-        std::this_thread::yield();
-    } //wait for complete
-
-    DoJobCallback(jobID);
 }
 
 //////////////////////////////////////////////////////////////////////////
-void JobSystem::FinishAnyJobOfType(unsigned int jobFlags)
+void JobPool::Release(InlineJob* job)
 {
-    Job* aJob = nullptr;
-    aJob = GetJobOfType(jobFlags);
-    if (aJob == nullptr) {
-        g_theConsole->PrintString(Rgba8::MAGENTA,Stringf("job of flags %u no exist in job system",jobFlags));
-        return;
-    }
+    unsigned int index = job->GetPoolSlot();
+    Slot& slot = m_slots[index];
+    job->~InlineJob();
 
-    if (aJob->GetJobStatus() == JOB_STAT_QUEUING && aJob->GetPriority()>=0) {
-        MakeJobUrgent(aJob->GetJobID());
-    }
-
-    while (aJob->GetJobStatus() != JOB_STAT_COMPLETE) {
-        std::this_thread::yield();
-    }
+    unsigned int generation = slot.generation.load(std::memory_order_relaxed) + 1;
+    slot.generation.store(generation == 0 ? 1 : generation, std::memory_order_release);   //handles go stale
 
-    DoJobCallback(aJob->GetJobID());
+    uint64_t head = m_freeHead.load(std::memory_order_relaxed);
+    do {
+        slot.nextFree.store((unsigned int)(head & 0xffffffff), std::memory_order_relaxed);
+    } while (!m_freeHead.compare_exchange_weak(head, (((head >> 32) + 1) << 32) | index, std::memory_order_release, std::memory_order_relaxed));
 }
 
 //////////////////////////////////////////////////////////////////////////
-void JobSystem::FinishAllJobsOfType(unsigned int jobFlags)
+JobHandle JobPool::GetHandle(InlineJob const* job) const
 {
-    std::vector<Job*> allJobs;
-    GetAllJobsOfType(allJobs, jobFlags);
-
-    //make queuing jobs urgent
-    for (Job* job : allJobs) {
-        if (job->GetJobStatus() == JOB_STAT_QUEUING && job->GetPriority()>=0) {
-            MakeJobUrgent(job->GetJobID());
-        }
-    }
+    JobHandle handle;
+    handle.slotIndex = job->GetPoolSlot();
+    handle.generation = m_slots[handle.slotIndex].generation.load(std::memory_order_relaxed);
+    return handle;
+}
 
-    //wait for jobs to complete
-    bool isComplete = false;
-    while (!isComplete) {
-        isComplete=true;
-        for (Job* job : allJobs) {
-            if(job->GetJobStatus()!=JOB_STAT_FINISH){
-                isComplete=false;
-                if (job->GetJobStatus() == JOB_STAT_COMPLETE) {
-                    DoJobCallback(job->GetJobID());
-                }
-            }
-        }
+//////////////////////////////////////////////////////////////////////////
+bool JobPool::IsHandleLive(JobHandle handle) const
+{
+    if (!handle.IsValid() || handle.slotIndex >= m_capacity) {
+        return false;
     }
+    return m_slots[handle.slotIndex].generation.load(std::memory_order_acquire) == handle.generation;
 }
 
 //////////////////////////////////////////////////////////////////////////
-Job* JobSystem::GetJob(int jobID) const
+unsigned int JobPool::GetJobFlags(JobHandle handle) const
 {
-    //complete
-    m_jobsCompleteMutex.lock();
-    for (Job* job : m_jobsCompleted) {
-        if (job->GetJobID() == jobID) {
-            m_jobsCompleteMutex.unlock();
-            return job;
-        }
-    }
-    m_jobsCompleteMutex.unlock();
+    return m_slots[handle.slotIndex].jobFlags.load(std::memory_order_relaxed);
+}
 
-    //running
-    m_jobsRunningMutex.lock();
-    for (Job* job : m_jobsRunning) {
-        if (job->GetJobID() == jobID) {
-            m_jobsRunningMutex.unlock();
-            return job;
-        }
+//////////////////////////////////////////////////////////////////////////
+JobTable::JobTable(int capacity)
+{
+    m_minCapacity = 2;
+    while (m_minCapacity < (unsigned int)capacity) {
+        m_minCapacity <<= 1;
     }
-    m_jobsRunningMutex.unlock();    
+    Rehash(m_minCapacity);
+}
 
-    //queued
-    m_jobsQueuedMutex.lock();
-    for (Job* job : m_jobsQueued) {
-        if (job->GetJobID() == jobID) {
-            m_jobsQueuedMutex.unlock();
-            return job;
-        }
+//////////////////////////////////////////////////////////////////////////
+void JobTable::Add(Job* job)
+{
+    if ((m_jobs.size() + 1) * 2 > m_slots.size()) {    //at most half full keeps probes short
+        Rehash((unsigned int)m_slots.size() << 1);
     }
-    m_jobsQueuedMutex.unlock();
 
-    return nullptr;
+    m_slots[FindSlot(job->GetJobID())] = (int)m_jobs.size();
+    m_jobs.push_back(job);
 }
 
 //////////////////////////////////////////////////////////////////////////
-Job* JobSystem::GetJobOfType(unsigned int jobFlags) const
+void JobTable::Remove(Job* job)
 {
-    //complete
-    m_jobsCompleteMutex.lock();
-    for (Job* job : m_jobsCompleted) {
-        if (job->GetJobFlags() & jobFlags) {
-            m_jobsCompleteMutex.unlock();
-            return job;
-        }
+    unsigned int hole = FindSlot(job->GetJobID());
+    int jobIndex = m_slots[hole];
+    if (jobIndex == EMPTY_SLOT || m_jobs[jobIndex] != job) {
+        return;
     }
-    m_jobsCompleteMutex.unlock();
 
-     //running
-    m_jobsRunningMutex.lock();
-    for (Job* job : m_jobsRunning) {
-        if (job->GetJobFlags() & jobFlags) {
-            m_jobsRunningMutex.unlock();
-            return job;
+    //shift later entries of the probe run back, no tombstones
+    for (unsigned int next = (hole + 1) & m_mask; m_slots[next] != EMPTY_SLOT; next = (next + 1) & m_mask) {
+        unsigned int home = GetHomeSlot(m_jobs[m_slots[next]]->GetJobID());
+        if (((next - home) & m_mask) >= ((next - hole) & m_mask)) {
+            m_slots[hole] = m_slots[next];
+            hole = next;
         }
     }
-    m_jobsRunningMutex.unlock();
+    m_slots[hole] = EMPTY_SLOT;
+
+    //last job fills the gap in the list
+    int lastIndex = (int)m_jobs.size() - 1;
+    if (jobIndex != lastIndex) {
+        Job* lastJob = m_jobs[lastIndex];
+        m_slots[FindSlot(lastJob->GetJobID())] = jobIndex;
+        m_jobs[jobIndex] = lastJob;
+    }
+    m_jobs.pop_back();
 
-    //queued
-    m_jobsQueuedMutex.lock();
-    for (Job* job : m_jobsQueued) {
-        if (job->GetJobFlags() & jobFlags) {
-            m_jobsQueuedMutex.unlock();
-            return job;
-        }
+    if (m_slots.size() > m_minCapacity && m_jobs.size() * 8 < m_slots.size()) {
+        Rehash((unsigned int)m_slots.size() >> 1);
     }
-    m_jobsQueuedMutex.unlock();
+}
 
-    return nullptr;
+//////////////////////////////////////////////////////////////////////////
+Job* JobTable::Find(int jobID) const
+{
+    int jobIndex = m_slots[FindSlot(jobID)];
+    return jobIndex == EMPTY_SLOT ? nullptr : m_jobs[jobIndex];
 }
 
 //////////////////////////////////////////////////////////////////////////
-void JobSystem::GetAllJobsOfType(std::vector<Job*>& allJobs, unsigned int jobFlags) const
+unsigned int JobTable::FindSlot(int jobID) const
 {
-    m_jobsCompleteMutex.lock();
-    for (Job* job : m_jobsCompleted) {
-        if (job->GetJobFlags() & jobFlags) {
-            allJobs.push_back(job);
-        }
+    unsigned int slot = GetHomeSlot(jobID);
+    while (m_slots[slot] != EMPTY_SLOT && m_jobs[m_slots[slot]]->GetJobID() != jobID) {
+        slot = (slot + 1) & m_mask;
     }
-    m_jobsCompleteMutex.unlock();
+    return slot;
+}
 
-     //running
-    m_jobsRunningMutex.lock();
-    for (Job* job : m_jobsRunning) {
-        if (job->GetJobFlags() & jobFlags) {
-            allJobs.push_back(job);
-        }
+//////////////////////////////////////////////////////////////////////////
+void JobTable::Rehash(unsigned int capacity)
+{
+    m_slots.assign(capacity, EMPTY_SLOT);
+    m_mask = capacity - 1;
+    m_shift = 32;
+    while ((1u << (32 - m_shift)) < capacity) {
+        m_shift--;
     }
-    m_jobsRunningMutex.unlock();
-
-    //queued
-    m_jobsQueuedMutex.lock();
-    for (Job* job : m_jobsQueued) {
-        if (job->GetJobFlags() & jobFlags) {
-            allJobs.push_back(job);
-        }
+    for (int jobIndex = 0; jobIndex < (int)m_jobs.size(); jobIndex++) {
+        m_slots[FindSlot(m_jobs[jobIndex]->GetJobID())] = jobIndex;
     }
-    m_jobsQueuedMutex.unlock();
 }
 
 //////////////////////////////////////////////////////////////////////////
-bool JobSystem::IsJobComplete(int jobID) const
+Job::Job(unsigned int jobFlags, int priority)
+    : m_jobFlags(jobFlags)
+    , m_priority(priority)
 {
-    m_jobsCompleteMutex.lock();
-    for (Job* job : m_jobsCompleted) {
-        if (job->GetJobID() == jobID) {
-            m_jobsCompleteMutex.unlock();
-            return true;
-        }
-    }
-    m_jobsCompleteMutex.unlock();
-    return false;
+    static std::atomic<int> s_nextJobID = 0;   //jobs are posted from workers too
+    m_jobID = s_nextJobID++;
 }
 
 //////////////////////////////////////////////////////////////////////////
-void JobSystem::MakeJobUrgent(int jobID)
+void Job::MakeUrgent()
 {
-    Job* job = nullptr;
+    m_priority=-1;
+}
 
-    m_jobsQueuedMutex.lock();
-    for (std::deque<Job*>::iterator it = m_jobsQueued.begin(); it!=m_jobsQueued.end();++it) {
-        job = *it;
-        if (job->GetJobID() == jobID) {
-            m_jobsQueued.erase(it);
-            break;
-        }
+
+//////////////////////////////////////////////////////////////////////////
+void Job::ProgressStatus()
+{
+    m_jobStatus++;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Job::AddPredecessor(Job& predecessor)
+{
+    if (GetJobStatus() != JOB_STAT_INIT) {
+        g_theConsole->PrintError(Stringf("job %i already posted, can't add predecessor %i", GetJobID(), predecessor.GetJobID()));
+        return;
     }
-    if (job != nullptr) {
-        m_jobsQueued.push_front(job);
+
+    m_pendingPredecessors++;
+    predecessor.LockSuccessors();
+    bool isReleased = predecessor.m_isSuccessorsReleased;
+    if (!isReleased) {
+        predecessor.m_successors.push_back(this);
     }
-    m_jobsQueuedMutex.unlock();
+    predecessor.UnlockSuccessors();
 
-    if (job != nullptr) {
-        job->MakeUrgent();
+    if (isReleased) {   //predecessor already executed
+        m_pendingPredecessors--;
     }
 }
 
 //////////////////////////////////////////////////////////////////////////
-void JobSystem::DoJobCallback(int jobID)
+void Job::LockSuccessors()
 {
-    Job* job=nullptr;
-
-    m_jobsCompleteMutex.lock();
-    for (std::deque<Job*>::iterator it = m_jobsCompleted.begin(); it != m_jobsCompleted.end(); ++it) {
-        job=*it;
-        if (job->GetJobID() == jobID) {
-            m_jobsCompleted.erase(it);
-            break;
-        }
+    bool expected = false;
+    while (!m_successorsLock.compare_exchange_weak(expected, true, std::memory_order_acquire)) {
+        expected = false;
     }
-    m_jobsCompleteMutex.unlock();
+}
 
-    if (job != nullptr) {
-        job->ProgressStatus();  //complete->callback
-        job->OnCompleteCallback();
-        job->ProgressStatus();  //callback -> finish
-        delete job;
+//////////////////////////////////////////////////////////////////////////
+void Job::UnlockSuccessors()
+{
+    m_successorsLock.store(false, std::memory_order_release);
+}
+
+//////////////////////////////////////////////////////////////////////////
+eJobStatus Job::GetJobStatus() const
+{
+    return (eJobStatus)(int)m_jobStatus;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobSignal::Wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this]() { return m_isSet; });
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobSignal::Set()
+{
+    //notify under lock, the waiter owns this signal and may destroy it right after
+    std::scoped_lock lock(m_mutex);
+    m_isSet = true;
+    m_condition.notify_all();
+}
+
+//////////////////////////////////////////////////////////////////////////
+static int CountTrailingZeros(uint64_t bits)
+{
+    unsigned long index = 0;
+    _BitScanForward64(&index, bits);
+    return (int)index;
+}
+
+//////////////////////////////////////////////////////////////////////////
+static uint64_t RotateRight(uint64_t bits, int count)
+{
+    return count == 0 ? bits : (bits >> count) | (bits << (64 - count));
+}
+
+//////////////////////////////////////////////////////////////////////////
+static int GetPriorityBand(int key)
+{
+    return (key >> JOB_PRIORITY_BAND_SHIFT) & (JOB_PRIORITY_BANDS - 1);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// the ring walked in key order starts past the newest key possible, plus a
+// band of slack for a frame starting meanwhile. Only jobs starved for over
+// twenty thousand frames wrap around and lose their place
+static int GetFirstPriorityBand(int frame)
+{
+    return (GetPriorityBand(frame + JOB_PRIORITY_MAX) + 2) & (JOB_PRIORITY_BANDS - 1);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobPriorityInbox::Push(Job* job, int frame)
+{
+    int key = std::clamp((int)job->m_priority, JOB_PRIORITY_MIN, JOB_PRIORITY_MAX) + frame;
+    job->m_queueKey = key;
+    job->m_inbox = this;
+    PushBand(job, job, GetPriorityBand(key));
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobPriorityInbox::PushBand(Job* first, Job* last, int band)
+{
+    Job* head = m_postedBands[band].load(std::memory_order_relaxed);
+    do {
+        if (last == nullptr && head != nullptr) {  //tail only needed to link in front of queued jobs
+            for (last = first; last->m_nextQueued != nullptr; last = last->m_nextQueued) {}
+        }
+        if (last != nullptr) {
+            last->m_nextQueued = head;
+        }
+    } while (!m_postedBands[band].compare_exchange_weak(head, first));
+    MarkBandUsed(band);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobPriorityInbox::ReturnSorted(Job* sorted, int band)
+{
+    if (TrySetSorted(sorted, band)) {
+        return;
+    }
+
+    //another taker left its own, these go back as posted, newest first
+    Job* posted = nullptr;
+    for (Job* job = sorted; job != nullptr; ) {
+        Job* next = job->m_nextQueued;
+        job->m_nextQueued = posted;
+        posted = job;
+        job = next;
+    }
+    PushBand(posted, sorted, band);
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool JobPriorityInbox::TrySetSorted(Job* sorted, int band)
+{
+    Job* expected = nullptr;
+    if (!m_sortedBands[band].compare_exchange_strong(expected, sorted)) {
+        return false;
+    }
+    MarkBandUsed(band);
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobPriorityInbox::MarkBandUsed(int band)
+{
+    //set after the jobs are in: a taker clears the bit before taking the band,
+    //so either it takes these jobs or the bit stays set for the next one
+    uint64_t bandBit = (uint64_t)1 << band;
+    if ((m_usedBands.load() & bandBit) == 0) {
+        m_usedBands.fetch_or(bandBit);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool JobPriorityInbox::TakeBand(int band, Job*& outPosted, Job*& outSorted)
+{
+    m_usedBands.fetch_and(~((uint64_t)1 << band));
+    outPosted = m_postedBands[band].exchange(nullptr);
+    outSorted = m_sortedBands[band].exchange(nullptr);
+    return outPosted != nullptr || outSorted != nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////
+int JobPriorityInbox::TakeFirstBand(int frame, Job*& outPosted, Job*& outSorted)
+{
+    uint64_t usedBands = m_usedBands.load();
+    while (usedBands != 0) {
+        int firstBand = GetFirstPriorityBand(frame);
+        int band = (firstBand + CountTrailingZeros(RotateRight(usedBands, firstBand))) & (JOB_PRIORITY_BANDS - 1);
+        if (TakeBand(band, outPosted, outSorted)) {
+            return band;
+        }
+        usedBands = m_usedBands.load();  //bit of a band already taken, cleared now
+    }
+    return -1;
+}
+
+//////////////////////////////////////////////////////////////////////////
+Job* JobPriorityInbox::TakeFirstJob(int frame)
+{
+    Job* posted = nullptr;
+    Job* sorted = nullptr;
+    int band = TakeFirstBand(frame, posted, sorted);
+    if (band < 0) {
+        return nullptr;
+    }
+
+    //no deque to sort the band into. The leftovers were taken before anything
+    //posted since, so their head goes first, else the newest posted job. The
+    //rest goes back as it was, the band is usually still empty then
+    Job* job = nullptr;
+    if (sorted != nullptr) {
+        job = sorted;
+        sorted = sorted->m_nextQueued;
+    }
+    else {
+        job = posted;
+        posted = posted->m_nextQueued;
+    }
+    if (sorted != nullptr) {
+        ReturnSorted(sorted, band);
+    }
+    if (posted != nullptr) {
+        PushBand(posted, nullptr, band);
+    }
+    job->m_inbox = nullptr;
+    return job;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobPriorityInbox::Reprioritize(Job* job, int frame)
+{
+    int key = std::clamp((int)job->m_priority, JOB_PRIORITY_MIN, JOB_PRIORITY_MAX) + frame;
+    if (job->m_inbox != this || job->m_queueKey <= key) {
+        return;     //a worker took it, or it is already this urgent
+    }
+
+    //a stack can't give up one job from the middle, the job's whole band moves
+    //up with it. Jobs sharing a band were within a band width of it anyway
+    int band = GetPriorityBand(job->m_queueKey);
+    Job* posted = nullptr;
+    Job* sorted = nullptr;
+    if (!TakeBand(band, posted, sorted)) {
+        return;
+    }
+
+    //posted jobs take the new key, their band is counting sorted on it. The
+    //leftovers keep theirs, they are only merged by key and move over as is,
+    //or stay put if the urgent band holds leftovers of its own
+    int urgentBand = GetPriorityBand(key);
+    if (posted != nullptr) {
+        Job* last = posted;
+        while (true) {
+            last->m_queueKey = std::min((int)last->m_queueKey, key);
+            if (last->m_nextQueued == nullptr) {
+                break;
+            }
+            last = last->m_nextQueued;
+        }
+        PushBand(posted, last, urgentBand);
+    }
+    if (sorted != nullptr && !TrySetSorted(sorted, urgentBand)) {
+        ReturnSorted(sorted, band);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool JobPriorityInbox::HasBandBefore(int band, int frame) const
+{
+    uint64_t usedBands = m_usedBands.load(std::memory_order_relaxed);
+    if (usedBands == 0) {
+        return false;
+    }
+
+    int firstBand = GetFirstPriorityBand(frame);
+    int rank = (band - firstBand) & (JOB_PRIORITY_BANDS - 1);
+    return (RotateRight(usedBands, firstBand) & (((uint64_t)1 << rank) - 1)) != 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+JobWorkerGroup::JobWorkerGroup(unsigned int flags)
+    : jobFlags(flags)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobSystemWorkerThread::WorkerThreadMain()
+{
+    tCurrentWorker = this;
+
+    Rgba8 yellow(255,255,0);
+    std::string printText = Stringf("worker thread #%i...", m_threadID);
+    g_theConsole->PrintString(yellow, "Start " + printText);
+    BeginJobTraceThread(Stringf("worker #%i", m_threadID));
+
+    int idleRounds = 0;
+    while (!m_owner->IsQuiting()) {
+        Job* newJob = m_owner->FetchOneJob(this);
+        if (newJob == nullptr && idleRounds < WORKER_SPINS_BEFORE_PARK) {
+            idleRounds++;
+            std::this_thread::yield();
+            continue;
+        }
+        if (newJob == nullptr) {
+            newJob = m_owner->ParkWorker(this);
+        }
+
+        idleRounds = 0;
+        if (newJob != nullptr) {
+            m_owner->RunJob(newJob);
+        }
+    }
+
+    EndJobTraceThread();
+    g_theConsole->PrintString(yellow, "End "+printText);
+    tCurrentWorker = nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////
+JobSystemWorkerThread::JobSystemWorkerThread(JobSystem* owner, JobWorkerGroup* group, int indexInGroup)
+    : m_localJobs(WORKER_LOCAL_QUEUE_SIZE)
+    , m_owner(owner)
+    , m_group(group)
+    , m_indexInGroup(indexInGroup)
+{
+    m_inboxJobs.reserve(WORKER_LOCAL_QUEUE_SIZE);
+    m_inboxSorted.reserve(WORKER_LOCAL_QUEUE_SIZE);
+    static std::atomic<int> s_nextThreadID = 0;
+    m_threadID = s_nextThreadID++;
+    m_threadObject = new std::thread(&JobSystemWorkerThread::WorkerThreadMain, this);
+}
+
+//////////////////////////////////////////////////////////////////////////
+JobSystemWorkerThread::~JobSystemWorkerThread()
+{
+    Join();
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobSystemWorkerThread::Join()
+{
+    if (m_threadObject != nullptr) {
+        m_threadObject->join();
+        delete m_threadObject;
+        m_threadObject = nullptr;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+JobSystem::JobSystem()
+    : m_jobsInFlight(JOB_TABLE_INITIAL_CAPACITY)
+    , m_jobPool(JOB_POOL_CAPACITY)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
+JobSystem::~JobSystem()
+{
+    m_isQuiting = true;
+    for (int i = 0; i < m_groupCount; i++) {
+        JobWorkerGroup* group = m_groups[i];
+        std::scoped_lock lock(group->sleepMutex);
+        group->sleepCondition.notify_all();
+    }
+    for (size_t i = 0; i < m_workerThreads.size(); i++) {
+        m_workerThreads[i]->Join();   //others may still steal from it until all stopped
+    }
+    for (size_t i = 0; i < m_workerThreads.size(); i++) {
+        delete m_workerThreads[i];
+        m_workerThreads[i] = nullptr;
+    }
+    ClaimAndDeleteAllCompletedJobs();
+    NotifyPoolWaiters();
+
+    for (int i = 0; i < m_groupCount; i++) {
+        delete m_groups[i];
+        m_groups[i] = nullptr;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobSystem::BeginFrame()
+{
+    m_frame++;  //every queued job is one frame older, nothing to touch
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobSystem::CreateWorkerThread(unsigned int jobFlags)
+{
+    JobWorkerGroup* group = nullptr;
+    int groupCount = m_groupCount;
+    for (int i = 0; i < groupCount; i++) {
+        if (m_groups[i]->jobFlags == jobFlags) {
+            group = m_groups[i];
+            break;
+        }
+    }
+    if (group == nullptr) {
+        if (groupCount >= MAX_JOB_WORKER_GROUPS) {
+            g_theConsole->PrintError(Stringf("Too many worker flag combinations, max %i", MAX_JOB_WORKER_GROUPS));
+            return;
+        }
+        group = new JobWorkerGroup(jobFlags);
+    }
+
+    int workerIndex = group->workerCount;
+    if (workerIndex >= MAX_WORKERS_PER_GROUP) {
+        g_theConsole->PrintError(Stringf("Too many workers of flags %u, max %i", jobFlags, MAX_WORKERS_PER_GROUP));
+        return;
+    }
+
+    JobSystemWorkerThread* newThread = new JobSystemWorkerThread(this, group, workerIndex);
+    group->workers[workerIndex] = newThread;
+    group->workerCount = workerIndex + 1;
+    m_workerThreads.push_back(newThread);
+    if (workerIndex == 0) { //publish new group only once it has a worker to post to
+        m_groups[groupCount] = group;
+        m_groupCount = groupCount + 1;
+    }
+
+    //hand over jobs posted before this worker existed
+    std::deque<Job*> waitingJobs;
+    {
+        std::scoped_lock lock(m_jobsInFlightMutex);
+        waitingJobs.swap(m_jobsWithoutWorker);
+    }
+    for (Job* job : waitingJobs) {
+        JobWorkerGroup* jobGroup = FindGroupForJob(job->GetJobFlags());
+        if (jobGroup != nullptr) {
+            EnqueueJob(jobGroup, job);
+        }
+        else {
+            std::scoped_lock lock(m_jobsInFlightMutex);
+            m_jobsWithoutWorker.push_back(job);
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobSystem::PostJob(Job* job)
+{
+    job->ProgressStatus();  //init -> queuing
+    {
+        std::scoped_lock lock(m_jobsInFlightMutex);
+        m_jobsInFlight.Add(job);
+    }
+
+    if (job->m_pendingPredecessors.fetch_sub(1) == 1) {
+        ScheduleJob(job);
+    } //else the last predecessor to execute schedules it
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobSystem::ClaimAndDeleteAllCompletedJobs()
+{
+    std::deque<Job*> completeJobs;
+    m_jobsCompleteMutex.lock();
+    m_jobsCompleted.swap(completeJobs);
+    m_jobsCompleteMutex.unlock();
+
+    for (Job* job : completeJobs) {
+        if (ClaimJobCallback(job)) {
+            DoJobCallback(job);
+        }
+        else if (job->GetJobStatus() != JOB_STAT_FINISH) {
+            //another thread is inside its callback right now, delete next time
+            std::scoped_lock lock(m_jobsCompleteMutex);
+            m_jobsCompleted.push_back(job);
+            continue;
+        }
+        delete job;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+InlineJob* JobSystem::AllocateInlineJob(unsigned int jobFlags, int priority)
+{
+    InlineJob* job = m_jobPool.Allocate(jobFlags, priority);
+    int idleYields = 0;
+    while (job == nullptr) {    //pool full, drain some work before trying again
+        if (HelpWithOneJob(jobFlags)) {
+            idleYields = 0;
+        }
+        else if (idleYields++ < JOB_POOL_FULL_MAX_YIELDS) {
+            std::this_thread::yield();
+        }
+        else {
+            //slots hold work this thread can't run, not posted yet, on another
+            //lane or without a worker. The caller runs its work in place
+            return nullptr;
+        }
+        job = m_jobPool.Allocate(jobFlags, priority);
+    }
+
+    job->m_storage = JOB_STORAGE_POOL;
+    return job;
+}
+
+//////////////////////////////////////////////////////////////////////////
+JobHandle JobSystem::PostInlineJob(InlineJob* job)
+{
+    //taken before posting, the slot may be recycled as soon as it is queued
+    JobHandle handle = m_jobPool.GetHandle(job);
+    job->ProgressStatus();  //init -> queuing
+    if (job->m_pendingPredecessors.fetch_sub(1) == 1) {
+        ScheduleJob(job);
+    }
+    return handle;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobSystem::RunParallelFor(ParallelForContext& context)
+{
+    //no compute group means no helpers, the caller runs every range
+    JobWorkerGroup* group = FindGroupForJob(PARALLEL_FOR_JOB_FLAGS);
+    int rangeCount = (context.endIndex - context.nextIndex + context.grainSize - 1) / context.grainSize;
+    int helperCount = group != nullptr ? (int)group->workerCount : 0;
+    helperCount = std::min(helperCount, std::min(rangeCount - 1, MAX_PARALLEL_PARTICIPANTS - 1));
+    context.participantCount = helperCount + 1;
+
+    //helpers are constructed in place on this stack, only as many as needed
+    alignas(ParallelForJob) unsigned char helperStorage[sizeof(ParallelForJob) * (MAX_PARALLEL_PARTICIPANTS - 1)];
+    ParallelForJob* helpers = reinterpret_cast<ParallelForJob*>(helperStorage);
+    for (int i = 0; i < helperCount; i++) {
+        ParallelForJob* helper = new(&helpers[i]) ParallelForJob(&context, i + 1);
+        helper->m_storage = JOB_STORAGE_EXTERNAL;
+        helper->ProgressStatus();   //init -> queuing
+        EnqueueJob(group, helper);
+    }
+
+    RunParallelForChunks(context, 0);
+
+    for (int i = 0; i < helperCount; i++) {
+        WaitForJobComplete(&helpers[i]);    //may still be queued, then runs empty
+        helpers[i].~ParallelForJob();
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobSystem::MakeJobUrgent(Job* job)
+{
+    job->MakeUrgent();
+    JobPriorityInbox* inbox = job->m_inbox;
+    if (inbox != nullptr) { //jobs in a worker's own queue can't be moved, waiters help with them
+        inbox->Reprioritize(job, m_frame);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+Job* JobSystem::FetchOneJob(JobSystemWorkerThread* worker)
+{
+    //a band more urgent than the one the deque was filled from goes on top of it
+    JobWorkerGroup* group = worker->GetGroup();
+    if (worker->m_inboxBand >= 0 && group->postedJobs.HasBandBefore(worker->m_inboxBand, m_frame)) {
+        TakePostedJobs(worker);
+    }
+
+    //own spawned work first, it is what the job this worker ran is waiting on
+    Job* result = nullptr;
+    if (!worker->m_localJobs.Pop(result)) {
+        worker->m_inboxBand = -1;
+        if (!TakePostedJobs(worker) || !worker->m_localJobs.Pop(result)) {
+            result = StealJob(group, worker->GetIndexInGroup());
+        }
+    }
+    if (result != nullptr) {
+        result->ProgressStatus();   //queuing -> running
+    }
+    return result;
+}
+
+//////////////////////////////////////////////////////////////////////////
+Job* JobSystem::FetchJobToHelp(JobWorkerGroup* group)
+{
+    //deques hold jobs already taken from the inbox in key order, those come first
+    Job* result = StealJob(group, -1);
+    if (result == nullptr) {
+        result = group->postedJobs.TakeFirstJob(m_frame);
+    }
+    if (result != nullptr) {
+        result->ProgressStatus();   //queuing -> running
+    }
+    return result;
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool JobSystem::TakePostedJobs(JobSystemWorkerThread* worker)
+{
+    JobWorkerGroup* group = worker->GetGroup();
+    Job* posted = nullptr;
+    Job* sorted = nullptr;
+    int band = group->postedJobs.TakeFirstBand(m_frame, posted, sorted);
+    if (band < 0) {
+        return false;
+    }
+
+    //counting sort of the newly posted jobs on the key inside the band. The
+    //stack is newest first, so it is walked backwards to keep posting order
+    //among equal keys
+    constexpr int bandKeyCount = 1 << JOB_PRIORITY_BAND_SHIFT;
+    std::vector<Job*>& jobs = worker->m_inboxJobs;
+    std::vector<Job*>& batch = worker->m_inboxSorted;
+    jobs.clear();
+    for (Job* job = posted; job != nullptr; job = job->m_nextQueued) {
+        jobs.push_back(job);
+    }
+    int keyStarts[bandKeyCount + 1] = {};
+    for (Job* job : jobs) {
+        keyStarts[(job->m_queueKey & (bandKeyCount - 1)) + 1]++;
+    }
+    for (int i = 0; i < bandKeyCount; i++) {
+        keyStarts[i + 1] += keyStarts[i];
+    }
+    batch.resize(jobs.size());
+    for (int i = (int)jobs.size() - 1; i >= 0; i--) {
+        batch[keyStarts[jobs[i]->m_queueKey & (bandKeyCount - 1)]++] = jobs[i];
+    }
+
+    //merged with the leftovers of the last taker, older on equal keys
+    int batchIndex = 0;
+    int batchCount = (int)batch.size();
+    auto takeNext = [&]() {
+        Job* next = nullptr;
+        if (sorted != nullptr && (batchIndex == batchCount || sorted->m_queueKey <= batch[batchIndex]->m_queueKey)) {
+            next = sorted;
+            sorted = sorted->m_nextQueued;
+        }
+        else {
+            next = batch[batchIndex++];
+        }
+        return next;
+    };
+
+    //as many as the deque takes. The rest stays sorted for the next taker,
+    //so a band bigger than a deque isn't walked again for every refill
+    int freeCount = worker->m_localJobs.GetCapacity() - worker->m_localJobs.GetCount();
+    jobs.clear();
+    while ((int)jobs.size() < freeCount && (sorted != nullptr || batchIndex < batchCount)) {
+        jobs.push_back(takeNext());
+    }
+    if (batchIndex < batchCount) {
+        Job* merged = nullptr;
+        Job** mergedTail = &merged;
+        while (sorted != nullptr || batchIndex < batchCount) {
+            Job* next = takeNext();
+            *mergedTail = next;
+            mergedTail = &next->m_nextQueued;
+        }
+        *mergedTail = nullptr;
+        sorted = merged;
+    }
+    if (sorted != nullptr) {
+        group->postedJobs.ReturnSorted(sorted, band);
+    }
+
+    //most urgent pushed last, it is on the bottom the owner pops from
+    for (int i = (int)jobs.size() - 1; i >= 0; i--) {
+        jobs[i]->m_inbox = nullptr;
+        worker->m_localJobs.Push(jobs[i]);
+    }
+    worker->m_inboxBand = band;
+    return !jobs.empty();
+}
+
+//////////////////////////////////////////////////////////////////////////
+Job* JobSystem::ParkWorker(JobSystemWorkerThread* worker)
+{
+    JobWorkerGroup* group = worker->GetGroup();
+    std::unique_lock<std::mutex> lock(group->sleepMutex);
+    group->sleepingCount++;
+
+    //check again after announcing, a concurrent post either shows up here or sees the sleeper
+    Job* job = FetchOneJob(worker);
+    if (job == nullptr) {
+        group->sleepCondition.wait(lock, [&]() { return group->pendingWakes > 0 || IsQuiting(); });
+        if (group->pendingWakes > 0) {
+            group->pendingWakes--;
+        }
+    }
+
+    group->sleepingCount--;
+    return job;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobSystem::RunJob(Job* job)
+{
+    if (!IsJobProfilingEnabled()) {
+        job->Execute();
+        ReleaseSuccessors(job);
+        ReturnCompleteJob(job);
+        return;
+    }
+
+    //read before completing, pooled and external jobs are gone right after
+    JobTraceRecord record;
+    record.jobID = job->GetJobID();
+    record.jobFlags = job->GetJobFlags();
+    record.workerID = tCurrentWorker != nullptr ? tCurrentWorker->GetThreadID() : -1;
+    record.postTime = job->m_enqueueTime;
+    record.startTime = GetCurrentTimeSeconds();
+    job->Execute();
+    record.endTime = GetCurrentTimeSeconds();
+    RecordJobTrace(record);
+
+    ReleaseSuccessors(job);
+    ReturnCompleteJob(job);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobSystem::ReturnCompleteJob(Job* job)
+{
+    //take the waiter before completing, job may be deleted right after
+    JobSignal* waiter = job->m_completeSignal.exchange(&sJobCompletingSignal);
+    if (job->m_storage == JOB_STORAGE_HEAP) {
+        std::scoped_lock lock(m_jobsCompleteMutex);
+        m_jobsCompleted.push_back(job);
+        job->ProgressStatus(); //running -> complete
+    }
+    else if (job->m_storage == JOB_STORAGE_POOL) {
+        job->ProgressStatus(); //running -> complete
+        m_jobPool.Release((InlineJob*)job);
+        NotifyPoolWaiters();
+    }
+    else {
+        job->ProgressStatus(); //running -> complete, owner may reuse it right after
+    }
+    if (waiter != nullptr) {
+        waiter->Set();
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobSystem::FinishJob(int jobID)
+{
+    Job* thisJob = nullptr;
+    thisJob = GetJob(jobID);
+    if (thisJob == nullptr) {
+        g_theConsole->PrintString(Rgba8::MAGENTA,Stringf("job of id %i doesn't exist in job system", jobID));
+        return;
+    }
+
+    if (thisJob->GetJobStatus() == JOB_STAT_QUEUING && thisJob->GetPriority()>=0) {
+        MakeJobUrgent(thisJob);
+    }
+
+    WaitForJobComplete(thisJob);
+    if (ClaimJobCallback(thisJob)) {
+        DoJobCallback(thisJob);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobSystem::FinishJob(JobHandle handle)
+{
+    if (!m_jobPool.IsHandleLive(handle)) {
+        return;
+    }
+
+    unsigned int jobFlags = m_jobPool.GetJobFlags(handle);
+    while (m_jobPool.IsHandleLive(handle)) {
+        if (HelpWithOneJob(jobFlags)) {
+            continue;
+        }
+
+        //pooled jobs have no per job signal, wait for any pooled job to finish
+        std::unique_lock lock(m_poolWaitMutex);
+        m_poolWaiterCount++;
+        m_poolWaitCondition.wait(lock, [&]() { return !m_jobPool.IsHandleLive(handle) || m_isQuiting; });
+        m_poolWaiterCount--;
+        if (m_isQuiting) {
+            return;
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobSystem::FinishAnyJobOfType(unsigned int jobFlags)
+{
+    Job* aJob = nullptr;
+    aJob = GetJobOfType(jobFlags);
+    if (aJob == nullptr) {
+        g_theConsole->PrintString(Rgba8::MAGENTA,Stringf("job of flags %u no exist in job system",jobFlags));
+        return;
+    }
+
+    if (aJob->GetJobStatus() == JOB_STAT_QUEUING && aJob->GetPriority()>=0) {
+        MakeJobUrgent(aJob);
+    }
+
+    WaitForJobComplete(aJob);
+    if (ClaimJobCallback(aJob)) {
+        DoJobCallback(aJob);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobSystem::FinishAllJobsOfType(unsigned int jobFlags)
+{
+    std::vector<Job*> allJobs;
+    GetAllJobsOfType(allJobs, jobFlags);
+
+    //make queuing jobs urgent
+    for (Job* job : allJobs) {
+        if (job->GetJobStatus() == JOB_STAT_QUEUING && job->GetPriority()>=0) {
+            MakeJobUrgent(job);
+        }
+    }
+
+    //wait for jobs to complete
+    for (Job* job : allJobs) {
+        WaitForJobComplete(job);
+        if (ClaimJobCallback(job)) {
+            DoJobCallback(job);
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+Job* JobSystem::GetJob(int jobID) const
+{
+    std::scoped_lock lock(m_jobsInFlightMutex);
+    Job* job = m_jobsInFlight.Find(jobID);
+    if (job == nullptr || job->GetJobStatus() > JOB_STAT_COMPLETE) {
+        return nullptr;
+    }
+    return job;
+}
+
+//////////////////////////////////////////////////////////////////////////
+Job* JobSystem::GetJobOfType(unsigned int jobFlags) const
+{
+    std::scoped_lock lock(m_jobsInFlightMutex);
+    for (int i = 0; i < m_jobsInFlight.GetCount(); i++) {
+        Job* job = m_jobsInFlight.GetJobAt(i);
+        if ((job->GetJobFlags() & jobFlags) && job->GetJobStatus() <= JOB_STAT_COMPLETE) {
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobSystem::GetAllJobsOfType(std::vector<Job*>& allJobs, unsigned int jobFlags) const
+{
+    std::scoped_lock lock(m_jobsInFlightMutex);
+    for (int i = 0; i < m_jobsInFlight.GetCount(); i++) {
+        Job* job = m_jobsInFlight.GetJobAt(i);
+        if ((job->GetJobFlags() & jobFlags) && job->GetJobStatus() <= JOB_STAT_COMPLETE) {
+            allJobs.push_back(job);
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+int JobSystem::GetJobTableCapacity() const
+{
+    std::scoped_lock lock(m_jobsInFlightMutex);
+    return m_jobsInFlight.GetCapacity();
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool JobSystem::IsJobComplete(int jobID) const
+{
+    Job* job = GetJob(jobID);
+    return job != nullptr && job->GetJobStatus() == JOB_STAT_COMPLETE;
+}
+
+//////////////////////////////////////////////////////////////////////////
+JobWorkerGroup* JobSystem::FindGroupForJob(unsigned int jobFlags) const
+{
+    //most shared flag bits wins, tie goes to the more dedicated group
+    JobWorkerGroup* best = nullptr;
+    int bestShared = 0;
+    int bestWidth = 0;
+    int groupCount = m_groupCount;
+    for (int i = 0; i < groupCount; i++) {
+        JobWorkerGroup* group = m_groups[i];
+        int shared = 0;
+        int width = 0;
+        for (unsigned int bits = group->jobFlags & jobFlags; bits != 0; bits &= bits - 1) {
+            shared++;
+        }
+        for (unsigned int bits = group->jobFlags; bits != 0; bits &= bits - 1) {
+            width++;
+        }
+        if (shared > bestShared || (shared == bestShared && shared > 0 && width < bestWidth)) {
+            best = group;
+            bestShared = shared;
+            bestWidth = width;
+        }
+    }
+    return best;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobSystem::ScheduleJob(Job* job)
+{
+    JobWorkerGroup* group = FindGroupForJob(job->GetJobFlags());
+    if (group == nullptr) {
+        std::scoped_lock lock(m_jobsInFlightMutex);
+        m_jobsWithoutWorker.push_back(job);
+        return;
+    }
+
+    EnqueueJob(group, job);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobSystem::ReleaseSuccessors(Job* job)
+{
+    std::vector<Job*> successors;
+    job->LockSuccessors();
+    job->m_isSuccessorsReleased = true;
+    successors.swap(job->m_successors);
+    job->UnlockSuccessors();
+
+    //runs on the worker that executed the job, successors land in its own queue
+    for (Job* successor : successors) {
+        if (successor->m_pendingPredecessors.fetch_sub(1) == 1) {
+            ScheduleJob(successor);
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobSystem::EnqueueJob(JobWorkerGroup* group, Job* job)
+{
+    if (IsJobProfilingEnabled()) {
+        job->m_enqueueTime = GetCurrentTimeSeconds();
+    }
+
+    //jobs spawned by a worker stay with it for locality, everything else is ordered by priority
+    JobSystemWorkerThread* worker = tCurrentWorker;
+    bool isLocal = worker != nullptr && worker->GetOwner() == this && worker->GetGroup() == group;
+    if (!isLocal || !worker->m_localJobs.Push(job)) {
+        group->postedJobs.Push(job, m_frame);
+    }
+    WakeWorkers(group, 1);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+Job* JobSystem::StealJob(JobWorkerGroup* group, int thiefIndex)
+{
+    int workerCount = group->workerCount;
+    int startIndex = thiefIndex + 1;
+    Job* result = nullptr;
+    for (int i = 0; i < workerCount; i++) {
+        JobSystemWorkerThread* victim = group->workers[(startIndex + i) % workerCount];
+        if (victim->GetIndexInGroup() == thiefIndex) {
+            continue;
+        }
+        if (victim->m_localJobs.Steal(result)) {
+            return result;
+        }
+    }
+    return nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobSystem::WakeWorkers(JobWorkerGroup* group, int count)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);    //job push before sleeper check
+    if (group->sleepingCount <= 0) {
+        return;
+    }
+
+    {
+        std::scoped_lock lock(group->sleepMutex);
+        group->pendingWakes = std::min(group->pendingWakes + count, (int)group->sleepingCount);
+    }
+    if (count == 1) {
+        group->sleepCondition.notify_one();
+    }
+    else {
+        group->sleepCondition.notify_all();
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobSystem::NotifyPoolWaiters()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);    //slot release before waiter check
+    if (m_poolWaiterCount <= 0) {
+        return;
+    }
+
+    std::scoped_lock lock(m_poolWaitMutex);
+    m_poolWaitCondition.notify_all();
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool JobSystem::HelpWithOneJob(unsigned int jobFlags)
+{
+    //run other work of the same lane instead of only spinning, the waited job is
+    //either running or still queued somewhere this thread can steal it from
+    JobWorkerGroup* group = FindGroupForJob(jobFlags);
+    JobSystemWorkerThread* worker = tCurrentWorker;
+    Job* job = nullptr;
+    if (worker != nullptr && worker->GetOwner() == this && worker->GetGroup() == group) {
+        job = FetchOneJob(worker);  //waiting inside a job, own queue first
+    }
+    else if (group != nullptr) {
+        job = FetchJobToHelp(group);
+    }
+    if (job == nullptr) {
+        return false;
+    }
+
+    RunJob(job);
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobSystem::WaitForJobComplete(Job* job)
+{
+    while (job->GetJobStatus() < JOB_STAT_COMPLETE) {
+        if (HelpWithOneJob(job->GetJobFlags())) {
+            continue;
+        }
+
+        //nothing left to help with, block until the job's worker signals
+        JobSignal signal;
+        JobSignal* expected = nullptr;
+        if (!job->m_completeSignal.compare_exchange_strong(expected, &signal)) {
+            std::this_thread::yield();  //completing right now, or another thread waits on it
+            continue;
+        }
+
+        expected = &signal;
+        if (job->GetJobStatus() < JOB_STAT_COMPLETE
+            || !job->m_completeSignal.compare_exchange_strong(expected, nullptr)) {
+            signal.Wait();  //worker took the signal, it will set it
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool JobSystem::ClaimJobCallback(Job* job)
+{
+    int expected = JOB_STAT_COMPLETE;
+    return job->m_jobStatus.compare_exchange_strong(expected, JOB_STAT_CALLBACK);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void JobSystem::DoJobCallback(Job* job)
+{
+    //the job stays in the completed list, ClaimAndDeleteAllCompletedJobs deletes it once finished
+    job->OnCompleteCallback();
+    {
+        std::scoped_lock lock(m_jobsInFlightMutex);
+        m_jobsInFlight.Remove(job);
     }
+    job->ProgressStatus();  //callback -> finish
 }
@@ -1,8 +1,17 @@
 #pragma once
 
 #include <atomic>
+#include <vector>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 class Job;
+class InlineJob;
+class JobSignal;
+class JobPriorityInbox;
+
+constexpr int JOB_INLINE_CAPTURE_BYTES = 64;
 
 enum eJobFlag : unsigned int
 {
@@ -29,9 +38,28 @@ enum eJobPriority : int
     JOB_PRIO_MAYBE  = 5000
 };
 
+enum eJobStorage : int
+{
+    JOB_STORAGE_HEAP = 0,   //deleted by the system after its callback
+    JOB_STORAGE_EXTERNAL,   //never claimed or deleted, owner waits on status
+    JOB_STORAGE_POOL        //InlineJob slot, recycled right after execute
+};
+
+//////////////////////////////////////////////////////////////////////////
+// generation tagged reference to a pooled job, stale once the job executed
+struct JobHandle
+{
+    unsigned int slotIndex = 0;
+    unsigned int generation = 0;   //0 is never a live job
+
+    bool IsValid() const { return generation != 0; }
+};
+
 void InitJobSystem(); 
 void JobSystemBeginFrame();
 void CloseJobSystem();
+bool IsJobSystemRunning();
+bool CanRunJobsOfType(unsigned int jobFlags);  //a worker group takes jobs of these flags, else they wait forever
 
 void CreateWorkerThreads(unsigned int number, unsigned int jobFlags = eJobFlag::JOB_GENERAL);
 void PostJob(Job& job);
@@ -40,8 +68,31 @@ void WaitForJob(int jobID);
 void WaitForNextJobOfType(unsigned int jobFlags);
 void WaitForAllJobsOfType(unsigned int jobFlags);
 
+//pooled jobs, no heap allocation per job
+//helps run jobs while the pool is full. nullptr without a job system, or when the pool
+//stays full of work this thread can't help with, the caller then runs the work in place
+InlineJob* AllocateInlineJob(unsigned int jobFlags, int priority);
+JobHandle PostInlineJob(InlineJob& job);
+template<typename FUNC_TYPE>
+JobHandle PostLambdaJob(FUNC_TYPE&& function, unsigned int jobFlags = eJobFlag::JOB_GENERAL, int priority = JOB_PRIO_MEDIUM);
+void WaitForJob(JobHandle handle);
+bool IsJobComplete(JobHandle handle);
+
 unsigned int GetHardwareConcurrency();
 
+//////////////////////////////////////////////////////////////////////////
+// data parallel loops over [begin, end) on JOB_GENERAL workers, never on a
+// JOB_DISK only group. Calling thread takes part and returns once every index
+// is done, alone if no such group exists. Chunks shrink as work runs out
+constexpr int MAX_PARALLEL_PARTICIPANTS = 32;
+typedef void (*ParallelRangeFunction)(void* context, int participantIndex, int rangeBegin, int rangeEnd);
+
+void ParallelForRanges(int begin, int end, int grainSize, ParallelRangeFunction function, void* context);
+template<typename FUNC_TYPE>
+void ParallelFor(int begin, int end, int grainSize, FUNC_TYPE const& function);  //function(int index)
+template<typename VALUE_TYPE, typename MAP_TYPE, typename REDUCE_TYPE>
+VALUE_TYPE ParallelReduce(int begin, int end, int grainSize, VALUE_TYPE const& identity, MAP_TYPE const& map, REDUCE_TYPE const& reduce); //reduce must be associative and commutative
+
 //////////////////////////////////////////////////////////////////////////
 class Job
 {
@@ -53,8 +104,8 @@ public:
     virtual void OnCompleteCallback() {} //Not every job needs a callback
 
     void MakeUrgent();
-    void UpdatePriority();
     void ProgressStatus();
+    void AddPredecessor(Job& predecessor);  //before posting, held in queue until predecessor executed
 
     unsigned int GetJobFlags() const {return m_jobFlags;}
     int GetPriority() const {return m_priority;}
@@ -62,8 +113,164 @@ public:
     eJobStatus GetJobStatus() const;
 
 private:
+    friend class JobSystem;
+    friend class JobPriorityInbox;
+
     std::atomic<int> m_jobStatus = 0;
     std::atomic<int> m_jobID = 0;
     const unsigned int m_jobFlags = 0;
-    std::atomic<int> m_priority = 1;
-};
\ No newline at end of file
+    std::atomic<int> m_priority = 1;    //as posted, the queue ages it by one per frame
+    std::atomic<JobSignal*> m_completeSignal = nullptr; //thread blocked on this job
+
+    eJobStorage m_storage = JOB_STORAGE_HEAP;
+
+    std::atomic<int> m_pendingPredecessors = 1;    //one extra released by posting
+    std::atomic<bool> m_successorsLock = false;
+    bool m_isSuccessorsReleased = false;
+    std::vector<Job*> m_successors;
+
+    std::atomic<JobPriorityInbox*> m_inbox = nullptr;  //set while waiting in a group inbox
+    Job* m_nextQueued = nullptr;
+    std::atomic<int> m_queueKey = 0;    //priority + frame posted, smaller runs first
+    double m_enqueueTime = 0.0;     //only stamped while profiling
+
+    void LockSuccessors();
+    void UnlockSuccessors();
+};
+
+//////////////////////////////////////////////////////////////////////////
+// pooled job running a callable stored inside the job itself
+class InlineJob : public Job
+{
+public:
+    InlineJob(unsigned int jobFlags, int priority, unsigned int poolSlot);
+    virtual ~InlineJob();
+
+    virtual void Execute() override;
+
+    template<typename FUNC_TYPE>
+    void SetFunction(FUNC_TYPE&& function);
+    unsigned int GetPoolSlot() const { return m_poolSlot; }
+
+private:
+    alignas(16) unsigned char m_capture[JOB_INLINE_CAPTURE_BYTES];
+    void (*m_invoke)(void* capture) = nullptr;
+    void (*m_destroy)(void* capture) = nullptr;
+    unsigned int m_poolSlot = 0;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// jobs with dependencies submitted as a whole, each one becomes runnable
+// on a worker once all its predecessors executed, no main thread wait
+class JobGraph
+{
+public:
+    ~JobGraph();
+
+    void AddJob(Job* job);
+    void AddDependency(Job* before, Job* after);    //adds both jobs if needed
+    void Submit();  //posts every job, graph is empty after
+
+    int GetJobCount() const { return (int)m_jobs.size(); }
+
+private:
+    std::vector<Job*> m_jobs;
+};
+
+
+//////////////////////////////////////////////////////////////////////////
+// Definitions
+//////////////////////////////////////////////////////////////////////////
+template<typename FUNC_TYPE>
+JobHandle PostLambdaJob(FUNC_TYPE&& function, unsigned int jobFlags, int priority)
+{
+    InlineJob* job = AllocateInlineJob(jobFlags, priority);
+    if (job == nullptr) {   //no job system or no free slot, run in place
+        function();
+        return JobHandle();
+    }
+
+    job->SetFunction(std::forward<FUNC_TYPE>(function));
+    return PostInlineJob(*job);
+}
+
+//////////////////////////////////////////////////////////////////////////
+template<typename FUNC_TYPE>
+void InlineJob::SetFunction(FUNC_TYPE&& function)
+{
+    typedef typename std::decay<FUNC_TYPE>::type StoredType;
+    static_assert(sizeof(StoredType) <= JOB_INLINE_CAPTURE_BYTES, "job captures too big for inline storage");
+    static_assert(alignof(StoredType) <= 16, "job capture alignment too big for inline storage");
+
+    if (m_destroy != nullptr) {
+        m_destroy(m_capture);
+    }
+    new(m_capture) StoredType(std::forward<FUNC_TYPE>(function));
+    m_invoke = [](void* capture) { (*(StoredType*)capture)(); };
+    m_destroy = [](void* capture) { ((StoredType*)capture)->~StoredType(); };
+}
+
+//////////////////////////////////////////////////////////////////////////
+template<typename FUNC_TYPE>
+void ParallelFor(int begin, int end, int grainSize, FUNC_TYPE const& function)
+{
+    ParallelForRanges(begin, end, grainSize, [](void* context, int participantIndex, int rangeBegin, int rangeEnd) {
+        (void)participantIndex;
+        FUNC_TYPE const& func = *(FUNC_TYPE const*)context;
+        for (int i = rangeBegin; i < rangeEnd; i++) {
+            func(i);
+        }
+    }, (void*)&function);
+}
+
+//////////////////////////////////////////////////////////////////////////
+template<typename VALUE_TYPE, typename MAP_TYPE, typename REDUCE_TYPE>
+VALUE_TYPE ParallelReduce(int begin, int end, int grainSize, VALUE_TYPE const& identity, MAP_TYPE const& map, REDUCE_TYPE const& reduce)
+{
+    //one partial per participant on its own cache line, built the first
+    //time that participant runs a range so idle ones cost nothing
+    struct alignas(alignof(VALUE_TYPE) > 64 ? alignof(VALUE_TYPE) : 64) PartialSlot
+    {
+        alignas(VALUE_TYPE) unsigned char storage[sizeof(VALUE_TYPE)];
+        bool hasRun;
+    };
+    struct ReduceContext
+    {
+        MAP_TYPE const* map;
+        REDUCE_TYPE const* reduce;
+        VALUE_TYPE const* identity;
+        PartialSlot* partials;
+    };
+
+    PartialSlot partials[MAX_PARALLEL_PARTICIPANTS];
+    for (PartialSlot& slot : partials) {
+        slot.hasRun = false;
+    }
+    ReduceContext reduceContext = { &map, &reduce, &identity, partials };
+    ParallelForRanges(begin, end, grainSize, [](void* context, int participantIndex, int rangeBegin, int rangeEnd) {
+        ReduceContext& ctx = *(ReduceContext*)context;
+        PartialSlot& slot = ctx.partials[participantIndex];
+        VALUE_TYPE* slotValue = (VALUE_TYPE*)slot.storage;
+        VALUE_TYPE partial = slot.hasRun ? *slotValue : *ctx.identity;
+        for (int i = rangeBegin; i < rangeEnd; i++) {
+            partial = (*ctx.reduce)(partial, (*ctx.map)(i));
+        }
+        if (slot.hasRun) {
+            *slotValue = partial;
+        }
+        else {
+            new(slot.storage) VALUE_TYPE(partial);
+            slot.hasRun = true;
+        }
+    }, &reduceContext);
+
+    VALUE_TYPE result = identity;
+    for (PartialSlot& slot : partials) {
+        if (slot.hasRun) {
+            VALUE_TYPE* slotValue = (VALUE_TYPE*)slot.storage;
+            result = reduce(result, *slotValue);
+            slotValue->~VALUE_TYPE();
+        }
+    }
+    return result;
+}
@@ -0,0 +1,539 @@
+#include "Engine/Core/Job.hpp"
+#include "Engine/Core/JobSystemInternal.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/NamedProperties.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/AllocationCounter.hpp"
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <vector>
+#include <algorithm>
+
+//////////////////////////////////////////////////////////////////////////
+// scheduler benchmarks and checks, each on its own JobSystem so the
+// engine's workers are left alone
+//////////////////////////////////////////////////////////////////////////
+static unsigned int RunBenchmarkWork(unsigned int seed)
+{
+    unsigned int x = seed + 1;
+    for (int i = 0; i < 64; i++) {  //small but not empty job
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    }
+    return x;
+}
+
+//////////////////////////////////////////////////////////////////////////
+class BenchmarkJob : public Job
+{
+public:
+    BenchmarkJob(std::atomic<int>* doneCounter)
+        : Job(eJobFlag::JOB_GENERAL, JOB_PRIO_MEDIUM)
+        , m_doneCounter(doneCounter) {}
+
+    virtual void Execute() override
+    {
+        m_result = RunBenchmarkWork((unsigned int)GetJobID());
+        m_doneCounter->fetch_add(1);
+    }
+
+public:
+    unsigned int m_result = 0;
+    std::atomic<int>* m_doneCounter = nullptr;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// same queue discipline as the mutex + deque scheduler this file replaced
+static double RunLegacySchedulerBenchmark(unsigned int workerCount, int jobCount)
+{
+    std::deque<Job*> queued, running, completed;
+    std::mutex queuedMutex, runningMutex, completeMutex;
+    std::atomic<bool> isQuiting = false;
+    std::atomic<int> doneCount = 0;
+
+    std::vector<Job*> jobs;
+    for (int i = 0; i < jobCount; i++) {
+        jobs.push_back(new BenchmarkJob(&doneCount));
+    }
+
+    auto workerMain = [&]() {
+        while (!isQuiting) {
+            Job* job = nullptr;
+            {
+                std::scoped_lock lock(queuedMutex, runningMutex);
+                if (!queued.empty()) {
+                    job = queued.front();
+                    queued.pop_front();
+                    running.push_back(job);
+                }
+            }
+            if (job == nullptr) {
+                std::this_thread::sleep_for(std::chrono::microseconds(10));
+                continue;
+            }
+            job->Execute();
+            std::scoped_lock lock(runningMutex, completeMutex);
+            completed.push_back(job);
+            for (std::deque<Job*>::iterator it = running.begin(); it != running.end(); ++it) {
+                if (*it == job) {
+                    running.erase(it);
+                    break;
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < workerCount; i++) {
+        threads.emplace_back(workerMain);
+    }
+
+    double startTime = GetCurrentTimeSeconds();
+    for (Job* job : jobs) {
+        std::scoped_lock lock(queuedMutex);
+        std::deque<Job*>::iterator it = queued.begin();
+        while (it != queued.end() && job->GetPriority() >= (*it)->GetPriority()) {
+            ++it;
+        }
+        queued.insert(it, job);
+    }
+    while (doneCount < jobCount) {
+        std::this_thread::yield();
+    }
+    double elapsed = GetCurrentTimeSeconds() - startTime;
+
+    isQuiting = true;
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (Job* job : jobs) {
+        delete job;
+    }
+    return (double)jobCount / elapsed;
+}
+
+//////////////////////////////////////////////////////////////////////////
+static double RunWorkStealingBenchmark(unsigned int workerCount, int jobCount)
+{
+    std::atomic<int> doneCount = 0;
+    JobSystem* benchSystem = new JobSystem();
+    for (unsigned int i = 0; i < workerCount; i++) {
+        benchSystem->CreateWorkerThread(eJobFlag::JOB_GENERAL);
+    }
+
+    std::vector<Job*> jobs;
+    for (int i = 0; i < jobCount; i++) {
+        jobs.push_back(new BenchmarkJob(&doneCount));
+    }
+
+    double startTime = GetCurrentTimeSeconds();
+    for (Job* job : jobs) {
+        benchSystem->PostJob(job);
+    }
+    while (doneCount < jobCount) {
+        std::this_thread::yield();
+    }
+    double elapsed = GetCurrentTimeSeconds() - startTime;
+
+    delete benchSystem; //claims and deletes the jobs
+    return (double)jobCount / elapsed;
+}
+
+//////////////////////////////////////////////////////////////////////////
+COMMAND(job_benchmark, "compare jobs/sec of legacy and work stealing scheduler, jobs=20000", eEventFlag::EVENT_CONSOLE)
+{
+    int jobCount = args.GetValue("jobs", 20000);
+    jobCount = args.GetValue("0", jobCount);
+    if (jobCount <= 0) {
+        g_theConsole->PrintError(Stringf("job count %i invalid", jobCount));
+        return false;
+    }
+
+    unsigned int workerCounts[] = { 1, 2, 4, 8, 16 };
+    g_theConsole->PrintString(Rgba8(255, 255, 0), Stringf("%-8s %16s %16s %8s", "workers", "legacy jobs/s", "stealing jobs/s", "ratio"));
+    for (unsigned int workerCount : workerCounts) {
+        double legacy = RunLegacySchedulerBenchmark(workerCount, jobCount);
+        double stealing = RunWorkStealingBenchmark(workerCount, jobCount);
+        g_theConsole->PrintString(Rgba8::WHITE, Stringf("%-8u %16.0f %16.0f %7.2fx", workerCount, legacy, stealing, stealing / legacy));
+    }
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+class LatencyProbeJob : public Job
+{
+public:
+    LatencyProbeJob(double* outLatency)
+        : Job(eJobFlag::JOB_GENERAL, JOB_PRIO_MEDIUM)
+        , m_outLatency(outLatency) {}
+
+    virtual void Execute() override { *m_outLatency = GetCurrentTimeSeconds() - m_postTime; }
+
+public:
+    double m_postTime = 0.0;
+    double* m_outLatency = nullptr;
+};
+
+//////////////////////////////////////////////////////////////////////////
+COMMAND(job_latency_benchmark, "measure idle worker cpu and post-to-start latency, workers=4, jobs=2000", eEventFlag::EVENT_CONSOLE)
+{
+    int workerCount = args.GetValue("workers", 4);
+    int jobCount = args.GetValue("jobs", 2000);
+    if (workerCount <= 0 || jobCount <= 0) {
+        g_theConsole->PrintError(Stringf("workers %i or jobs %i invalid", workerCount, jobCount));
+        return false;
+    }
+
+    JobSystem* benchSystem = new JobSystem();
+    for (int i = 0; i < workerCount; i++) {
+        benchSystem->CreateWorkerThread(eJobFlag::JOB_GENERAL);
+    }
+
+    //idle cost: workers have nothing to do for half a second
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    double cpuStart = GetProcessCPUTimeSeconds();
+    double wallStart = GetCurrentTimeSeconds();
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    double idleCores = (GetProcessCPUTimeSeconds() - cpuStart) / (GetCurrentTimeSeconds() - wallStart);
+
+    //trickle of single jobs, each post finds the workers spinning or parked
+    std::vector<double> latencies((size_t)jobCount, 0.0);
+    for (int i = 0; i < jobCount; i++) {
+        LatencyProbeJob* job = new LatencyProbeJob(&latencies[i]);
+        job->m_postTime = GetCurrentTimeSeconds();
+        benchSystem->PostJob(job);
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    benchSystem->FinishAllJobsOfType(eJobFlag::JOB_GENERAL);
+    delete benchSystem;
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) { return 1000000.0 * latencies[(size_t)(p * (double)(jobCount - 1))]; };
+    g_theConsole->PrintString(Rgba8(255, 255, 0), Stringf("%i idle workers use %.1f%% of a core", workerCount, idleCores * 100.0));
+    g_theConsole->PrintString(Rgba8::WHITE, Stringf("post-to-start us: p50 %.1f  p90 %.1f  p99 %.1f  max %.1f",
+        percentile(.5), percentile(.9), percentile(.99), percentile(1.0)));
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+COMMAND(job_alloc_benchmark, "heap allocations and time per job, heap jobs vs pooled inline jobs, jobs=100000", eEventFlag::EVENT_CONSOLE)
+{
+    int jobCount = args.GetValue("jobs", 100000);
+    jobCount = args.GetValue("0", jobCount);
+    constexpr int batchSize = 1000;
+    if (jobCount < batchSize) {
+        g_theConsole->PrintError(Stringf("job count %i invalid, at least %i", jobCount, batchSize));
+        return false;
+    }
+    if (!IsAllocationCountingEnabled()) {
+        g_theConsole->PrintString(Rgba8::MAGENTA, "define ENGINE_COUNT_ALLOCATIONS in EngineBuildPreferences.hpp to count allocations");
+    }
+
+    int batchCount = jobCount / batchSize;
+    jobCount = batchCount * batchSize;
+    std::atomic<int> doneCount = 0;
+    std::atomic<unsigned int> checksum = 0;
+    std::vector<JobHandle> handles((size_t)batchSize);
+    JobSystem* benchSystem = new JobSystem();
+    for (int i = 0; i < 4; i++) {
+        benchSystem->CreateWorkerThread(eJobFlag::JOB_GENERAL);
+    }
+
+    //heap jobs, claimed once per batch like a frame would
+    size_t allocStart = GetAllocationCount();
+    double startTime = GetCurrentTimeSeconds();
+    for (int batch = 0; batch < batchCount; batch++) {
+        for (int i = 0; i < batchSize; i++) {
+            benchSystem->PostJob(new BenchmarkJob(&doneCount));
+        }
+        while (doneCount < (batch + 1) * batchSize) {
+            std::this_thread::yield();
+        }
+        benchSystem->ClaimAndDeleteAllCompletedJobs();
+    }
+    double heapSeconds = GetCurrentTimeSeconds() - startTime;
+    double heapAllocs = (double)(GetAllocationCount() - allocStart) / (double)jobCount;
+
+    //pooled jobs, captures live in the job slot
+    startTime = GetCurrentTimeSeconds();
+    allocStart = GetAllocationCount();
+    for (int batch = 0; batch < batchCount; batch++) {
+        for (int i = 0; i < batchSize; i++) {
+            InlineJob* job = benchSystem->AllocateInlineJob(eJobFlag::JOB_GENERAL, JOB_PRIO_MEDIUM);
+            if (job == nullptr) {
+                checksum.fetch_add(RunBenchmarkWork((unsigned int)i), std::memory_order_relaxed);
+                handles[i] = JobHandle();
+                continue;
+            }
+            job->SetFunction([&checksum, i]() { checksum.fetch_add(RunBenchmarkWork((unsigned int)i), std::memory_order_relaxed); });
+            handles[i] = benchSystem->PostInlineJob(job);
+        }
+        for (JobHandle handle : handles) {
+            benchSystem->FinishJob(handle);
+        }
+    }
+    double pooledSeconds = GetCurrentTimeSeconds() - startTime;
+    double pooledAllocs = (double)(GetAllocationCount() - allocStart) / (double)jobCount;
+    delete benchSystem;
+
+    g_theConsole->PrintString(Rgba8(255, 255, 0), Stringf("%-8s %14s %14s", "jobs", "allocs/job", "ns/job"));
+    g_theConsole->PrintString(Rgba8::WHITE, Stringf("%-8s %14.3f %14.1f", "heap", heapAllocs, heapSeconds * 1e9 / (double)jobCount));
+    g_theConsole->PrintString(Rgba8::WHITE, Stringf("%-8s %14.3f %14.1f", "pooled", pooledAllocs, pooledSeconds * 1e9 / (double)jobCount));
+    return true;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+COMMAND(job_lookup_benchmark, "job status lookup and finish-all cost with many outstanding jobs, jobs=100000", eEventFlag::EVENT_CONSOLE)
+{
+    int jobCount = args.GetValue("jobs", 100000);
+    jobCount = args.GetValue("0", jobCount);
+    if (jobCount <= 0) {
+        g_theConsole->PrintError(Stringf("job count %i invalid", jobCount));
+        return false;
+    }
+
+    //no worker yet, every job stays outstanding
+    std::atomic<int> doneCount = 0;
+    JobSystem* benchSystem = new JobSystem();
+    std::vector<int> jobIDs;
+    std::deque<Job*> legacyList;
+    for (int i = 0; i < jobCount; i++) {
+        Job* job = new BenchmarkJob(&doneCount);
+        jobIDs.push_back(job->GetJobID());
+        legacyList.push_back(job);
+        benchSystem->PostJob(job);
+    }
+    for (int i = jobCount - 1; i > 0; i--) {    //lookups out of posting order
+        std::swap(jobIDs[i], jobIDs[(i * 7919) % (i + 1)]);
+    }
+
+    int foundCount = 0;
+    double startTime = GetCurrentTimeSeconds();
+    for (int jobID : jobIDs) {
+        foundCount += benchSystem->GetJob(jobID) != nullptr ? 1 : 0;
+    }
+    double tableSeconds = (GetCurrentTimeSeconds() - startTime) / (double)jobCount;
+
+    //the list walk GetJob used to do, sampled since a full run is quadratic
+    int legacyLookups = std::min(jobCount, 1000);
+    int legacyFoundCount = 0;
+    startTime = GetCurrentTimeSeconds();
+    for (int i = 0; i < legacyLookups; i++) {
+        for (Job* job : legacyList) {
+            if (job->GetJobID() == jobIDs[i]) {
+                legacyFoundCount++;
+                break;
+            }
+        }
+    }
+    double legacySeconds = (GetCurrentTimeSeconds() - startTime) / (double)legacyLookups;
+
+    for (int i = 0; i < 4; i++) {
+        benchSystem->CreateWorkerThread(eJobFlag::JOB_GENERAL);
+    }
+    startTime = GetCurrentTimeSeconds();
+    benchSystem->FinishAllJobsOfType(eJobFlag::JOB_GENERAL);
+    double finishAllSeconds = GetCurrentTimeSeconds() - startTime;
+    delete benchSystem;
+
+    g_theConsole->PrintString(Rgba8(255, 255, 0), Stringf("%i outstanding jobs, found %i of %i by table, %i of %i by list walk", jobCount, foundCount, jobCount, legacyFoundCount, legacyLookups));
+    g_theConsole->PrintString(Rgba8::WHITE, Stringf("lookup ns: table %.1f  list walk %.1f", tableSeconds * 1e9, legacySeconds * 1e9));
+    g_theConsole->PrintString(Rgba8::WHITE, Stringf("finish all of type: %.2f ms", finishAllSeconds * 1000.0));
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+COMMAND(job_table_growth_check, "one job held in flight while many others post and finish, the job table must stay small, jobs=200000", eEventFlag::EVENT_CONSOLE)
+{
+    int jobCount = args.GetValue("jobs", 200000);
+    jobCount = args.GetValue("0", jobCount);
+    if (jobCount <= 0) {
+        g_theConsole->PrintError(Stringf("job count %i invalid", jobCount));
+        return false;
+    }
+
+    //the held job waits on a predecessor that is only posted at the end
+    std::atomic<int> doneCount = 0;
+    JobSystem* benchSystem = new JobSystem();
+    benchSystem->CreateWorkerThread(eJobFlag::JOB_GENERAL);
+    Job* releaseJob = new BenchmarkJob(&doneCount);
+    Job* heldJob = new BenchmarkJob(&doneCount);
+    heldJob->AddPredecessor(*releaseJob);
+    benchSystem->PostJob(heldJob);
+
+    //heap and pooled jobs both take IDs, the ID span ends up far beyond the table
+    constexpr int batchSize = 1000;
+    int maxCapacity = benchSystem->GetJobTableCapacity();
+    std::vector<int> jobIDs;
+    std::vector<JobHandle> handles;
+    for (int posted = 0; posted < jobCount; posted += batchSize) {
+        jobIDs.clear();
+        handles.clear();
+        for (int i = 0; i < batchSize; i++) {
+            Job* job = new BenchmarkJob(&doneCount);
+            jobIDs.push_back(job->GetJobID());
+            benchSystem->PostJob(job);
+            InlineJob* inlineJob = benchSystem->AllocateInlineJob(eJobFlag::JOB_GENERAL, JOB_PRIO_MEDIUM);
+            if (inlineJob != nullptr) {
+                inlineJob->SetFunction([&doneCount]() { doneCount++; });
+                handles.push_back(benchSystem->PostInlineJob(inlineJob));
+            }
+        }
+        maxCapacity = std::max(maxCapacity, benchSystem->GetJobTableCapacity());
+        for (int jobID : jobIDs) {
+            benchSystem->FinishJob(jobID);
+        }
+        for (JobHandle handle : handles) {
+            benchSystem->FinishJob(handle);
+        }
+        benchSystem->ClaimAndDeleteAllCompletedJobs();
+    }
+    int endCapacity = benchSystem->GetJobTableCapacity();
+    bool isHeldJobFound = benchSystem->GetJob(heldJob->GetJobID()) == heldJob;
+
+    int heldJobID = heldJob->GetJobID();
+    benchSystem->PostJob(releaseJob);
+    benchSystem->FinishJob(heldJobID);
+    delete benchSystem;
+
+    //no more than a doubling past the most jobs ever in flight at once
+    int capacityBound = std::max(JOB_TABLE_INITIAL_CAPACITY, 4 * (batchSize + 1));
+    g_theConsole->PrintString(Rgba8(255, 255, 0), Stringf("%i jobs past one held job", jobCount));
+    g_theConsole->PrintString(Rgba8::WHITE, Stringf("table capacity: max %i  end %i  bound %i", maxCapacity, endCapacity, capacityBound));
+    if (!isHeldJobFound || maxCapacity > capacityBound || endCapacity > JOB_TABLE_INITIAL_CAPACITY) {
+        g_theConsole->PrintError("job table lost the held job or grew with the ID span");
+        return false;
+    }
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+class PriorityProbeJob : public Job
+{
+public:
+    PriorityProbeJob(int priority, int key, std::vector<int>* runKeys, std::atomic<int>* runCount)
+        : Job(eJobFlag::JOB_GENERAL, priority)
+        , m_key(key)
+        , m_runKeys(runKeys)
+        , m_runCount(runCount) {}
+
+    virtual void Execute() override
+    {
+        int runIndex = m_runCount->fetch_add(1);
+        (*m_runKeys)[runIndex] = m_key;
+        if (m_runIndex != nullptr) {
+            *m_runIndex = runIndex;
+        }
+    }
+
+public:
+    int m_key = 0;
+    int* m_runIndex = nullptr;
+    std::vector<int>* m_runKeys = nullptr;
+    std::atomic<int>* m_runCount = nullptr;
+};
+
+//////////////////////////////////////////////////////////////////////////
+class GateJob : public Job
+{
+public:
+    GateJob(std::atomic<int>* gate)
+        : Job(eJobFlag::JOB_GENERAL, JOB_PRIO_FATAL)
+        , m_gate(gate) {}
+
+    virtual void Execute() override
+    {
+        *m_gate = 1;
+        while (*m_gate != 2) {
+            std::this_thread::yield();
+        }
+    }
+
+public:
+    std::atomic<int>* m_gate = nullptr;
+};
+
+//////////////////////////////////////////////////////////////////////////
+COMMAND(job_priority_benchmark, "aging cost per frame, dispatch order and starvation bound of a backlog, backlog=50000", eEventFlag::EVENT_CONSOLE)
+{
+    int backlog = args.GetValue("backlog", 50000);
+    backlog = args.GetValue("0", backlog);
+    constexpr int jobsPerFrame = 8;
+    constexpr int agingFrames = 100;
+    if (backlog < jobsPerFrame) {
+        g_theConsole->PrintError(Stringf("backlog %i invalid", backlog));
+        return false;
+    }
+
+    //one worker held by a gate job, so the whole backlog queues up first
+    std::atomic<int> gate = 0;
+    JobSystem* benchSystem = new JobSystem();
+    benchSystem->CreateWorkerThread(eJobFlag::JOB_GENERAL);
+    benchSystem->PostJob(new GateJob(&gate));
+    while (gate != 1) {
+        std::this_thread::yield();
+    }
+
+    int frameCount = backlog / jobsPerFrame;
+    int jobCount = frameCount * jobsPerFrame + 1;
+    std::vector<int> runKeys((size_t)jobCount, 0);
+    std::atomic<int> runCount = 0;
+    int starvedRunIndex = -1;
+    PriorityProbeJob* starvedJob = new PriorityProbeJob(JOB_PRIO_MAYBE, JOB_PRIO_MAYBE + benchSystem->GetFrame(), &runKeys, &runCount);
+    starvedJob->m_runIndex = &starvedRunIndex;
+    int starvedKey = starvedJob->m_key;
+    benchSystem->PostJob(starvedJob);
+
+    int priorities[] = { JOB_PRIO_HIGH, JOB_PRIO_MEDIUM, JOB_PRIO_MEDIUM, JOB_PRIO_LOW };
+    for (int frame = 0; frame < frameCount; frame++) {
+        benchSystem->BeginFrame();
+        for (int i = 0; i < jobsPerFrame; i++) {
+            int priority = priorities[(frame + i) % 4];
+            benchSystem->PostJob(new PriorityProbeJob(priority, priority + benchSystem->GetFrame(), &runKeys, &runCount));
+        }
+    }
+
+    //aging with the full backlog queued, against touching every queued job like before
+    double startTime = GetCurrentTimeSeconds();
+    for (int i = 0; i < agingFrames; i++) {
+        benchSystem->BeginFrame();
+    }
+    double clockSeconds = (GetCurrentTimeSeconds() - startTime) / (double)agingFrames;
+
+    std::mutex legacyMutex;
+    std::vector<std::atomic<int>> legacyPriorities((size_t)jobCount);
+    startTime = GetCurrentTimeSeconds();
+    for (int i = 0; i < agingFrames; i++) {
+        std::scoped_lock lock(legacyMutex);
+        for (std::atomic<int>& priority : legacyPriorities) {
+            priority--;
+        }
+    }
+    double legacySeconds = (GetCurrentTimeSeconds() - startTime) / (double)agingFrames;
+
+    gate = 2;
+    while (runCount < jobCount) {
+        std::this_thread::yield();
+    }
+    delete benchSystem;
+
+    int inversionCount = 0;
+    for (int i = 1; i < jobCount; i++) {
+        inversionCount += runKeys[i] < runKeys[i - 1] ? 1 : 0;
+    }
+    int overtakeCount = 0;  //ran before the starved job though posted too late to
+    for (int i = 0; i < starvedRunIndex; i++) {
+        overtakeCount += runKeys[i] > starvedKey ? 1 : 0;
+    }
+
+    g_theConsole->PrintString(Rgba8(255, 255, 0), Stringf("backlog of %i jobs over %i frames", jobCount, frameCount));
+    g_theConsole->PrintString(Rgba8::WHITE, Stringf("aging per frame: clock %.1f ns, touch every job %.1f us", clockSeconds * 1e9, legacySeconds * 1e6));
+    g_theConsole->PrintString(Rgba8::WHITE, Stringf("dispatch order inversions: %i", inversionCount));
+    g_theConsole->PrintString(Rgba8::WHITE, Stringf("JOB_PRIO_MAYBE job ran %i th, overtaken past its %i frame bound by %i jobs",
+        starvedRunIndex, JOB_PRIO_MAYBE - JOB_PRIO_FATAL, overtakeCount));
+    return true;
+}
@@ -0,0 +1,291 @@
+#include "Engine/Core/JobProfiler.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/NamedProperties.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+//////////////////////////////////////////////////////////////////////////
+// definitions
+//////////////////////////////////////////////////////////////////////////
+constexpr int JOB_TRACE_RECORD_WORDS = (int)(sizeof(JobTraceRecord) / sizeof(uint64_t));
+static_assert(sizeof(JobTraceRecord) % sizeof(uint64_t) == 0, "trace records are copied as whole words");
+
+//seqlock per record, sequence is 2n+1 while record n is written and 2n+2 once it is complete
+struct JobTraceSlot
+{
+    std::atomic<uint64_t> sequence = 0;
+    std::atomic<uint64_t> words[JOB_TRACE_RECORD_WORDS];
+};
+
+struct JobTraceBuffer
+{
+    std::string threadName;
+    int threadIndex = 0;
+    std::atomic<bool> isThreadAlive = true;
+    std::atomic<uint64_t> writeCount = 0;  //only the owning thread writes
+    JobTraceSlot* slots = nullptr;          //allocated on the first record
+};
+
+struct JobTraceStats
+{
+    double average = 0.0;
+    double p50 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+static std::atomic<bool> sIsProfilingEnabled = false;
+static std::atomic<double> sCaptureStartTime = 0.0;
+static std::mutex sTraceBuffersMutex;
+static std::vector<JobTraceBuffer*> sTraceBuffers;     //kept after their thread ends, for the dump
+static thread_local JobTraceBuffer* tTraceBuffer = nullptr;
+
+static JobTraceBuffer* CreateTraceBufferForThisThread(std::string const& name);
+static void CopyTraceRecords(JobTraceBuffer* buffer, std::vector<JobTraceRecord>& outRecords);
+static std::string EscapeJsonString(std::string const& text);
+static JobTraceStats ComputeStats(std::vector<double>& samples);
+
+//////////////////////////////////////////////////////////////////////////
+COMMAND(job_profile, "start or stop recording job timings, enable=true", eEventFlag::EVENT_CONSOLE)
+{
+    bool isEnabled = args.GetValue("enable", true);
+    isEnabled = args.GetValue("0", isEnabled);
+    EnableJobProfiling(isEnabled);
+    g_theConsole->PrintString(Rgba8::WHITE, isEnabled ? "job profiling started" : "job profiling stopped");
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+COMMAND(job_trace, "write recorded jobs as chrome trace json, path=JobTrace.json", eEventFlag::EVENT_CONSOLE)
+{
+    std::string path = args.GetValue("path", "JobTrace.json");
+    path = args.GetValue("0", path);
+    return DumpJobTrace(path);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// methods
+//////////////////////////////////////////////////////////////////////////
+void EnableJobProfiling(bool isEnabled)
+{
+    if (isEnabled && !sIsProfilingEnabled) {
+        sCaptureStartTime = GetCurrentTimeSeconds();
+    }
+    sIsProfilingEnabled = isEnabled;
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool IsJobProfilingEnabled()
+{
+    return sIsProfilingEnabled.load(std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void BeginJobTraceThread(std::string const& name)
+{
+    if (tTraceBuffer == nullptr) {
+        CreateTraceBufferForThisThread(name);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void EndJobTraceThread()
+{
+    if (tTraceBuffer != nullptr) {
+        tTraceBuffer->isThreadAlive = false;
+        tTraceBuffer = nullptr;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void RecordJobTrace(JobTraceRecord const& record)
+{
+    JobTraceBuffer* buffer = tTraceBuffer;
+    if (buffer == nullptr) {
+        buffer = CreateTraceBufferForThisThread("");
+    }
+    if (buffer->slots == nullptr) {
+        buffer->slots = new JobTraceSlot[JOB_TRACE_BUFFER_SIZE];
+    }
+
+    uint64_t count = buffer->writeCount.load(std::memory_order_relaxed);
+    JobTraceSlot& slot = buffer->slots[count & (JOB_TRACE_BUFFER_SIZE - 1)];
+    uint64_t words[JOB_TRACE_RECORD_WORDS];
+    memcpy(words, &record, sizeof(words));
+    slot.sequence.store(2 * count + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (int i = 0; i < JOB_TRACE_RECORD_WORDS; i++) {
+        slot.words[i].store(words[i], std::memory_order_relaxed);
+    }
+    slot.sequence.store(2 * count + 2, std::memory_order_release);
+    buffer->writeCount.store(count + 1, std::memory_order_release);
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool DumpJobTrace(std::string const& path)
+{
+    double captureStart = sCaptureStartTime;
+    double captureEnd = GetCurrentTimeSeconds();
+    std::vector<JobTraceBuffer*> buffers;
+    {
+        std::scoped_lock lock(sTraceBuffersMutex);
+        buffers = sTraceBuffers;
+    }
+
+    std::string json = "{\"traceEvents\":[\n";
+    std::vector<double> waitTimes;
+    std::vector<double> runTimes;
+    std::vector<std::string> idleLines;
+    bool isFirstEvent = true;
+    for (JobTraceBuffer* buffer : buffers) {
+        std::vector<JobTraceRecord> records;
+        CopyTraceRecords(buffer, records);
+        records.erase(std::remove_if(records.begin(), records.end(),
+            [&](JobTraceRecord const& record) { return record.startTime < captureStart; }), records.end());
+        if (records.empty() && !buffer->isThreadAlive) {
+            continue;
+        }
+
+        json += Stringf("%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%i,\"args\":{\"name\":\"%s\"}}",
+            isFirstEvent ? "" : ",\n", buffer->threadIndex, EscapeJsonString(buffer->threadName).c_str());
+        isFirstEvent = false;
+
+        //busy time is the union of run intervals, a waiting job runs others nested inside itself
+        std::sort(records.begin(), records.end(),
+            [](JobTraceRecord const& a, JobTraceRecord const& b) { return a.startTime < b.startTime; });
+        double busySeconds = 0.0;
+        double busyUntil = captureStart;
+        for (JobTraceRecord const& record : records) {
+            double waitSeconds = record.postTime >= captureStart ? std::max(record.startTime - record.postTime, 0.0) : 0.0;
+            waitTimes.push_back(waitSeconds);
+            runTimes.push_back(record.endTime - record.startTime);
+            busySeconds += std::max(record.endTime - std::max(record.startTime, busyUntil), 0.0);
+            busyUntil = std::max(busyUntil, record.endTime);
+
+            json += Stringf(",\n{\"name\":\"job %i\",\"cat\":\"job\",\"ph\":\"X\",\"pid\":1,\"tid\":%i,\"ts\":%.3f,\"dur\":%.3f,"
+                "\"args\":{\"id\":%i,\"flags\":\"0x%x\",\"worker\":%i,\"wait_us\":%.3f}}",
+                record.jobID, buffer->threadIndex, (record.startTime - captureStart) * 1e6, (record.endTime - record.startTime) * 1e6,
+                record.jobID, record.jobFlags, record.workerID, waitSeconds * 1e6);
+        }
+
+        double idlePercent = 100.0 * (1.0 - busySeconds / std::max(captureEnd - captureStart, 1e-9));
+        idleLines.push_back(Stringf("%-16s jobs %6i  idle %5.1f%%", buffer->threadName.c_str(), (int)records.size(), idlePercent));
+    }
+
+    JobTraceStats wait = ComputeStats(waitTimes);
+    JobTraceStats run = ComputeStats(runTimes);
+    json += Stringf("\n],\n\"displayTimeUnit\":\"ms\",\n\"otherData\":{\"jobs\":\"%i\",\"capture_ms\":\"%.3f\","
+        "\"wait_us\":\"avg %.1f p50 %.1f p99 %.1f max %.1f\",\"run_us\":\"avg %.1f p50 %.1f p99 %.1f max %.1f\"}}\n",
+        (int)runTimes.size(), (captureEnd - captureStart) * 1000.0,
+        wait.average * 1e6, wait.p50 * 1e6, wait.p99 * 1e6, wait.max * 1e6,
+        run.average * 1e6, run.p50 * 1e6, run.p99 * 1e6, run.max * 1e6);
+
+    if (!FileWriteToDisk(path, json.c_str(), json.size())) {
+        g_theConsole->PrintError(Stringf("Failed to write job trace %s", path.c_str()));
+        return false;
+    }
+
+    g_theConsole->PrintString(Rgba8(255, 255, 0), Stringf("%i jobs in %.1f ms written to %s",
+        (int)runTimes.size(), (captureEnd - captureStart) * 1000.0, path.c_str()));
+    g_theConsole->PrintString(Rgba8::WHITE, Stringf("queue wait us: avg %.1f  p50 %.1f  p99 %.1f  max %.1f",
+        wait.average * 1e6, wait.p50 * 1e6, wait.p99 * 1e6, wait.max * 1e6));
+    g_theConsole->PrintString(Rgba8::WHITE, Stringf("run time us:   avg %.1f  p50 %.1f  p99 %.1f  max %.1f",
+        run.average * 1e6, run.p50 * 1e6, run.p99 * 1e6, run.max * 1e6));
+    for (std::string const& line : idleLines) {
+        g_theConsole->PrintString(Rgba8::WHITE, line);
+    }
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+static JobTraceBuffer* CreateTraceBufferForThisThread(std::string const& name)
+{
+    JobTraceBuffer* buffer = new JobTraceBuffer();
+    std::scoped_lock lock(sTraceBuffersMutex);
+    buffer->threadIndex = (int)sTraceBuffers.size();
+    buffer->threadName = name.empty() ? Stringf("thread %i", buffer->threadIndex) : name;
+    sTraceBuffers.push_back(buffer);
+    tTraceBuffer = buffer;
+    return buffer;
+}
+
+//////////////////////////////////////////////////////////////////////////
+static void CopyTraceRecords(JobTraceBuffer* buffer, std::vector<JobTraceRecord>& outRecords)
+{
+    uint64_t endCount = buffer->writeCount.load(std::memory_order_acquire);
+    if (endCount == 0) {
+        return;
+    }
+
+    //the owner keeps recording while this copies, a record whose sequence moved was overwritten and is dropped
+    uint64_t beginCount = endCount > JOB_TRACE_BUFFER_SIZE ? endCount - JOB_TRACE_BUFFER_SIZE : 0;
+    for (uint64_t i = beginCount; i < endCount; i++) {
+        JobTraceSlot const& slot = buffer->slots[i & (JOB_TRACE_BUFFER_SIZE - 1)];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != 2 * i + 2) {
+            continue;
+        }
+
+        uint64_t words[JOB_TRACE_RECORD_WORDS];
+        for (int w = 0; w < JOB_TRACE_RECORD_WORDS; w++) {
+            words[w] = slot.words[w].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+            continue;
+        }
+
+        JobTraceRecord record;
+        memcpy(&record, words, sizeof(words));
+        outRecords.push_back(record);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+static std::string EscapeJsonString(std::string const& text)
+{
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        }
+        else if ((unsigned char)c < 0x20) {
+            escaped += Stringf("\\u%04x", (unsigned char)c);
+        }
+        else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+//////////////////////////////////////////////////////////////////////////
+static JobTraceStats ComputeStats(std::vector<double>& samples)
+{
+    JobTraceStats stats;
+    if (samples.empty()) {
+        return stats;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    double total = 0.0;
+    for (double sample : samples) {
+        total += sample;
+    }
+    stats.average = total / (double)samples.size();
+    stats.p50 = samples[(samples.size() - 1) / 2];
+    stats.p99 = samples[(size_t)((double)(samples.size() - 1) * .99)];
+    stats.max = samples.back();
+    return stats;
+}
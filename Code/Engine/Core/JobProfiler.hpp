@@ -0,0 +1,28 @@
+#pragma once
+#include <string>
+
+
+//////////////////////////////////////////////////////////////////////////
+// per thread ring buffers of job timings, recorded by the job system while
+// profiling is enabled and exported as a chrome://tracing capture
+//////////////////////////////////////////////////////////////////////////
+constexpr int JOB_TRACE_BUFFER_SIZE = 32768;    //records kept per thread, power of two
+
+struct JobTraceRecord
+{
+    int jobID = 0;
+    unsigned int jobFlags = 0;
+    int workerID = -1;          //-1 for threads helping while they wait
+    double postTime = 0.0;      //entered a queue
+    double startTime = 0.0;
+    double endTime = 0.0;
+};
+
+void EnableJobProfiling(bool isEnabled);   //enabling starts a new capture
+bool IsJobProfilingEnabled();
+
+void BeginJobTraceThread(std::string const& name);     //names the calling thread, listed even while idle
+void EndJobTraceThread();
+void RecordJobTrace(JobTraceRecord const& record);      //calling thread's ring, no lock
+
+bool DumpJobTrace(std::string const& path);     //trace_event json and summary in the console
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "Engine/Core/Job.hpp"
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+// scheduler internals, only Job.cpp and the job benchmarks include this.
+// engine code goes through Job.hpp
+//////////////////////////////////////////////////////////////////////////
+constexpr int MAX_JOB_WORKER_GROUPS = 8;
+constexpr int MAX_WORKERS_PER_GROUP = 32;
+constexpr int WORKER_LOCAL_QUEUE_SIZE = 4096;
+constexpr int JOB_PRIORITY_BANDS = 64;        //one bit each in a 64 bit mask
+constexpr int JOB_PRIORITY_BAND_SHIFT = 9;    //512 keys per band, the ring spans the priorities plus aging
+constexpr int JOB_PRIORITY_MIN = -64;
+constexpr int JOB_PRIORITY_MAX = 8192;
+constexpr int WORKER_SPINS_BEFORE_PARK = 64;
+constexpr int JOB_POOL_CAPACITY = 16384;
+constexpr int JOB_POOL_FULL_MAX_YIELDS = 4096;  //yields in a row with nothing to help before giving up on the pool
+constexpr int JOB_TABLE_INITIAL_CAPACITY = 1024;
+
+class JobSystemWorkerThread;
+struct JobWorkerGroup;
+struct ParallelForContext;
+
+//////////////////////////////////////////////////////////////////////////
+// fixed slots of InlineJob, lock free free list tagged against ABA
+class JobPool
+{
+public:
+    explicit JobPool(int capacity);
+    ~JobPool();
+
+    InlineJob* Allocate(unsigned int jobFlags, int priority);   //nullptr when full
+    void Release(InlineJob* job);
+
+    JobHandle GetHandle(InlineJob const* job) const;
+    bool IsHandleLive(JobHandle handle) const;
+    unsigned int GetJobFlags(JobHandle handle) const;
+
+private:
+    struct Slot
+    {
+        alignas(InlineJob) unsigned char storage[sizeof(InlineJob)];
+        std::atomic<unsigned int> generation = 1;
+        std::atomic<unsigned int> jobFlags = 0;
+        std::atomic<unsigned int> nextFree = 0;
+    };
+
+    static constexpr unsigned int NO_FREE_SLOT = 0xffffffff;
+
+    Slot* m_slots = nullptr;
+    unsigned int m_capacity = 0;
+    std::atomic<uint64_t> m_freeHead = 0;  //tag << 32 | slot index
+};
+
+//////////////////////////////////////////////////////////////////////////
+// posted heap jobs by job ID. Live jobs sit packed in a list, an open
+// addressing index over their IDs finds them. Sized by the live count
+// alone, a job that stays in flight while IDs race ahead costs one slot.
+// Not locked, the job system guards it.
+class JobTable
+{
+public:
+    explicit JobTable(int capacity);  //rounded up to power of two, never shrinks below
+
+    void Add(Job* job);
+    void Remove(Job* job);
+    Job* Find(int jobID) const;
+
+    int GetCount() const { return (int)m_jobs.size(); }
+    int GetCapacity() const { return (int)m_slots.size(); }
+    Job* GetJobAt(int jobIndex) const { return m_jobs[jobIndex]; }  //live jobs, index below GetCount
+
+private:
+    unsigned int GetHomeSlot(int jobID) const { return ((unsigned int)jobID * 2654435769u) >> m_shift; }
+    unsigned int FindSlot(int jobID) const;     //slot holding the ID, or an empty one
+    void Rehash(unsigned int capacity);
+
+private:
+    static constexpr int EMPTY_SLOT = -1;
+
+    std::vector<Job*> m_jobs;
+    std::vector<int> m_slots;   //index into m_jobs, linear probing
+    unsigned int m_mask = 0;
+    unsigned int m_shift = 0;
+    unsigned int m_minCapacity = 0;
+};
+
+//////////////////////////////////////////////////////////////////////////
+class JobSystem
+{
+public:
+    JobSystem();
+    ~JobSystem();
+
+    void BeginFrame();
+    int GetFrame() const { return m_frame; }
+
+    void CreateWorkerThread(unsigned int jobFlags);
+    void PostJob(Job* job);
+    void ClaimAndDeleteAllCompletedJobs();
+    InlineJob* AllocateInlineJob(unsigned int jobFlags, int priority);
+    JobHandle PostInlineJob(InlineJob* job);
+    void RunParallelFor(ParallelForContext& context);
+    void MakeJobUrgent(Job* job);
+
+    Job* FetchOneJob(JobSystemWorkerThread* worker);
+    Job* FetchJobToHelp(JobWorkerGroup* group);
+    Job* ParkWorker(JobSystemWorkerThread* worker);
+    void RunJob(Job* job);
+    void ReturnCompleteJob(Job* job);
+
+    void FinishJob(int jobID);
+    void FinishJob(JobHandle handle);
+    void FinishAnyJobOfType(unsigned int jobFlags);
+    void FinishAllJobsOfType(unsigned int jobFlags);
+
+    Job* GetJob(int jobID) const;
+    Job* GetJobOfType(unsigned int jobFlags) const;
+    void GetAllJobsOfType(std::vector<Job*>& allJobs, unsigned int jobFlags) const;
+    bool IsQuiting() const {return m_isQuiting;}
+    bool IsJobComplete(int jobID) const;
+    bool CanRunJobsOfType(unsigned int jobFlags) const { return FindGroupForJob(jobFlags) != nullptr; }    //groups publish with their first worker
+    bool IsJobComplete(JobHandle handle) const { return !m_jobPool.IsHandleLive(handle); }
+    int GetJobTableCapacity() const;
+
+private:
+    JobWorkerGroup* FindGroupForJob(unsigned int jobFlags) const;
+    void ScheduleJob(Job* job);
+    void ReleaseSuccessors(Job* job);
+    void EnqueueJob(JobWorkerGroup* group, Job* job);
+    bool TakePostedJobs(JobSystemWorkerThread* worker);    //first inbox band into the worker's deque
+    Job* StealJob(JobWorkerGroup* group, int thiefIndex);
+    void WakeWorkers(JobWorkerGroup* group, int count);
+    void NotifyPoolWaiters();
+    bool HelpWithOneJob(unsigned int jobFlags);
+    void WaitForJobComplete(Job* job);
+    bool ClaimJobCallback(Job* job);    //false if callback already taken by another thread
+    void DoJobCallback(Job* job);   //assume job is complete
+
+private:
+    std::atomic<bool> m_isQuiting = false;
+    std::atomic<int> m_frame = 0;   //logical clock jobs age against
+
+    JobWorkerGroup* m_groups[MAX_JOB_WORKER_GROUPS] = {};
+    std::atomic<int> m_groupCount = 0;
+    std::deque<Job*> m_jobsWithoutWorker;   //posted before any matching worker exists
+
+    JobTable m_jobsInFlight;    //posted, callback not yet done
+    std::deque<Job*> m_jobsCompleted;   //not deleted yet, callback may already be done
+    mutable std::mutex m_jobsInFlightMutex;
+    mutable std::mutex m_jobsCompleteMutex;
+
+    std::vector<JobSystemWorkerThread*> m_workerThreads;
+
+    JobPool m_jobPool;
+    std::mutex m_poolWaitMutex;     //threads waiting on a job handle
+    std::condition_variable m_poolWaitCondition;
+    std::atomic<int> m_poolWaiterCount = 0;
+};
@@ -0,0 +1,124 @@
+#include "Engine/Core/JobTask.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/NamedProperties.hpp"
+#include "Engine/Core/Time.hpp"
+#include <cstdio>
+#include <thread>
+
+#if !defined(__cpp_impl_coroutine)
+#error "JobTask.cpp needs C++20 coroutines, build it with /std:c++latest"
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+// definitions
+//////////////////////////////////////////////////////////////////////////
+static Task<void> LoadOBJMeshTask(OBJMeshLoad& load);
+
+//////////////////////////////////////////////////////////////////////////
+COMMAND(job_task_obj, "load an obj grid blocking vs through coroutine tasks, files=16 size=32", eEventFlag::EVENT_CONSOLE)
+{
+    int fileCount = args.GetValue("files", 16);
+    int gridSize = args.GetValue("size", 32);
+    if (fileCount <= 0 || gridSize <= 0) {
+        g_theConsole->PrintError(Stringf("files %i or size %i invalid", fileCount, gridSize));
+        return false;
+    }
+
+    std::string content;
+    for (int y = 0; y <= gridSize; y++) {
+        for (int x = 0; x <= gridSize; x++) {
+            content += Stringf("v %i 0 %i\n", x, y);
+        }
+    }
+    content += "vn 0 1 0\n";
+    for (int y = 0; y <= gridSize; y++) {
+        for (int x = 0; x <= gridSize; x++) {
+            content += Stringf("vt %f %f\n", (float)x / (float)gridSize, (float)y / (float)gridSize);
+        }
+    }
+    for (int y = 0; y < gridSize; y++) {
+        for (int x = 0; x < gridSize; x++) {
+            int corner = y * (gridSize + 1) + x + 1;
+            content += Stringf("f %i/%i/1 %i/%i/1 %i/%i/1 %i/%i/1\n", corner, corner, corner + 1, corner + 1,
+                corner + gridSize + 2, corner + gridSize + 2, corner + gridSize + 1, corner + gridSize + 1);
+        }
+    }
+    std::vector<std::string> filePaths;
+    for (int i = 0; i < fileCount; i++) {
+        filePaths.push_back(Stringf("job_task_obj_%i.obj", i));
+        if (!FileWriteToDisk(filePaths.back(), content.c_str(), content.size())) {
+            g_theConsole->PrintError(Stringf("Failed to write %s", filePaths.back().c_str()));
+            return false;
+        }
+    }
+
+    obj_import_options options;
+    options.generateTangents = true;
+
+    //one after another on this thread
+    size_t blockingVerts = 0;
+    double startTime = GetCurrentTimeSeconds();
+    for (std::string const& filePath : filePaths) {
+        std::vector<Vertex_PCUTBN> verts;
+        std::vector<unsigned int> indices;
+        LoadOBJToIndexedVertexArray(verts, indices, filePath.c_str(), options);
+        blockingVerts += verts.size();
+    }
+    double blockingSeconds = GetCurrentTimeSeconds() - startTime;
+
+    //each task reads on the disk lane and parses on a worker, this thread only polls
+    std::vector<OBJMeshLoad> loads(filePaths.size());
+    startTime = GetCurrentTimeSeconds();
+    for (size_t fileIdx = 0; fileIdx < filePaths.size(); fileIdx++) {
+        loads[fileIdx].m_filePath = filePaths[fileIdx];
+        loads[fileIdx].m_options = options;
+        LoadOBJToIndexedVertexArrayAsync(loads[fileIdx]);
+    }
+    size_t taskVerts = 0;
+    int failedCount = 0;
+    for (OBJMeshLoad const& load : loads) {
+        while (!load.IsDone()) {
+            std::this_thread::yield();
+        }
+        taskVerts += load.m_verts.size();
+        failedCount += load.m_isLoaded ? 0 : 1;
+    }
+    double taskSeconds = GetCurrentTimeSeconds() - startTime;
+
+    for (std::string const& filePath : filePaths) {
+        remove(filePath.c_str());
+    }
+
+    g_theConsole->PrintString(Rgba8(255, 255, 0), Stringf("%i obj files of %i x %i quads", fileCount, gridSize, gridSize));
+    g_theConsole->PrintString(Rgba8::WHITE, Stringf("blocking: %.2f ms, %zu verts", blockingSeconds * 1000.0, blockingVerts));
+    g_theConsole->PrintString(Rgba8::WHITE, Stringf("tasks:    %.2f ms, %zu verts", taskSeconds * 1000.0, taskVerts));
+    if (failedCount > 0 || taskVerts != blockingVerts) {
+        g_theConsole->PrintError(Stringf("%i task loads failed, verts %zu vs %zu", failedCount, taskVerts, blockingVerts));
+        return false;
+    }
+    return true;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// methods
+//////////////////////////////////////////////////////////////////////////
+void LoadOBJToIndexedVertexArrayAsync(OBJMeshLoad& load)
+{
+    load.m_isDone = false;
+    LoadOBJMeshTask(load).StartDetached();
+}
+
+//////////////////////////////////////////////////////////////////////////
+static Task<void> LoadOBJMeshTask(OBJMeshLoad& load)
+{
+    FileReadData file = co_await ReadFileAsync(load.m_filePath);    //read on JOB_DISK, resumed on a CPU worker
+    if (file.m_data != nullptr) {
+        ParseOBJToIndexedVertexArray(load.m_verts, load.m_indices, file.m_data.get(), file.m_size, load.m_options);
+        load.m_isLoaded = true;
+    }
+    load.m_isDone.store(true, std::memory_order_release);
+}
@@ -0,0 +1,394 @@
+#pragma once
+#include "Engine/Core/Job.hpp"
+#include "Engine/Core/OBJUtils.hpp"
+#include <atomic>
+#include <string>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+// obj mesh loaded by a coroutine task (JobTask.cpp), the file is read on the
+// JOB_DISK lane and parsed on a CPU worker, no thread blocks in between.
+// Poll IsDone() each frame, keep the load alive until then
+//////////////////////////////////////////////////////////////////////////
+struct OBJMeshLoad
+{
+    std::string m_filePath;
+    obj_import_options m_options;
+
+    std::vector<Vertex_PCUTBN> m_verts;
+    std::vector<unsigned int> m_indices;
+    bool m_isLoaded = false;        //false when the read failed
+
+    bool IsDone() const { return m_isDone.load(std::memory_order_acquire); }
+
+    std::atomic<bool> m_isDone = false;
+};
+
+void LoadOBJToIndexedVertexArrayAsync(OBJMeshLoad& load);
+
+
+//////////////////////////////////////////////////////////////////////////
+// coroutine tasks on top of the job system. Needs C++20 coroutines, the
+// engine builds C++17 except JobTask.cpp, which the project compiles with
+// /std:c++latest. Other C++17 files can include this header for the loads
+// above, the task types compile to nothing there.
+//
+//  Task<void> LoadOBJMeshTask(OBJMeshLoad& load)
+//  {
+//      FileReadData file = co_await ReadFileAsync(load.m_filePath);  //read on JOB_DISK, resumed on a CPU worker
+//      ParseOBJToIndexedVertexArray(load.m_verts, load.m_indices, file.m_data.get(), file.m_size, load.m_options);
+//  }
+//
+//  LoadOBJMeshTask(load).StartDetached();
+//
+// a suspended task holds no worker, it is resumed by a pooled job once what
+// it awaits is done. Awaiting another Task runs it in place, no job hop.
+// Without a worker group for the flags everything runs in place instead.
+//////////////////////////////////////////////////////////////////////////
+#if defined(__cpp_impl_coroutine)
+
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include <coroutine>
+#include <memory>
+#include <optional>
+
+template<typename T = void>
+class Task;
+
+//////////////////////////////////////////////////////////////////////////
+struct TaskPromiseBase
+{
+    struct FinalAwaiter
+    {
+        bool await_ready() const noexcept { return false; }
+        template<typename PROMISE_TYPE>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<PROMISE_TYPE> handle) noexcept;
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() { ERROR_AND_DIE("unhandled exception in task coroutine"); }
+
+    std::coroutine_handle<> m_continuation;  //task awaiting this one, resumed in place when done
+    std::atomic<bool> m_isDone = false;
+    bool m_isDetached = false;               //frame frees itself when done
+};
+
+template<typename T>
+struct TaskPromise : public TaskPromiseBase
+{
+    Task<T> get_return_object();
+    template<typename VALUE_TYPE>
+    void return_value(VALUE_TYPE&& value) { m_value.emplace(std::forward<VALUE_TYPE>(value)); }
+
+    std::optional<T> m_value;
+};
+
+template<>
+struct TaskPromise<void> : public TaskPromiseBase
+{
+    Task<void> get_return_object();
+    void return_void() const {}
+};
+
+//////////////////////////////////////////////////////////////////////////
+// lazy coroutine, starts running when awaited or Start()ed. The owner keeps
+// it alive until IsDone(), destroying a running task is fatal.
+template<typename T>
+class Task
+{
+public:
+    using promise_type = TaskPromise<T>;
+
+    Task() = default;
+    explicit Task(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+    Task(Task const&) = delete;
+    Task(Task&& other) noexcept : m_handle(other.m_handle), m_isStarted(other.m_isStarted) { other.m_handle = nullptr; }
+    ~Task() { Destroy(); }
+
+    Task& operator=(Task const&) = delete;
+    Task& operator=(Task&& other) noexcept;
+
+    void Start(unsigned int jobFlags = eJobFlag::JOB_GENERAL, int priority = JOB_PRIO_MEDIUM); //first resume on a worker
+    void StartDetached(unsigned int jobFlags = eJobFlag::JOB_GENERAL, int priority = JOB_PRIO_MEDIUM);   //no longer owned, can't be polled
+    bool IsValid() const { return m_handle != nullptr; }
+    bool IsDone() const { return m_handle != nullptr && m_handle.promise().m_isDone.load(std::memory_order_acquire); }
+    decltype(auto) GetResult();     //only once IsDone()
+
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) noexcept;
+    decltype(auto) await_resume();
+
+private:
+    void Destroy();
+    static void Resume(std::coroutine_handle<promise_type> handle, unsigned int jobFlags, int priority);
+
+    std::coroutine_handle<promise_type> m_handle;
+    bool m_isStarted = false;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// co_await SwitchToJobSystem(): continue on a worker matching jobFlags
+class JobSwitchAwaiter
+{
+public:
+    JobSwitchAwaiter(unsigned int jobFlags, int priority) : m_jobFlags(jobFlags), m_priority(priority) {}
+
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> handle);
+    void await_resume() const noexcept {}
+
+private:
+    unsigned int m_jobFlags = eJobFlag::JOB_GENERAL;
+    int m_priority = JOB_PRIO_MEDIUM;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// co_await AwaitJob(job): continue on a worker once a posted job executed,
+// the job must not be deleted before that
+class JobAwaiter
+{
+public:
+    JobAwaiter(Job& job, unsigned int jobFlags, int priority) : m_job(job), m_jobFlags(jobFlags), m_priority(priority) {}
+
+    bool await_ready() const noexcept { return m_job.GetJobStatus() >= JOB_STAT_COMPLETE; }
+    bool await_suspend(std::coroutine_handle<> handle);
+    void await_resume() const noexcept {}
+
+private:
+    Job& m_job;
+    unsigned int m_jobFlags = eJobFlag::JOB_GENERAL;
+    int m_priority = JOB_PRIO_MEDIUM;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// co_await ReadFileAsync(path): read on the JOB_DISK lane, continue on a
+// worker matching jobFlags with the file contents
+struct FileReadData
+{
+    std::unique_ptr<char[]> m_data;  //nullptr when the read failed, null terminated otherwise
+    size_t m_size = 0;
+};
+
+class FileReadAwaiter
+{
+public:
+    FileReadAwaiter(std::string const& filePath, bool isBinary, unsigned int jobFlags, int priority)
+        : m_filePath(filePath), m_isBinary(isBinary), m_jobFlags(jobFlags), m_priority(priority) {}
+
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> handle);
+    FileReadData await_resume() { return std::move(m_result); }
+
+private:
+    void ReadFile();
+
+    std::string m_filePath;
+    bool m_isBinary = false;
+    unsigned int m_jobFlags = eJobFlag::JOB_GENERAL;
+    int m_priority = JOB_PRIO_MEDIUM;
+    FileReadData m_result;
+};
+
+inline JobSwitchAwaiter SwitchToJobSystem(unsigned int jobFlags = eJobFlag::JOB_GENERAL, int priority = JOB_PRIO_MEDIUM)
+{
+    return JobSwitchAwaiter(jobFlags, priority);
+}
+
+inline JobAwaiter AwaitJob(Job& job, unsigned int jobFlags = eJobFlag::JOB_GENERAL, int priority = JOB_PRIO_MEDIUM)
+{
+    return JobAwaiter(job, jobFlags, priority);
+}
+
+inline FileReadAwaiter ReadFileAsync(std::string const& filePath, bool isBinary = false,
+    unsigned int jobFlags = eJobFlag::JOB_GENERAL, int priority = JOB_PRIO_MEDIUM)
+{
+    return FileReadAwaiter(filePath, isBinary, jobFlags, priority);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// Definitions
+//////////////////////////////////////////////////////////////////////////
+template<typename PROMISE_TYPE>
+std::coroutine_handle<> TaskPromiseBase::FinalAwaiter::await_suspend(std::coroutine_handle<PROMISE_TYPE> handle) noexcept
+{
+    TaskPromiseBase& promise = handle.promise();
+    std::coroutine_handle<> continuation = promise.m_continuation;
+    if (promise.m_isDetached) {
+        handle.destroy();
+        return std::noop_coroutine();
+    }
+    promise.m_isDone.store(true, std::memory_order_release);    //owner may destroy the frame from here on
+    if (continuation) {
+        return continuation;
+    }
+    return std::noop_coroutine();
+}
+
+//////////////////////////////////////////////////////////////////////////
+template<typename T>
+Task<T> TaskPromise<T>::get_return_object()
+{
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object()
+{
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+//////////////////////////////////////////////////////////////////////////
+template<typename T>
+Task<T>& Task<T>::operator=(Task&& other) noexcept
+{
+    if (this != &other) {
+        Destroy();
+        m_handle = other.m_handle;
+        m_isStarted = other.m_isStarted;
+        other.m_handle = nullptr;
+    }
+    return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////
+template<typename T>
+void Task<T>::Start(unsigned int jobFlags, int priority)
+{
+    GUARANTEE_OR_DIE(m_handle != nullptr && !m_isStarted, "task started twice or empty");
+    m_isStarted = true;
+    Resume(m_handle, jobFlags, priority);
+}
+
+//////////////////////////////////////////////////////////////////////////
+template<typename T>
+void Task<T>::StartDetached(unsigned int jobFlags, int priority)
+{
+    GUARANTEE_OR_DIE(m_handle != nullptr && !m_isStarted, "task started twice or empty");
+    std::coroutine_handle<promise_type> handle = m_handle;
+    handle.promise().m_isDetached = true;
+    m_handle = nullptr;
+    Resume(handle, jobFlags, priority);
+}
+
+//////////////////////////////////////////////////////////////////////////
+template<typename T>
+void Task<T>::Resume(std::coroutine_handle<promise_type> handle, unsigned int jobFlags, int priority)
+{
+    if (!CanRunJobsOfType(jobFlags)) {  //posted it would never run
+        handle.resume();
+        return;
+    }
+    PostLambdaJob([handle]() { handle.resume(); }, jobFlags, priority);
+}
+
+//////////////////////////////////////////////////////////////////////////
+template<typename T>
+decltype(auto) Task<T>::GetResult()
+{
+    GUARANTEE_OR_DIE(IsDone(), "task result read before it finished");
+    if constexpr (!std::is_void<T>::value) {
+        return (*m_handle.promise().m_value);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+template<typename T>
+std::coroutine_handle<> Task<T>::await_suspend(std::coroutine_handle<> awaiter) noexcept
+{
+    m_isStarted = true;
+    m_handle.promise().m_continuation = awaiter;
+    return m_handle;    //run in place on this thread
+}
+
+//////////////////////////////////////////////////////////////////////////
+template<typename T>
+decltype(auto) Task<T>::await_resume()
+{
+    if constexpr (!std::is_void<T>::value) {
+        return std::move(*m_handle.promise().m_value);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+template<typename T>
+void Task<T>::Destroy()
+{
+    if (m_handle == nullptr) {
+        return;
+    }
+    GUARANTEE_OR_DIE(!m_isStarted || IsDone(), "task destroyed while still running");
+    m_handle.destroy();
+    m_handle = nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////
+inline bool JobSwitchAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    if (!CanRunJobsOfType(m_jobFlags)) {    //no worker would resume it, keep going on this thread
+        return false;
+    }
+    InlineJob* job = AllocateInlineJob(m_jobFlags, m_priority);
+    if (job == nullptr) {
+        return false;
+    }
+    job->SetFunction([handle]() { handle.resume(); });
+    PostInlineJob(*job);
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+inline bool JobAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    if (!CanRunJobsOfType(m_jobFlags)) {
+        WaitForJob(m_job.GetJobID());
+        return false;
+    }
+    InlineJob* job = AllocateInlineJob(m_jobFlags, m_priority);
+    if (job == nullptr) {
+        return false;
+    }
+    job->SetFunction([handle]() { handle.resume(); });
+    job->AddPredecessor(m_job);     //no dependency if it already executed
+    PostInlineJob(*job);
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+inline bool FileReadAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    if (!CanRunJobsOfType(eJobFlag::JOB_DISK) || !CanRunJobsOfType(m_jobFlags)) {
+        ReadFile();
+        return false;
+    }
+    InlineJob* readJob = AllocateInlineJob(eJobFlag::JOB_DISK, m_priority);
+    if (readJob == nullptr) {
+        ReadFile();
+        return false;
+    }
+    InlineJob* resumeJob = AllocateInlineJob(m_jobFlags, m_priority);
+    if (resumeJob == nullptr) { //pool full, continue on the disk worker after the read
+        readJob->SetFunction([this, handle]() { ReadFile(); handle.resume(); });
+        PostInlineJob(*readJob);
+        return true;
+    }
+    readJob->SetFunction([this]() { ReadFile(); });   //awaiter lives in the suspended frame
+    resumeJob->SetFunction([handle]() { handle.resume(); });
+    resumeJob->AddPredecessor(*readJob);
+    PostInlineJob(*resumeJob);  //held until the read executed
+    PostInlineJob(*readJob);
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+inline void FileReadAwaiter::ReadFile()
+{
+    size_t fileSize = 0;
+    char* fileData = (char*)FileReadToNewBuffer(m_filePath, &fileSize, m_isBinary);
+    m_result.m_data.reset(fileData);
+    m_result.m_size = fileData != nullptr ? fileSize : 0;
+}
+
+#endif
@@ -180,12 +180,9 @@ static void AppendToVertexArrayForOBJFaceReading(std::vector<Vertex_PCUTBN>& ver
 }
 
 //////////////////////////////////////////////////////////////////////////
-void LoadOBJToVertexArray(std::vector<Vertex_PCUTBN>& verts, char const* filename, obj_import_options const& options)
+static void ParseOBJLinesToVertexArray(std::vector<Vertex_PCUTBN>& verts, Strings const& lines, obj_import_options const& options)
 {
-    UNUSED(options);
-
     std::vector<Vertex_PCUTBN> rawVerts;
-    Strings lines = FileReadLines(filename);
     OBJReadStage readStage = OBJReadStage::READ_VERT;
     std::vector<Vec3> vertexes;
     std::vector<Vec3> normals;
@@ -259,6 +256,20 @@ void LoadOBJToVertexArray(std::vector<Vertex_PCUTBN>& verts, char const* filenam
     verts.insert(verts.end(),rawVerts.begin(),rawVerts.end());
 }
 
+//////////////////////////////////////////////////////////////////////////
+void LoadOBJToVertexArray(std::vector<Vertex_PCUTBN>& verts, char const* filename, obj_import_options const& options)
+{
+    Strings lines = FileReadLines(filename);
+    ParseOBJLinesToVertexArray(verts, lines, options);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void ParseOBJToVertexArray(std::vector<Vertex_PCUTBN>& verts, char const* fileData, size_t fileSize, obj_import_options const& options)
+{
+    Strings lines = SplitStringOnDelimiter(std::string(fileData, fileSize), '\n');
+    ParseOBJLinesToVertexArray(verts, lines, options);
+}
+
 //////////////////////////////////////////////////////////////////////////
 void MeshInvertV(std::vector<Vertex_PCUTBN>& verts)
 {
@@ -385,3 +396,14 @@ void LoadOBJToIndexedVertexArray(std::vector<Vertex_PCUTBN>& verts, std::vector<
     CleanVertexesForIndexedVertexArray(rawVerts, verts, indices);
     verts.insert(verts.end(), rawVerts.begin(), rawVerts.end());
 }
+
+//////////////////////////////////////////////////////////////////////////
+void ParseOBJToIndexedVertexArray(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indices,
+    char const* fileData, size_t fileSize, obj_import_options const& options)
+{
+    std::vector<Vertex_PCUTBN> rawVerts;
+    ParseOBJToVertexArray(rawVerts, fileData, fileSize, options);
+
+    CleanVertexesForIndexedVertexArray(rawVerts, verts, indices);
+    verts.insert(verts.end(), rawVerts.begin(), rawVerts.end());
+}
@@ -19,6 +19,11 @@ void LoadOBJToIndexedVertexArray(std::vector<Vertex_PCUTBN>& verts, std::vector<
     char const* filename, obj_import_options const& options);
 void LoadOBJToVertexArray(std::vector<Vertex_PCUTBN>& verts, char const* filename, obj_import_options const& options);
 
+//same as above from a file already in memory, e.g. read by a FileParseJob
+void ParseOBJToIndexedVertexArray(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indices,
+    char const* fileData, size_t fileSize, obj_import_options const& options);
+void ParseOBJToVertexArray(std::vector<Vertex_PCUTBN>& verts, char const* fileData, size_t fileSize, obj_import_options const& options);
+
 void MeshInvertV(std::vector<Vertex_PCUTBN>& verts);
 void MeshCalculateNormal(std::vector<Vertex_PCUTBN>& verts);
 void MeshSmoothNormal(std::vector<Vertex_PCUTBN>& verts);
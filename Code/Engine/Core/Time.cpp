@@ -32,6 +32,22 @@ double GetCurrentTimeSeconds()
 	return currentSeconds;
 }
 
+//////////////////////////////////////////////////////////////////////////
+double GetProcessCPUTimeSeconds()
+{
+	FILETIME creationTime, exitTime, kernelTime, userTime;
+	if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+		return 0.0;
+	}
+
+	ULARGE_INTEGER kernel, user;
+	kernel.LowPart = kernelTime.dwLowDateTime;
+	kernel.HighPart = kernelTime.dwHighDateTime;
+	user.LowPart = userTime.dwLowDateTime;
+	user.HighPart = userTime.dwHighDateTime;
+	return static_cast< double >( kernel.QuadPart + user.QuadPart ) * 1e-7;	//100ns units
+}
+
 //////////////////////////////////////////////////////////////////////////
 Time GetRealWorldTime()
 {
@@ -6,6 +6,7 @@
 
 //-----------------------------------------------------------------------------------------------
 double GetCurrentTimeSeconds();
+double GetProcessCPUTimeSeconds();    //user + kernel time of all threads
 
 struct Time
 {
@@ -6,6 +6,7 @@
 #include "Engine/Math/AABB2.hpp"
 #include "Engine/Math/Polygon2D.hpp"
 #include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/MatrixUtils.hpp"
 #include "Engine/Renderer/buffer_attribute_t.hpp"
 
 buffer_attribute_t const Vertex_PCU::LAYOUT[] =
@@ -79,11 +80,12 @@ void TransformVertexArray( int vertexesNumber, Vertex_PCU* vertexes, float unifo
 //////////////////////////////////////////////////////////////////////////
 void TransformVertexArray(int vertexesNumber, Vertex_PCU* vertexes, Mat44 const& transformMat)
 {
-	for (int i = 0; i < vertexesNumber; i++) {
-		Vertex_PCU& vert = vertexes[i];
-
-		vert.position = transformMat.TransformPosition3D(vert.position);
+	if (vertexesNumber <= 0) {
+		return;
 	}
+
+	Vec3* positions = &vertexes[0].position;
+	MatrixTransformPositions3D(transformMat, vertexesNumber, positions, (int)sizeof(Vertex_PCU), positions, (int)sizeof(Vertex_PCU));
 }
 
 //////////////////////////////////////////////////////////////////////////
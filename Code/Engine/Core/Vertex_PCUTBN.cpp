@@ -3,6 +3,8 @@
 #include "Engine/Math/Mat44.hpp"
 #include "Engine/Math/MatrixUtils.hpp"
 
+static constexpr int TRANSFORM_CHUNK_SIZE = 256;    //13KB of vertexes, well inside L1
+
 buffer_attribute_t const Vertex_PCUTBN::LAYOUT[] =
 {
     buffer_attribute_t("POSITION",  eBufferFormatType::BUFFER_FORMAT_VEC3,              offsetof(Vertex_PCUTBN, position)),
@@ -38,17 +40,22 @@ Vertex_PCUTBN GetMiddleVertex(Vertex_PCUTBN const& VPA, Vertex_PCUTBN const& VPB
 }
 
 //////////////////////////////////////////////////////////////////////////
+// positions, normals and tangents in batches, a chunk at a time so all
+// three passes over it hit the cache. Tangent w is left alone
 void TransformVertexArray(int vertexesNumber, Vertex_PCUTBN* vertexes, Mat44 const& transformMat)
 {
     Mat44 normalMat = transformMat;
     normalMat.SetTranslation3D(Vec3::ZERO);
     normalMat = MatrixTranspose(MatrixInverse(normalMat));
-    for (int i = 0; i < vertexesNumber; i++) {
-        Vertex_PCUTBN& vert = vertexes[i];
-        vert.position = transformMat.TransformPosition3D(vert.position);
-        vert.normal = normalMat.TransformVector3D(vert.normal).GetNormalized();
-        Vec3 tangentDir = normalMat.TransformVector3D(vert.tangent.GetXYZ()).GetNormalized();
-        vert.tangent = Vec4(tangentDir, vert.tangent.w);
+
+    int const stride = (int)sizeof(Vertex_PCUTBN);
+    for (int chunkStart = 0; chunkStart < vertexesNumber; chunkStart += TRANSFORM_CHUNK_SIZE) {
+        int chunkCount = vertexesNumber - chunkStart < TRANSFORM_CHUNK_SIZE ? vertexesNumber - chunkStart : TRANSFORM_CHUNK_SIZE;
+        Vertex_PCUTBN& first = vertexes[chunkStart];
+        Vec3* tangents = (Vec3*)&first.tangent.x;
+        MatrixTransformPositions3D(transformMat, chunkCount, &first.position, stride, &first.position, stride);
+        MatrixTransformVectors3D(normalMat, chunkCount, &first.normal, stride, &first.normal, stride, true);
+        MatrixTransformVectors3D(normalMat, chunkCount, tangents, stride, tangents, stride, true);
     }
 }
 
@@ -58,37 +65,14 @@ void TransformVertexArray(int vertexesNumber, Vertex_PCUTBN* vertexes, float uni
     Mat44 transformMat = Mat44::CreateZRotationDegrees(rotationAboutZDegrees);
     transformMat.ScaleUniform3D(uniformScale);
     transformMat.SetTranslation3D(translation);
-
-    Mat44 normalMat = transformMat;
-    normalMat.SetTranslation3D(Vec3::ZERO);
-    normalMat = MatrixTranspose(MatrixInverse(normalMat));
-
-    for (int i = 0; i < vertexesNumber; i++) {
-        Vertex_PCUTBN& vert = vertexes[i];
-        vert.position = transformMat.TransformPosition3D(vert.position);
-        vert.normal = normalMat.TransformVector3D(vert.normal).GetNormalized();
-        Vec3 tangentDir = normalMat.TransformVector3D(vert.tangent.GetXYZ()).GetNormalized();
-        vert.tangent = Vec4(tangentDir, vert.tangent.w);
-    }
+    TransformVertexArray(vertexesNumber, vertexes, transformMat);
 }
 
 //////////////////////////////////////////////////////////////////////////
 void TransformVertexArray(int vertexesNumber, Vertex_PCUTBN* vertexes, float uniformScale, float rotationAboutZDegrees, Vec3 const& translation, Rgba8 const& color)
 {
-    Mat44 transformMat = Mat44::CreateZRotationDegrees(rotationAboutZDegrees);
-    transformMat.ScaleUniform3D(uniformScale);
-    transformMat.SetTranslation3D(translation);
-
-    Mat44 normalMat = transformMat;
-    normalMat.SetTranslation3D(Vec3::ZERO);
-    normalMat = MatrixTranspose(MatrixInverse(normalMat));
-
+    TransformVertexArray(vertexesNumber, vertexes, uniformScale, rotationAboutZDegrees, translation);
     for (int i = 0; i < vertexesNumber; i++) {
-        Vertex_PCUTBN& vert = vertexes[i];
-        vert.position = transformMat.TransformPosition3D(vert.position);
-        vert.tint = color;
-        vert.normal = normalMat.TransformVector3D(vert.normal).GetNormalized();
-        Vec3 tangentDir = normalMat.TransformVector3D(vert.tangent.GetXYZ()).GetNormalized();
-        vert.tangent = Vec4(tangentDir, vert.tangent.w);
+        vertexes[i].tint = color;
     }
 }
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+//////////////////////////////////////////////////////////////////////////
+// Chase-Lev deque: owner thread pushes and pops at the bottom (LIFO),
+// any other thread may steal from the top (FIFO). Fixed capacity, T must
+// be trivially copyable (used for pointers).
+//////////////////////////////////////////////////////////////////////////
+template <typename T>
+class WorkStealingQueue
+{
+public:
+    explicit WorkStealingQueue(int capacity);  //rounded up to power of two
+    WorkStealingQueue(WorkStealingQueue const&) = delete;
+    WorkStealingQueue(WorkStealingQueue&&) = delete;
+    ~WorkStealingQueue();
+
+    WorkStealingQueue& operator=(WorkStealingQueue const&) = delete;
+    WorkStealingQueue& operator=(WorkStealingQueue&&) = delete;
+
+    bool Push(T const& value);  //owner only, false if full
+    bool Pop(T& outValue);      //owner only
+    bool Steal(T& outValue);    //any thread
+
+    bool IsEmpty() const;
+    int GetCount() const;       //exact for the owner up to concurrent steals
+    int GetCapacity() const { return (int)(m_mask + 1); }
+
+private:
+    alignas(64) std::atomic<int64_t> m_top = 0;
+    alignas(64) std::atomic<int64_t> m_bottom = 0;
+    alignas(64) std::atomic<T>* m_buffer = nullptr;
+    int64_t m_mask = 0;
+};
+
+
+//////////////////////////////////////////////////////////////////////////
+// functions definitions
+//////////////////////////////////////////////////////////////////////////
+template <typename T>
+WorkStealingQueue<T>::WorkStealingQueue(int capacity)
+{
+    int64_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    m_mask = size - 1;
+    m_buffer = new std::atomic<T>[(size_t)size];
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename T>
+WorkStealingQueue<T>::~WorkStealingQueue()
+{
+    delete[] m_buffer;
+    m_buffer = nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename T>
+bool WorkStealingQueue<T>::Push(T const& value)
+{
+    int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+    int64_t top = m_top.load(std::memory_order_acquire);
+    if (bottom - top > m_mask) {
+        return false;
+    }
+
+    m_buffer[bottom & m_mask].store(value, std::memory_order_relaxed);
+    m_bottom.store(bottom + 1, std::memory_order_release);
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename T>
+bool WorkStealingQueue<T>::Pop(T& outValue)
+{
+    int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+    m_bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = m_top.load(std::memory_order_relaxed);
+
+    if (top > bottom) { //empty
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    outValue = m_buffer[bottom & m_mask].load(std::memory_order_relaxed);
+    if (top == bottom) { //last one, race against thieves
+        bool won = m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return won;
+    }
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename T>
+bool WorkStealingQueue<T>::Steal(T& outValue)
+{
+    int64_t top = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t bottom = m_bottom.load(std::memory_order_acquire);
+    if (top >= bottom) {
+        return false;
+    }
+
+    T value = m_buffer[top & m_mask].load(std::memory_order_relaxed);
+    if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return false;   //lost to owner or another thief
+    }
+    outValue = value;
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename T>
+bool WorkStealingQueue<T>::IsEmpty() const
+{
+    int64_t top = m_top.load(std::memory_order_relaxed);
+    int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+    return top >= bottom;
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename T>
+int WorkStealingQueue<T>::GetCount() const
+{
+    int64_t top = m_top.load(std::memory_order_relaxed);
+    int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+    return top < bottom ? (int)(bottom - top) : 0;
+}
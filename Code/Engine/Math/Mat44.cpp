@@ -4,6 +4,7 @@
 #include "Engine/Math/Vec4.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/MatrixUtils.hpp"
+#include "Engine/Math/MathSimd.hpp"
 
 const Mat44 Mat44::IDENTITY;
 
@@ -112,7 +113,27 @@ const Vec2 Mat44::TransformPosition2D( const Vec2& position ) const
 }
 
 //////////////////////////////////////////////////////////////////////////
+// the vector paths below do the scalar multiplies and adds in the same
+// order, one column per register, and give bit identical results
 const Vec3 Mat44::TransformPosition3D( const Vec3& position ) const
+{
+#if defined(MATH_SIMD_SSE)
+	__m128 result = _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( &Ix ), _mm_set1_ps( position.x ) ), _mm_mul_ps( _mm_loadu_ps( &Jx ), _mm_set1_ps( position.y ) ) );
+	result = _mm_add_ps( _mm_add_ps( result, _mm_mul_ps( _mm_loadu_ps( &Kx ), _mm_set1_ps( position.z ) ) ), _mm_loadu_ps( &Tx ) );
+	float values[4];
+	_mm_storeu_ps( values, result );
+	return Vec3( values[0], values[1], values[2] );
+#elif defined(MATH_SIMD_NEON)
+	float32x4_t result = vaddq_f32( vmulq_n_f32( vld1q_f32( &Ix ), position.x ), vmulq_n_f32( vld1q_f32( &Jx ), position.y ) );
+	result = vaddq_f32( vaddq_f32( result, vmulq_n_f32( vld1q_f32( &Kx ), position.z ) ), vld1q_f32( &Tx ) );
+	return Vec3( vgetq_lane_f32( result, 0 ), vgetq_lane_f32( result, 1 ), vgetq_lane_f32( result, 2 ) );
+#else
+	return TransformPosition3DScalar( position );
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+const Vec3 Mat44::TransformPosition3DScalar( const Vec3& position ) const
 {
 	return Vec3( Ix * position.x + Jx * position.y + Kx * position.z + Tx,
 		         Iy * position.x + Jy * position.y + Ky * position.z + Ty,
@@ -121,6 +142,30 @@ const Vec3 Mat44::TransformPosition3D( const Vec3& position ) const
 
 //////////////////////////////////////////////////////////////////////////
 const Vec4 Mat44::TransformHomogeneousPoint3D( const Vec4& pointHomo ) const
+{
+#if defined(MATH_SIMD_SSE)
+	__m128 point = _mm_loadu_ps( &pointHomo.x );
+	__m128 result = _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( &Ix ), _mm_shuffle_ps( point, point, _MM_SHUFFLE( 0, 0, 0, 0 ) ) ),
+		_mm_mul_ps( _mm_loadu_ps( &Jx ), _mm_shuffle_ps( point, point, _MM_SHUFFLE( 1, 1, 1, 1 ) ) ) );
+	result = _mm_add_ps( result, _mm_mul_ps( _mm_loadu_ps( &Kx ), _mm_shuffle_ps( point, point, _MM_SHUFFLE( 2, 2, 2, 2 ) ) ) );
+	result = _mm_add_ps( result, _mm_mul_ps( _mm_loadu_ps( &Tx ), _mm_shuffle_ps( point, point, _MM_SHUFFLE( 3, 3, 3, 3 ) ) ) );
+	Vec4 transformed;
+	_mm_storeu_ps( &transformed.x, result );
+	return transformed;
+#elif defined(MATH_SIMD_NEON)
+	float32x4_t result = vaddq_f32( vmulq_n_f32( vld1q_f32( &Ix ), pointHomo.x ), vmulq_n_f32( vld1q_f32( &Jx ), pointHomo.y ) );
+	result = vaddq_f32( result, vmulq_n_f32( vld1q_f32( &Kx ), pointHomo.z ) );
+	result = vaddq_f32( result, vmulq_n_f32( vld1q_f32( &Tx ), pointHomo.w ) );
+	Vec4 transformed;
+	vst1q_f32( &transformed.x, result );
+	return transformed;
+#else
+	return TransformHomogeneousPoint3DScalar( pointHomo );
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+const Vec4 Mat44::TransformHomogeneousPoint3DScalar( const Vec4& pointHomo ) const
 {
 	return Vec4( Ix * pointHomo.x + Jx * pointHomo.y + Kx * pointHomo.z + Tx * pointHomo.w,
 		         Iy * pointHomo.x + Jy * pointHomo.y + Ky * pointHomo.z + Ty * pointHomo.w,
@@ -453,7 +498,67 @@ void Mat44::ScaleNonUniform3D( const Vec3& scaleFactorsXYZ )
 }
 
 //////////////////////////////////////////////////////////////////////////
+// each result column is this matrix times a column of the appended one.
+// Both are read into registers before anything is written, so appending a
+// matrix to itself works too
 void Mat44::MultiplyRight( const Mat44& newMatrixToAppend )
+{
+#if defined(MATH_SIMD_AVX)
+	//two result columns per register
+	__m128 oldI = _mm_loadu_ps( &Ix );
+	__m128 oldJ = _mm_loadu_ps( &Jx );
+	__m128 oldK = _mm_loadu_ps( &Kx );
+	__m128 oldT = _mm_loadu_ps( &Tx );
+	__m256 oldII = _mm256_insertf128_ps( _mm256_castps128_ps256( oldI ), oldI, 1 );
+	__m256 oldJJ = _mm256_insertf128_ps( _mm256_castps128_ps256( oldJ ), oldJ, 1 );
+	__m256 oldKK = _mm256_insertf128_ps( _mm256_castps128_ps256( oldK ), oldK, 1 );
+	__m256 oldTT = _mm256_insertf128_ps( _mm256_castps128_ps256( oldT ), oldT, 1 );
+	__m256 newIJ = _mm256_loadu_ps( &newMatrixToAppend.Ix );
+	__m256 newKT = _mm256_loadu_ps( &newMatrixToAppend.Kx );
+
+	__m256 columnsIJ = _mm256_add_ps( _mm256_mul_ps( oldII, _mm256_permute_ps( newIJ, 0x00 ) ), _mm256_mul_ps( oldJJ, _mm256_permute_ps( newIJ, 0x55 ) ) );
+	columnsIJ = _mm256_add_ps( columnsIJ, _mm256_mul_ps( oldKK, _mm256_permute_ps( newIJ, 0xaa ) ) );
+	columnsIJ = _mm256_add_ps( columnsIJ, _mm256_mul_ps( oldTT, _mm256_permute_ps( newIJ, 0xff ) ) );
+	__m256 columnsKT = _mm256_add_ps( _mm256_mul_ps( oldII, _mm256_permute_ps( newKT, 0x00 ) ), _mm256_mul_ps( oldJJ, _mm256_permute_ps( newKT, 0x55 ) ) );
+	columnsKT = _mm256_add_ps( columnsKT, _mm256_mul_ps( oldKK, _mm256_permute_ps( newKT, 0xaa ) ) );
+	columnsKT = _mm256_add_ps( columnsKT, _mm256_mul_ps( oldTT, _mm256_permute_ps( newKT, 0xff ) ) );
+	_mm256_storeu_ps( &Ix, columnsIJ );
+	_mm256_storeu_ps( &Kx, columnsKT );
+#elif defined(MATH_SIMD_SSE)
+	__m128 oldColumns[4] = { _mm_loadu_ps( &Ix ), _mm_loadu_ps( &Jx ), _mm_loadu_ps( &Kx ), _mm_loadu_ps( &Tx ) };
+	__m128 newColumns[4] = { _mm_loadu_ps( &newMatrixToAppend.Ix ), _mm_loadu_ps( &newMatrixToAppend.Jx ),
+		_mm_loadu_ps( &newMatrixToAppend.Kx ), _mm_loadu_ps( &newMatrixToAppend.Tx ) };
+	float* columnStart = &Ix;
+	for( int columnIdx = 0; columnIdx < 4; columnIdx++ )
+	{
+		__m128 newColumn = newColumns[columnIdx];
+		__m128 column = _mm_add_ps( _mm_mul_ps( oldColumns[0], _mm_shuffle_ps( newColumn, newColumn, _MM_SHUFFLE( 0, 0, 0, 0 ) ) ),
+			_mm_mul_ps( oldColumns[1], _mm_shuffle_ps( newColumn, newColumn, _MM_SHUFFLE( 1, 1, 1, 1 ) ) ) );
+		column = _mm_add_ps( column, _mm_mul_ps( oldColumns[2], _mm_shuffle_ps( newColumn, newColumn, _MM_SHUFFLE( 2, 2, 2, 2 ) ) ) );
+		column = _mm_add_ps( column, _mm_mul_ps( oldColumns[3], _mm_shuffle_ps( newColumn, newColumn, _MM_SHUFFLE( 3, 3, 3, 3 ) ) ) );
+		_mm_storeu_ps( columnStart + 4 * columnIdx, column );
+	}
+#elif defined(MATH_SIMD_NEON)
+	float32x4_t oldColumns[4] = { vld1q_f32( &Ix ), vld1q_f32( &Jx ), vld1q_f32( &Kx ), vld1q_f32( &Tx ) };
+	float32x4_t newColumns[4] = { vld1q_f32( &newMatrixToAppend.Ix ), vld1q_f32( &newMatrixToAppend.Jx ),
+		vld1q_f32( &newMatrixToAppend.Kx ), vld1q_f32( &newMatrixToAppend.Tx ) };
+	float* columnStart = &Ix;
+	for( int columnIdx = 0; columnIdx < 4; columnIdx++ )
+	{
+		//separate multiply and add, a fused vmla would round differently from the scalar path
+		float32x4_t newColumn = newColumns[columnIdx];
+		float32x4_t column = vaddq_f32( vmulq_n_f32( oldColumns[0], vgetq_lane_f32( newColumn, 0 ) ), vmulq_n_f32( oldColumns[1], vgetq_lane_f32( newColumn, 1 ) ) );
+		column = vaddq_f32( column, vmulq_n_f32( oldColumns[2], vgetq_lane_f32( newColumn, 2 ) ) );
+		column = vaddq_f32( column, vmulq_n_f32( oldColumns[3], vgetq_lane_f32( newColumn, 3 ) ) );
+		vst1q_f32( columnStart + 4 * columnIdx, column );
+	}
+#else
+	MultiplyRightScalar( newMatrixToAppend );
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Mat44::MultiplyRightScalar( const Mat44& newMatrixToAppend )
 {
 	Mat44 oldMatrix( &Ix );
 
@@ -45,6 +45,8 @@ public:
 	const Vec2 TransformPosition2D( const Vec2& position ) const; //z=0, w=1
 	const Vec3 TransformPosition3D( const Vec3& position ) const; //w=1
 	const Vec4 TransformHomogeneousPoint3D( const Vec4& pointHomo ) const;	
+	const Vec3 TransformPosition3DScalar( const Vec3& position ) const;	//reference for the vector paths
+	const Vec4 TransformHomogeneousPoint3DScalar( const Vec4& pointHomo ) const;
 
 	//basic accessors
 	const float* GetAsFloatArray() const { return &Ix; }
@@ -82,6 +84,7 @@ public:
 	void ScaleUniform3D( float uniformScaleXYZ );
 	void ScaleNonUniform3D( const Vec3& scaleFactorsXYZ );
 	void MultiplyRight( const Mat44& newMatrixToAppend );
+	void MultiplyRightScalar( const Mat44& newMatrixToAppend );	//reference for the vector paths
 
 	//static construction
 	static const Mat44 CreateXRotationDegrees( float degreesAroundX );
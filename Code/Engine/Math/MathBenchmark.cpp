@@ -0,0 +1,473 @@
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/MatrixUtils.hpp"
+#include "Engine/Math/MathSimd.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/NoiseGrid.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Math/SmoothNoise.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/Vec4.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/NamedProperties.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include <cmath>
+#include <vector>
+
+#if defined(MATH_SIMD_AVX)
+static char const* VECTOR_PATH_NAME = "avx";
+#elif defined(MATH_SIMD_SSE)
+static char const* VECTOR_PATH_NAME = "sse";
+#elif defined(MATH_SIMD_NEON)
+static char const* VECTOR_PATH_NAME = "neon";
+#else
+static char const* VECTOR_PATH_NAME = "scalar";
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+// largest difference relative to the size of the expected value
+static float GetRelativeError(float const* expected, float const* actual, int count)
+{
+    float maxError = 0.f;
+    for (int valueIdx = 0; valueIdx < count; valueIdx++) {
+        float error = fabsf(actual[valueIdx] - expected[valueIdx]) / MaxFloat(1.f, fabsf(expected[valueIdx]));
+        maxError = MaxFloat(maxError, error);
+    }
+    return maxError;
+}
+
+//////////////////////////////////////////////////////////////////////////
+COMMAND(math_mat44_benchmark, "Mat44 multiply, transforms and inverse, scalar against the vector path, count=100000 repeats=20", eEventFlag::EVENT_CONSOLE)
+{
+    int count = args.GetValue("count", 100000);
+    int repeatCount = args.GetValue("repeats", 20);
+    if (count <= 0 || repeatCount <= 0) {
+        g_theConsole->PrintError(Stringf("count %i or repeats %i invalid", count, repeatCount));
+        return false;
+    }
+
+    //scaled and rotated model matrices, never orthonormal so the inverse takes the general path
+    RandomNumberGenerator rng;
+    rng.Reset(8642);
+    std::vector<Mat44> matrices((size_t)count);
+    std::vector<Vec3> positions((size_t)count);
+    std::vector<Vec4> points((size_t)count);
+    for (int matIdx = 0; matIdx < count; matIdx++) {
+        Vec3 scale(rng.RollRandomFloatInRange(.5f, 2.f), rng.RollRandomFloatInRange(.5f, 2.f), rng.RollRandomFloatInRange(.5f, 2.f));
+        Vec3 rotation(rng.RollRandomFloatInRange(-180.f, 180.f), rng.RollRandomFloatInRange(-90.f, 90.f), rng.RollRandomFloatInRange(-180.f, 180.f));
+        Vec3 translation(rng.RollRandomFloatInRange(-100.f, 100.f), rng.RollRandomFloatInRange(-100.f, 100.f), rng.RollRandomFloatInRange(-100.f, 100.f));
+        matrices[matIdx] = Mat44::FromScaleRotationTranslation(scale, rotation, translation);
+        if (matIdx % 4 == 3) {  //some camera ones, projection times view
+            Mat44 projection = MakePerspectiveProjectionMatrix3D(rng.RollRandomFloatInRange(45.f, 90.f), 16.f / 9.f, .1f, 1000.f);
+            projection.MultiplyRightScalar(matrices[matIdx]);
+            matrices[matIdx] = projection;
+        }
+        positions[matIdx] = Vec3(rng.RollRandomFloatInRange(-50.f, 50.f), rng.RollRandomFloatInRange(-50.f, 50.f), rng.RollRandomFloatInRange(-50.f, 50.f));
+        points[matIdx] = Vec4(positions[matIdx], 1.f);
+    }
+
+    enum eKernel { KERNEL_MULTIPLY, KERNEL_POSITION, KERNEL_HOMOGENEOUS, KERNEL_INVERSE, NUM_KERNELS };
+    char const* kernelNames[NUM_KERNELS] = { "multiply", "position", "homogeneous", "inverse" };
+    std::vector<Mat44> matrixResults[2] = { std::vector<Mat44>((size_t)count), std::vector<Mat44>((size_t)count) };
+    std::vector<Vec3> positionResults[2] = { std::vector<Vec3>((size_t)count), std::vector<Vec3>((size_t)count) };
+    std::vector<Vec4> pointResults[2] = { std::vector<Vec4>((size_t)count), std::vector<Vec4>((size_t)count) };
+
+    g_theConsole->PrintString(Rgba8(255, 255, 0), Stringf("%-12s %12s %12s %10s %12s", "kernel", "scalar ns", Stringf("%s ns", VECTOR_PATH_NAME).c_str(), "speedup", "max error"));
+    bool isExact = true;
+    for (int kernelIdx = 0; kernelIdx < NUM_KERNELS; kernelIdx++) {
+        double nsPerOp[2] = {};
+        for (int pathIdx = 0; pathIdx < 2; pathIdx++) {
+            bool isScalar = pathIdx == 0;
+            double startTime = GetCurrentTimeSeconds();
+            for (int repeatIdx = 0; repeatIdx < repeatCount; repeatIdx++) {
+                for (int matIdx = 0; matIdx < count; matIdx++) {
+                    Mat44 const& mat = matrices[matIdx];
+                    switch (kernelIdx) {
+                    case KERNEL_MULTIPLY: {
+                        Mat44 product = mat;
+                        Mat44 const& appended = matrices[(matIdx + 1) % count];
+                        isScalar ? product.MultiplyRightScalar(appended) : product.MultiplyRight(appended);
+                        matrixResults[pathIdx][matIdx] = product;
+                        break;
+                    }
+                    case KERNEL_POSITION:
+                        positionResults[pathIdx][matIdx] = isScalar ? mat.TransformPosition3DScalar(positions[matIdx]) : mat.TransformPosition3D(positions[matIdx]);
+                        break;
+                    case KERNEL_HOMOGENEOUS:
+                        pointResults[pathIdx][matIdx] = isScalar ? mat.TransformHomogeneousPoint3DScalar(points[matIdx]) : mat.TransformHomogeneousPoint3D(points[matIdx]);
+                        break;
+                    case KERNEL_INVERSE:    //the scalar side as MatrixInverse was, orthonormal check included
+                        matrixResults[pathIdx][matIdx] = isScalar ? (MatrixIsOrthoNormal(mat) ? MatrixInverseOrthoNormal(mat) : MatrixInverseScalar(mat)) : MatrixInverse(mat);
+                        break;
+                    default:
+                        break;
+                    }
+                }
+            }
+            nsPerOp[pathIdx] = (GetCurrentTimeSeconds() - startTime) * 1.0e9 / ((double)count * (double)repeatCount);
+        }
+
+        float maxError = 0.f;
+        for (int matIdx = 0; matIdx < count; matIdx++) {
+            if (kernelIdx == KERNEL_POSITION) {
+                maxError = MaxFloat(maxError, GetRelativeError(&positionResults[0][matIdx].x, &positionResults[1][matIdx].x, 3));
+            }
+            else if (kernelIdx == KERNEL_HOMOGENEOUS) {
+                maxError = MaxFloat(maxError, GetRelativeError(&pointResults[0][matIdx].x, &pointResults[1][matIdx].x, 4));
+            }
+            else {
+                maxError = MaxFloat(maxError, GetRelativeError(matrixResults[0][matIdx].GetAsFloatArray(), matrixResults[1][matIdx].GetAsFloatArray(), 16));
+            }
+        }
+        //everything but the float inverse is expected to match bit for bit
+        if (kernelIdx != KERNEL_INVERSE && maxError != 0.f) {
+            isExact = false;
+        }
+        g_theConsole->PrintString(Rgba8::WHITE, Stringf("%-12s %12.2f %12.2f %9.2fx %12.3g", kernelNames[kernelIdx],
+            nsPerOp[0], nsPerOp[1], nsPerOp[0] / nsPerOp[1], maxError));
+    }
+
+    if (!isExact) {
+        g_theConsole->PrintError(Stringf("%s multiply or transforms differ from scalar", VECTOR_PATH_NAME));
+        return false;
+    }
+    g_theConsole->PrintString(Rgba8::GREEN, "multiply and transforms identical to scalar");
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// TransformVertexArray as it was, one vertex at a time through the scalar Mat44 path
+static void TransformVertexesOneByOne(std::vector<Vertex_PCU>& verts, Mat44 const& transformMat)
+{
+    for (Vertex_PCU& vert : verts) {
+        vert.position = transformMat.TransformPosition3DScalar(vert.position);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+static void TransformVertexesOneByOne(std::vector<Vertex_PCUTBN>& verts, Mat44 const& transformMat)
+{
+    Mat44 normalMat = transformMat;
+    normalMat.SetTranslation3D(Vec3::ZERO);
+    normalMat = MatrixTranspose(MatrixInverse(normalMat));
+    for (Vertex_PCUTBN& vert : verts) {
+        vert.position = transformMat.TransformPosition3DScalar(vert.position);
+        vert.normal = normalMat.TransformVector3D(vert.normal).GetNormalized();
+        Vec3 tangentDir = normalMat.TransformVector3D(vert.tangent.GetXYZ()).GetNormalized();
+        vert.tangent = Vec4(tangentDir, vert.tangent.w);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+COMMAND(math_vertex_transform_benchmark, "TransformVertexArray per vertex against the batch kernels, small and large arrays, vertexes=1000000 repeats=10", eEventFlag::EVENT_CONSOLE)
+{
+    int largeCount = args.GetValue("vertexes", 1000000);
+    int repeatCount = args.GetValue("repeats", 10);
+    if (largeCount <= 0 || repeatCount <= 0) {
+        g_theConsole->PrintError(Stringf("vertexes %i or repeats %i invalid", largeCount, repeatCount));
+        return false;
+    }
+
+    //no scale, the same array is transformed thousands of times and must stay finite
+    Mat44 transformMat = Mat44::FromRotationTranslation(Vec3(30.f, 45.f, 60.f), Vec3(.1f, -.2f, .05f));
+    RandomNumberGenerator rng;
+    rng.Reset(1357);
+    std::vector<Vertex_PCU> sourcePCU((size_t)largeCount);
+    std::vector<Vertex_PCUTBN> sourceTBN((size_t)largeCount);
+    for (int vertIdx = 0; vertIdx < largeCount; vertIdx++) {
+        Vec3 position(rng.RollRandomFloatInRange(-100.f, 100.f), rng.RollRandomFloatInRange(-100.f, 100.f), rng.RollRandomFloatInRange(-100.f, 100.f));
+        sourcePCU[vertIdx] = Vertex_PCU(position, Rgba8::WHITE);
+        sourceTBN[vertIdx] = Vertex_PCUTBN(position, Rgba8::WHITE, Vec2::ZERO, Vec4(rng.RollRandomDirection3D(), 1.f), rng.RollRandomDirection3D());
+    }
+
+    //a debug shape that stays in cache and a baked mesh that doesn't
+    int counts[2] = { largeCount < 4096 ? largeCount : 4096, largeCount };
+    g_theConsole->PrintString(Rgba8(255, 255, 0), Stringf("%-8s %10s %12s %12s %10s %10s", "vertex", "count", "one ns/vert", "batch ns/v", "speedup", "batch GB/s"));
+    bool isSame = true;
+    for (int typeIdx = 0; typeIdx < 2; typeIdx++) {
+        for (int count : counts) {
+            double nsPerVertex[2] = {};
+            for (int pathIdx = 0; pathIdx < 2; pathIdx++) {
+                //the same vertexes transformed over and over, fresh copies for each path
+                std::vector<Vertex_PCU> vertsPCU;
+                std::vector<Vertex_PCUTBN> vertsTBN;
+                if (typeIdx == 0) {
+                    vertsPCU.assign(sourcePCU.begin(), sourcePCU.begin() + count);
+                }
+                else {
+                    vertsTBN.assign(sourceTBN.begin(), sourceTBN.begin() + count);
+                }
+
+                int passCount = repeatCount * (largeCount / count);
+                double startTime = GetCurrentTimeSeconds();
+                for (int passIdx = 0; passIdx < passCount; passIdx++) {
+                    if (typeIdx == 0) {
+                        pathIdx == 0 ? TransformVertexesOneByOne(vertsPCU, transformMat) : TransformVertexArray(count, vertsPCU.data(), transformMat);
+                    }
+                    else {
+                        pathIdx == 0 ? TransformVertexesOneByOne(vertsTBN, transformMat) : TransformVertexArray(count, vertsTBN.data(), transformMat);
+                    }
+                }
+                nsPerVertex[pathIdx] = (GetCurrentTimeSeconds() - startTime) * 1.0e9 / ((double)count * (double)passCount);
+
+                //keep the first path's result to compare against
+                static std::vector<Vertex_PCU> sExpectedPCU;
+                static std::vector<Vertex_PCUTBN> sExpectedTBN;
+                if (pathIdx == 0) {
+                    sExpectedPCU.swap(vertsPCU);
+                    sExpectedTBN.swap(vertsTBN);
+                    continue;
+                }
+                for (int vertIdx = 0; vertIdx < count && isSame; vertIdx++) {
+                    if (typeIdx == 0) {
+                        isSame = vertsPCU[vertIdx].position == sExpectedPCU[vertIdx].position;
+                    }
+                    else {
+                        isSame = vertsTBN[vertIdx].position == sExpectedTBN[vertIdx].position && vertsTBN[vertIdx].normal == sExpectedTBN[vertIdx].normal &&
+                            vertsTBN[vertIdx].tangent == sExpectedTBN[vertIdx].tangent;
+                    }
+                }
+            }
+
+            double vertexBytes = typeIdx == 0 ? (double)sizeof(Vertex_PCU) : (double)sizeof(Vertex_PCUTBN);
+            g_theConsole->PrintString(Rgba8::WHITE, Stringf("%-8s %10i %12.2f %12.2f %9.2fx %10.2f", typeIdx == 0 ? "pcu" : "pcutbn", count,
+                nsPerVertex[0], nsPerVertex[1], nsPerVertex[0] / nsPerVertex[1], 2.0 * vertexBytes / nsPerVertex[1]));
+        }
+    }
+
+    if (!isSame) {
+        g_theConsole->PrintError("batch vertex transform differs from one by one");
+        return false;
+    }
+    g_theConsole->PrintString(Rgba8::GREEN, "batch results identical");
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+COMMAND(math_noise_benchmark, "Per sample SmoothNoise against the grid fills, 2D size*size and 3D (size/8)^3 grids, size=512 octaves=6 repeats=5", eEventFlag::EVENT_CONSOLE)
+{
+    int size = args.GetValue("size", 512);
+    int octaveCount = args.GetValue("octaves", 6);
+    int repeatCount = args.GetValue("repeats", 5);
+    if (size < 8 || octaveCount <= 0 || repeatCount <= 0) {
+        g_theConsole->PrintError(Stringf("size %i, octaves %i or repeats %i invalid", size, octaveCount, repeatCount));
+        return false;
+    }
+
+    char const* noiseNames[4] = { "fractal2d", "perlin2d", "fractal3d", "perlin3d" };
+    Vec3 const origin(-123.4f, 56.7f, 8.9f);
+    Vec3 const step(.37f, .41f, .43f);
+    float const scale = 20.f;
+    unsigned int const seed = 7;
+    unsigned int numOctaves = (unsigned int)octaveCount;
+    int side = size / 8;
+
+    g_theConsole->PrintString(Rgba8(255, 255, 0), Stringf("grid path %s", VECTOR_PATH_NAME));
+    g_theConsole->PrintString(Rgba8(255, 255, 0), Stringf("%-10s %10s %12s %12s %10s %12s", "noise", "samples", "sample ns", "fill ns", "speedup", "max error"));
+    bool isWithinEpsilon = true;
+    for (int noiseIdx = 0; noiseIdx < 4; noiseIdx++) {
+        bool is3d = noiseIdx >= 2;
+        int width = is3d ? side : size;
+        int height = is3d ? side : size;
+        int depth = is3d ? side : 1;
+        int sampleCount = width * height * depth;
+        std::vector<float> expected((size_t)sampleCount);
+        std::vector<float> filled((size_t)sampleCount);
+
+        double startTime = GetCurrentTimeSeconds();
+        for (int repeatIdx = 0; repeatIdx < repeatCount; repeatIdx++) {
+            int sampleIdx = 0;
+            for (int z = 0; z < depth; z++) {
+                for (int y = 0; y < height; y++) {
+                    for (int x = 0; x < width; x++) {
+                        float posX = origin.x + step.x * (float)x;
+                        float posY = origin.y + step.y * (float)y;
+                        float posZ = origin.z + step.z * (float)z;
+                        switch (noiseIdx) {
+                        case 0: expected[sampleIdx++] = Compute2dFractalNoise(posX, posY, scale, numOctaves, .5f, 2.f, true, seed); break;
+                        case 1: expected[sampleIdx++] = Compute2dPerlinNoise(posX, posY, scale, numOctaves, .5f, 2.f, true, seed); break;
+                        case 2: expected[sampleIdx++] = Compute3dFractalNoise(posX, posY, posZ, scale, numOctaves, .5f, 2.f, true, seed); break;
+                        default: expected[sampleIdx++] = Compute3dPerlinNoise(posX, posY, posZ, scale, numOctaves, .5f, 2.f, true, seed); break;
+                        }
+                    }
+                }
+            }
+        }
+        double sampleNs = (GetCurrentTimeSeconds() - startTime) * 1.0e9 / ((double)sampleCount * (double)repeatCount);
+
+        startTime = GetCurrentTimeSeconds();
+        for (int repeatIdx = 0; repeatIdx < repeatCount; repeatIdx++) {
+            switch (noiseIdx) {
+            case 0: Fill2dFractalNoise(filled.data(), Vec2(origin.x, origin.y), Vec2(step.x, step.y), width, height, scale, numOctaves, .5f, 2.f, true, seed); break;
+            case 1: Fill2dPerlinNoise(filled.data(), Vec2(origin.x, origin.y), Vec2(step.x, step.y), width, height, scale, numOctaves, .5f, 2.f, true, seed); break;
+            case 2: Fill3dFractalNoise(filled.data(), origin, step, width, height, depth, scale, numOctaves, .5f, 2.f, true, seed); break;
+            default: Fill3dPerlinNoise(filled.data(), origin, step, width, height, depth, scale, numOctaves, .5f, 2.f, true, seed); break;
+            }
+        }
+        double fillNs = (GetCurrentTimeSeconds() - startTime) * 1.0e9 / ((double)sampleCount * (double)repeatCount);
+
+        float maxError = 0.f;
+        for (int sampleIdx = 0; sampleIdx < sampleCount; sampleIdx++) {
+            float error = fabsf(filled[sampleIdx] - expected[sampleIdx]);
+            maxError = error > maxError ? error : maxError;
+        }
+        isWithinEpsilon = isWithinEpsilon && maxError <= 1.0e-5f;
+        g_theConsole->PrintString(Rgba8::WHITE, Stringf("%-10s %10i %12.2f %12.2f %9.2fx %12.3g", noiseNames[noiseIdx], sampleCount,
+            sampleNs, fillNs, sampleNs / fillNs, maxError));
+    }
+
+    if (!isWithinEpsilon) {
+        g_theConsole->PrintError("grid noise differs from the per sample functions");
+        return false;
+    }
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// one loop per noise function so nothing but the noise is in it
+template<typename NOISE_FUNC>
+static double GetNoiseSamplesPerSecond(std::vector<Vec4> const& positions, float& inOutSink, NOISE_FUNC const& noiseFunc)
+{
+    double startTime = GetCurrentTimeSeconds();
+    for (Vec4 const& pos : positions) {
+        inOutSink += noiseFunc(pos);
+    }
+    return (double)positions.size() / (GetCurrentTimeSeconds() - startTime);
+}
+
+//////////////////////////////////////////////////////////////////////////
+COMMAND(math_noise_speed_benchmark, "Samples per second of fractal, Perlin and simplex noise in 2D, 3D and 4D, samples=200000 octaves=4", eEventFlag::EVENT_CONSOLE)
+{
+    int sampleCount = args.GetValue("samples", 200000);
+    int octaveCount = args.GetValue("octaves", 4);
+    if (sampleCount <= 0 || octaveCount <= 0) {
+        g_theConsole->PrintError(Stringf("samples %i or octaves %i invalid", sampleCount, octaveCount));
+        return false;
+    }
+
+    RandomNumberGenerator rng;
+    rng.Reset(2468);
+    std::vector<Vec4> positions((size_t)sampleCount);
+    for (Vec4& pos : positions) {
+        pos = Vec4(rng.RollRandomFloatInRange(-500.f, 500.f), rng.RollRandomFloatInRange(-500.f, 500.f),
+            rng.RollRandomFloatInRange(-500.f, 500.f), rng.RollRandomFloatInRange(-500.f, 500.f));
+    }
+
+    char const* noiseNames[3] = { "fractal", "perlin", "simplex" };
+    g_theConsole->PrintString(Rgba8(255, 255, 0), Stringf("million samples per second, %i octaves", octaveCount));
+    g_theConsole->PrintString(Rgba8(255, 255, 0), Stringf("%-4s %10s %10s %10s", "dim", noiseNames[0], noiseNames[1], noiseNames[2]));
+    float sink = 0.f;   //keeps the samples from being optimized out
+    unsigned int numOctaves = (unsigned int)octaveCount;
+    double samplesPerSecond[3][3] = {};
+    samplesPerSecond[0][0] = GetNoiseSamplesPerSecond(positions, sink, [numOctaves](Vec4 const& pos) { return Compute2dFractalNoise(pos.x, pos.y, 1.f, numOctaves); });
+    samplesPerSecond[0][1] = GetNoiseSamplesPerSecond(positions, sink, [numOctaves](Vec4 const& pos) { return Compute2dPerlinNoise(pos.x, pos.y, 1.f, numOctaves); });
+    samplesPerSecond[0][2] = GetNoiseSamplesPerSecond(positions, sink, [numOctaves](Vec4 const& pos) { return Compute2dSimplexNoise(pos.x, pos.y, 1.f, numOctaves); });
+    samplesPerSecond[1][0] = GetNoiseSamplesPerSecond(positions, sink, [numOctaves](Vec4 const& pos) { return Compute3dFractalNoise(pos.x, pos.y, pos.z, 1.f, numOctaves); });
+    samplesPerSecond[1][1] = GetNoiseSamplesPerSecond(positions, sink, [numOctaves](Vec4 const& pos) { return Compute3dPerlinNoise(pos.x, pos.y, pos.z, 1.f, numOctaves); });
+    samplesPerSecond[1][2] = GetNoiseSamplesPerSecond(positions, sink, [numOctaves](Vec4 const& pos) { return Compute3dSimplexNoise(pos.x, pos.y, pos.z, 1.f, numOctaves); });
+    samplesPerSecond[2][0] = GetNoiseSamplesPerSecond(positions, sink, [numOctaves](Vec4 const& pos) { return Compute4dFractalNoise(pos.x, pos.y, pos.z, pos.w, 1.f, numOctaves); });
+    samplesPerSecond[2][1] = GetNoiseSamplesPerSecond(positions, sink, [numOctaves](Vec4 const& pos) { return Compute4dPerlinNoise(pos.x, pos.y, pos.z, pos.w, 1.f, numOctaves); });
+    samplesPerSecond[2][2] = GetNoiseSamplesPerSecond(positions, sink, [numOctaves](Vec4 const& pos) { return Compute4dSimplexNoise(pos.x, pos.y, pos.z, pos.w, 1.f, numOctaves); });
+    for (int dimIdx = 0; dimIdx < 3; dimIdx++) {
+        g_theConsole->PrintString(Rgba8::WHITE, Stringf("%-4s %10.2f %10.2f %10.2f", Stringf("%id", dimIdx + 2).c_str(),
+            samplesPerSecond[dimIdx][0] * 1.0e-6, samplesPerSecond[dimIdx][1] * 1.0e-6, samplesPerSecond[dimIdx][2] * 1.0e-6));
+    }
+    g_theConsole->PrintString(Rgba8(128, 128, 128), Stringf("checksum %f", sink));
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+COMMAND(math_rng_benchmark, "RandomNumberGenerator single rolls against the batch fills, count=1000000 repeats=5", eEventFlag::EVENT_CONSOLE)
+{
+    int count = args.GetValue("count", 1000000);
+    int repeatCount = args.GetValue("repeats", 5);
+    if (count <= 0 || repeatCount <= 0) {
+        g_theConsole->PrintError(Stringf("count %i or repeats %i invalid", count, repeatCount));
+        return false;
+    }
+
+    constexpr unsigned int seed = 1357;
+    Vec2 const discCenter(3.f, -2.f);
+    Vec3 const sphereCenter(1.f, 2.f, 3.f);
+    std::vector<float> expected((size_t)count * 3);
+    std::vector<float> filled((size_t)count * 3);
+    Vec2* expected2d = reinterpret_cast<Vec2*>(expected.data());
+    Vec3* expected3d = reinterpret_cast<Vec3*>(expected.data());
+    Vec2* filled2d = reinterpret_cast<Vec2*>(filled.data());
+    Vec3* filled3d = reinterpret_cast<Vec3*>(filled.data());
+
+    char const* rollNames[5] = { "floats", "dirs2d", "dirs3d", "disc", "sphere" };
+    int rollFloats[5] = { 1, 2, 3, 2, 3 };
+    g_theConsole->PrintString(Rgba8(255, 255, 0), Stringf("%s path, ns per item", VECTOR_PATH_NAME));
+    g_theConsole->PrintString(Rgba8(255, 255, 0), Stringf("%-8s %10s %10s %10s %12s", "rolls", "single", "batch", "speedup", "max error"));
+    bool isWithinEpsilon = true;
+    RandomNumberGenerator rng;
+    for (int rollIdx = 0; rollIdx < 5; rollIdx++) {
+        double startTime = GetCurrentTimeSeconds();
+        for (int repeatIdx = 0; repeatIdx < repeatCount; repeatIdx++) {
+            rng.Reset(seed);
+            for (int itemIdx = 0; itemIdx < count; itemIdx++) {
+                switch (rollIdx) {
+                case 0: expected[itemIdx] = rng.RollRandomFloatInRange(-5.f, 10.f); break;
+                case 1: expected2d[itemIdx] = rng.RollRandomDirection2D(); break;
+                case 2: expected3d[itemIdx] = rng.RollRandomDirection3D(); break;
+                case 3: {
+                    Vec2 direction = rng.RollRandomDirection2D();
+                    expected2d[itemIdx] = discCenter + direction * (4.f * sqrtf(rng.RollRandomFloatZeroToAlmostOne()));
+                    break;
+                }
+                default: {
+                    Vec2 direction = rng.RollRandomDirection2D();
+                    float height = 1.f - 2.f * rng.RollRandomFloatZeroToAlmostOne();
+                    float ringRadius = 4.f * sqrtf(MaxFloat(0.f, 1.f - height * height));
+                    expected3d[itemIdx] = sphereCenter + Vec3(direction.x * ringRadius, direction.y * ringRadius, 4.f * height);
+                    break;
+                }
+                }
+            }
+        }
+        double singleNs = (GetCurrentTimeSeconds() - startTime) * 1.0e9 / ((double)count * (double)repeatCount);
+
+        startTime = GetCurrentTimeSeconds();
+        for (int repeatIdx = 0; repeatIdx < repeatCount; repeatIdx++) {
+            rng.Reset(seed);
+            switch (rollIdx) {
+            case 0: rng.FillRandomFloatsInRange(filled.data(), count, -5.f, 10.f); break;
+            case 1: rng.FillRandomDirections2D(filled2d, count); break;
+            case 2: rng.FillRandomDirections3D(filled3d, count); break;
+            case 3: rng.FillRandomPointsInDisc(filled2d, count, discCenter, 4.f); break;
+            default: rng.FillRandomPointsOnSphere(filled3d, count, sphereCenter, 4.f); break;
+            }
+        }
+        double batchNs = (GetCurrentTimeSeconds() - startTime) * 1.0e9 / ((double)count * (double)repeatCount);
+
+        //floats must match exactly, the rest only differ by the sin and cos
+        float maxError = GetRelativeError(expected.data(), filled.data(), count * rollFloats[rollIdx]);
+        isWithinEpsilon = isWithinEpsilon && maxError <= (rollIdx == 0 ? 0.f : 1.0e-5f);
+        g_theConsole->PrintString(Rgba8::WHITE, Stringf("%-8s %10.2f %10.2f %9.2fx %12.3g", rollNames[rollIdx],
+            singleNs, batchNs, singleNs / batchNs, maxError));
+    }
+
+    //two workers jumping to their own halves get what one fill does
+    rng.Reset(seed);
+    rng.FillRandomFloatsInRange(expected.data(), count, 0.f, 1.f);
+    int firstHalf = count / 2 + 1;
+    RandomNumberGenerator secondWorker;
+    secondWorker.Reset(seed);
+    secondWorker.Jump((unsigned int)firstHalf);
+    rng.Reset(seed);
+    rng.FillRandomFloatsInRange(filled.data(), firstHalf, 0.f, 1.f);
+    secondWorker.FillRandomFloatsInRange(filled.data() + firstHalf, count - firstHalf, 0.f, 1.f);
+    bool isJumpMatching = GetRelativeError(expected.data(), filled.data(), count) == 0.f;
+
+    if (!isWithinEpsilon || !isJumpMatching) {
+        g_theConsole->PrintError("batch rolls differ from the single rolls");
+        return false;
+    }
+    return true;
+}
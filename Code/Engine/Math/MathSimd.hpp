@@ -0,0 +1,46 @@
+#pragma once
+
+//////////////////////////////////////////////////////////////////////////
+// instruction set for the vector math kernels, picked at compile time.
+// SSE2 is always there on x64, AVX only with /arch:AVX or -mavx. Define
+// MATH_SIMD_SCALAR to build the plain C++ paths everywhere
+#if !defined(MATH_SIMD_SCALAR)
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MATH_SIMD_SSE
+#include <emmintrin.h>
+#if defined(__AVX__)
+#define MATH_SIMD_AVX
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define MATH_SIMD_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+#if defined(MATH_SIMD_SSE)
+//////////////////////////////////////////////////////////////////////////
+// low 32 bits of each product, SSE2 has no 32 bit lane multiply
+inline __m128i MultiplyLanes(__m128i valuesA, __m128i valuesB)
+{
+#if defined(MATH_SIMD_AVX)
+    return _mm_mullo_epi32(valuesA, valuesB);
+#else
+    __m128i evens = _mm_mul_epu32(valuesA, valuesB);
+    __m128i odds = _mm_mul_epu32(_mm_srli_epi64(valuesA, 32), _mm_srli_epi64(valuesB, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(evens, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odds, _MM_SHUFFLE(0, 0, 2, 0)));
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+// floorf and the int cast, SSE2 has no floor. Same as the scalar code
+// while values stay inside int range
+inline __m128 FloorLanes(__m128 values, __m128i& outIndexes)
+{
+    __m128i truncated = _mm_cvttps_epi32(values);
+    __m128 truncatedFloats = _mm_cvtepi32_ps(truncated);
+    __m128 isAbove = _mm_cmpgt_ps(truncatedFloats, values);    //negative with a fraction
+    outIndexes = _mm_add_epi32(truncated, _mm_castps_si128(isAbove));
+    return _mm_sub_ps(truncatedFloats, _mm_and_ps(isAbove, _mm_set1_ps(1.f)));
+}
+#endif
@@ -554,6 +554,31 @@ bool DoesRayHitLineSegment2D(Vec2 const& start, Vec2 const& end, Vec2 const& lin
 	return false;
 }
 
+//////////////////////////////////////////////////////////////////////////
+bool DoesRayHitDisc2D(Vec2 const& start, Vec2 const& end, Vec2 const& center, float radius, float& outFraction)
+{
+	//|start + t * forward - center| = radius, smaller root
+	Vec2 forward = end - start;
+	Vec2 centerToStart = start - center;
+	float a = forward.GetLengthSquared();
+	float b = DotProduct2D(centerToStart, forward);
+	float c = centerToStart.GetLengthSquared() - radius * radius;
+	if (c <= 0.f || b >= 0.f || a == 0.f) {	//inside or heading away
+		return false;
+	}
+	float discriminant = b * b - a * c;
+	if (discriminant < 0.f) {
+		return false;
+	}
+
+	float fraction = (-b - SqrtFloat(discriminant)) / a;
+	if (fraction > 1.f) {
+		return false;
+	}
+	outFraction = fraction;
+	return true;
+}
+
 //////////////////////////////////////////////////////////////////////////
 Vec2 GetCentroidOfPolygon(Vec2 const* points, int pointCount)
 {
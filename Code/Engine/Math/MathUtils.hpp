@@ -61,6 +61,7 @@ bool DoesRayHitBoundingBox2D(Vec2 const& start, Vec2 const& end, AABB2 const& bo
 bool DoesRayHitPlane2D(Vec2 const& start, Vec2 const& forward, Plane2D const& plane);
 bool DoesRayHitLineSegment2D(Vec2 const& start, Vec2 const& end, Vec2 const& lineA, Vec2 const& lineB);
 bool DoesRayHitLineSegment2D(Vec2 const& start, Vec2 const& end, Vec2 const& lineA, Vec2 const& lineB, Vec2& outHitPoint, Vec2& outHitNormal, float& outDistance);//cross-product
+bool DoesRayHitDisc2D(Vec2 const& start, Vec2 const& end, Vec2 const& center, float radius, float& outFraction);//fraction of start to end where it enters, misses from inside
 
 Vec2 GetCentroidOfPolygon(Vec2 const* points, int pointCount);
 Disc2 GetMinimumOuterDiscForPolygon(Vec2 const* points, int pointCount);
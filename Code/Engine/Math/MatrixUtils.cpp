@@ -3,6 +3,7 @@
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/Vec3.hpp"
 #include "Engine/Math/Vec4.hpp"
+#include "Engine/Math/MathSimd.hpp"
 
 //////////////////////////////////////////////////////////////////////////
 Mat44 MakeOrthographicProjectionMatrixD3D(float minX, float maxX, float minY, float maxY, float minZ, float maxZ)
@@ -91,13 +92,104 @@ Mat44 MatrixInverseOrthoNormal(Mat44 const& mat)
     return inverse;
 }
 
+#if defined(MATH_SIMD_SSE)
 //////////////////////////////////////////////////////////////////////////
+// 2x2 blocks packed in one register as (m00, m01, m10, m11)
+static inline __m128 Mat22Multiply(__m128 a, __m128 b)
+{
+    return _mm_add_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 3, 0))),
+        _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+
+//////////////////////////////////////////////////////////////////////////
+// adjugate(a) * b
+static inline __m128 Mat22AdjugateMultiply(__m128 a, __m128 b)
+{
+    return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 3)), b),
+        _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+}
+
+//////////////////////////////////////////////////////////////////////////
+// a * adjugate(b)
+static inline __m128 Mat22MultiplyAdjugate(__m128 a, __m128 b)
+{
+    return _mm_sub_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 0, 3))),
+        _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+
+//////////////////////////////////////////////////////////////////////////
+// block inverse over the 2x2 quarters in float. Inverting the transpose
+// and transposing back is the same thing, so columns go in where the
+// method expects rows and columns of the inverse come out
+static Mat44 MatrixInverseSse(Mat44 const& mat)
+{
+    __m128 column0 = _mm_loadu_ps(&mat.Ix);
+    __m128 column1 = _mm_loadu_ps(&mat.Jx);
+    __m128 column2 = _mm_loadu_ps(&mat.Kx);
+    __m128 column3 = _mm_loadu_ps(&mat.Tx);
+    __m128 a = _mm_movelh_ps(column0, column1);
+    __m128 b = _mm_movehl_ps(column1, column0);
+    __m128 c = _mm_movelh_ps(column2, column3);
+    __m128 d = _mm_movehl_ps(column3, column2);
+
+    //determinants of a, b, c and d in one go
+    __m128 blockDets = _mm_sub_ps(
+        _mm_mul_ps(_mm_shuffle_ps(column0, column2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(column1, column3, _MM_SHUFFLE(3, 1, 3, 1))),
+        _mm_mul_ps(_mm_shuffle_ps(column0, column2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(column1, column3, _MM_SHUFFLE(2, 0, 2, 0))));
+    __m128 detA = _mm_shuffle_ps(blockDets, blockDets, _MM_SHUFFLE(0, 0, 0, 0));
+    __m128 detB = _mm_shuffle_ps(blockDets, blockDets, _MM_SHUFFLE(1, 1, 1, 1));
+    __m128 detC = _mm_shuffle_ps(blockDets, blockDets, _MM_SHUFFLE(2, 2, 2, 2));
+    __m128 detD = _mm_shuffle_ps(blockDets, blockDets, _MM_SHUFFLE(3, 3, 3, 3));
+
+    //inverse is 1/det * | x y |, each quarter built as its adjugate first
+    //                   | z w |
+    __m128 adjDC = Mat22AdjugateMultiply(d, c);
+    __m128 adjAB = Mat22AdjugateMultiply(a, b);
+    __m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), Mat22Multiply(b, adjDC));
+    __m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), Mat22Multiply(c, adjAB));
+    __m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), Mat22MultiplyAdjugate(d, adjAB));
+    __m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), Mat22MultiplyAdjugate(a, adjDC));
+
+    //det = |a||d| + |b||c| - trace(adj(a)b adj(d)c)
+    __m128 trace = _mm_mul_ps(adjAB, _mm_shuffle_ps(adjDC, adjDC, _MM_SHUFFLE(3, 1, 2, 0)));
+    trace = _mm_add_ps(trace, _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(2, 3, 0, 1)));
+    trace = _mm_add_ps(trace, _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(1, 0, 3, 2)));
+    __m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+    __m128 signedDetInverse = _mm_div_ps(_mm_setr_ps(1.f, -1.f, -1.f, 1.f), det);
+    x = _mm_mul_ps(x, signedDetInverse);
+    y = _mm_mul_ps(y, signedDetInverse);
+    z = _mm_mul_ps(z, signedDetInverse);
+    w = _mm_mul_ps(w, signedDetInverse);
+
+    //the shuffles finish the adjugates and put the quarters back in columns
+    Mat44 inverse;
+    _mm_storeu_ps(&inverse.Ix, _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)));
+    _mm_storeu_ps(&inverse.Jx, _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)));
+    _mm_storeu_ps(&inverse.Kx, _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)));
+    _mm_storeu_ps(&inverse.Tx, _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)));
+    return inverse;
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+// the vector path works in float, results stay within float rounding of
+// the double precision cofactors for any matrix that isn't near singular
 Mat44 MatrixInverse(Mat44 const& mat)
 {
     if (MatrixIsOrthoNormal(mat)) {
         return MatrixInverseOrthoNormal(mat);
     }
 
+#if defined(MATH_SIMD_SSE)
+    return MatrixInverseSse(mat);
+#else
+    return MatrixInverseScalar(mat);
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+Mat44 MatrixInverseScalar(Mat44 const& mat)
+{
     double inv[16];
     double det = 0;
     double m[16];
@@ -252,6 +344,108 @@ Mat44 MatrixComponentLerp(Mat44 const& matA, Mat44 const& matB, float value)
     return result;
 }
 
+//////////////////////////////////////////////////////////////////////////
+static inline Vec3 const& GetStridedVec3(Vec3 const* first, int stride, int idx)
+{
+    return *(Vec3 const*)((unsigned char const*)first + (size_t)idx * (size_t)stride);
+}
+
+//////////////////////////////////////////////////////////////////////////
+static inline Vec3& GetStridedVec3(Vec3* first, int stride, int idx)
+{
+    return *(Vec3*)((unsigned char*)first + (size_t)idx * (size_t)stride);
+}
+
+#if defined(MATH_SIMD_SSE)
+//////////////////////////////////////////////////////////////////////////
+// 4 strided Vec3s into x, y and z registers, one Vec3 per lane
+static inline void LoadVec3Lanes(Vec3 const* first, int stride, int idx, __m128& outX, __m128& outY, __m128& outZ)
+{
+    __m128 rows[4];
+    for (int laneIdx = 0; laneIdx < 4; laneIdx++) {
+        Vec3 const& vec = GetStridedVec3(first, stride, idx + laneIdx);
+        rows[laneIdx] = _mm_movelh_ps(_mm_loadl_pi(_mm_setzero_ps(), (__m64 const*)&vec.x), _mm_load_ss(&vec.z));
+    }
+    _MM_TRANSPOSE4_PS(rows[0], rows[1], rows[2], rows[3]);
+    outX = rows[0];
+    outY = rows[1];
+    outZ = rows[2];
+}
+
+//////////////////////////////////////////////////////////////////////////
+static inline void StoreVec3Lanes(Vec3* first, int stride, int idx, __m128 x, __m128 y, __m128 z)
+{
+    __m128 rows[4] = { x, y, z, _mm_setzero_ps() };
+    _MM_TRANSPOSE4_PS(rows[0], rows[1], rows[2], rows[3]);
+    for (int laneIdx = 0; laneIdx < 4; laneIdx++) {
+        Vec3& vec = GetStridedVec3(first, stride, idx + laneIdx);
+        _mm_storel_pi((__m64*)&vec.x, rows[laneIdx]);
+        _mm_store_ss(&vec.z, _mm_movehl_ps(rows[laneIdx], rows[laneIdx]));
+    }
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+// 4 Vec3s per step, transposed so each register holds one axis. The lane
+// math is the scalar math of Mat44::TransformPosition3D, leftovers and
+// NEON go through TransformPosition3D one at a time
+void MatrixTransformPositions3D(Mat44 const& mat, int count, Vec3 const* inPositions, int inStride, Vec3* outPositions, int outStride)
+{
+    int idx = 0;
+#if defined(MATH_SIMD_SSE)
+    __m128 const ix = _mm_set1_ps(mat.Ix), iy = _mm_set1_ps(mat.Iy), iz = _mm_set1_ps(mat.Iz);
+    __m128 const jx = _mm_set1_ps(mat.Jx), jy = _mm_set1_ps(mat.Jy), jz = _mm_set1_ps(mat.Jz);
+    __m128 const kx = _mm_set1_ps(mat.Kx), ky = _mm_set1_ps(mat.Ky), kz = _mm_set1_ps(mat.Kz);
+    __m128 const tx = _mm_set1_ps(mat.Tx), ty = _mm_set1_ps(mat.Ty), tz = _mm_set1_ps(mat.Tz);
+    for (; idx + 4 <= count; idx += 4) {
+        __m128 x, y, z;
+        LoadVec3Lanes(inPositions, inStride, idx, x, y, z);
+        __m128 outX = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(ix, x), _mm_mul_ps(jx, y)), _mm_mul_ps(kx, z)), tx);
+        __m128 outY = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(iy, x), _mm_mul_ps(jy, y)), _mm_mul_ps(ky, z)), ty);
+        __m128 outZ = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(iz, x), _mm_mul_ps(jz, y)), _mm_mul_ps(kz, z)), tz);
+        StoreVec3Lanes(outPositions, outStride, idx, outX, outY, outZ);
+    }
+#endif
+
+    for (; idx < count; idx++) {
+        GetStridedVec3(outPositions, outStride, idx) = mat.TransformPosition3D(GetStridedVec3(inPositions, inStride, idx));
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// normalizing matches Vec3::GetNormalized, zero length vectors come out zero
+void MatrixTransformVectors3D(Mat44 const& mat, int count, Vec3 const* inVectors, int inStride, Vec3* outVectors, int outStride, bool isNormalizing)
+{
+    int idx = 0;
+#if defined(MATH_SIMD_SSE)
+    __m128 const ix = _mm_set1_ps(mat.Ix), iy = _mm_set1_ps(mat.Iy), iz = _mm_set1_ps(mat.Iz);
+    __m128 const jx = _mm_set1_ps(mat.Jx), jy = _mm_set1_ps(mat.Jy), jz = _mm_set1_ps(mat.Jz);
+    __m128 const kx = _mm_set1_ps(mat.Kx), ky = _mm_set1_ps(mat.Ky), kz = _mm_set1_ps(mat.Kz);
+    __m128 const one = _mm_set1_ps(1.f);
+    for (; idx + 4 <= count; idx += 4) {
+        __m128 x, y, z;
+        LoadVec3Lanes(inVectors, inStride, idx, x, y, z);
+        __m128 outX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ix, x), _mm_mul_ps(jx, y)), _mm_mul_ps(kx, z));
+        __m128 outY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(iy, x), _mm_mul_ps(jy, y)), _mm_mul_ps(ky, z));
+        __m128 outZ = _mm_add_ps(_mm_add_ps(_mm_mul_ps(iz, x), _mm_mul_ps(jz, y)), _mm_mul_ps(kz, z));
+        if (isNormalizing) {
+            __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(outX, outX), _mm_mul_ps(outY, outY)), _mm_mul_ps(outZ, outZ)));
+            __m128 isNonZero = _mm_cmpneq_ps(length, _mm_setzero_ps());
+            __m128 lengthFactor = _mm_div_ps(one, length);
+            outX = _mm_and_ps(isNonZero, _mm_mul_ps(outX, lengthFactor));
+            outY = _mm_and_ps(isNonZero, _mm_mul_ps(outY, lengthFactor));
+            outZ = _mm_and_ps(isNonZero, _mm_mul_ps(outZ, lengthFactor));
+        }
+        StoreVec3Lanes(outVectors, outStride, idx, outX, outY, outZ);
+    }
+#endif
+
+    for (; idx < count; idx++) {
+        Vec3 vec = mat.TransformVector3D(GetStridedVec3(inVectors, inStride, idx));
+        GetStridedVec3(outVectors, outStride, idx) = isNormalizing ? vec.GetNormalized() : vec;
+    }
+}
+
 //////////////////////////////////////////////////////////////////////////
 Mat44 MatrixLookAt(Vec3 const& start, Vec3 const& end, Vec3 const& worldUp, Vec3 const& worldForward)
 {
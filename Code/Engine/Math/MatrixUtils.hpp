@@ -21,8 +21,16 @@ bool MatrixIsOrthoNormal(Mat44 const& mat);
 Mat44 MatrixTranspose(Mat44 const& mat);
 Mat44 MatrixInverseOrthoNormal(Mat44 const& mat);
 Mat44 MatrixInverse(Mat44 const& mat);
+Mat44 MatrixInverseScalar(Mat44 const& mat);    //cofactors in double, reference for the vector path
 
 Mat44 MatrixMultiply(Mat44 const& matFront, Mat44 const& matBack);
 Mat44 MatrixComponentLerp(Mat44 const& matA, Mat44 const& matB, float value);
 
+// batch transforms over strided arrays, the stride is the byte distance
+// between consecutive Vec3s, sizeof(Vertex_PCU) for vertex positions. Only
+// the 12 bytes of each Vec3 are read and written, in and out may be the
+// same array. Bit identical to the per Vec3 Mat44 transforms
+void MatrixTransformPositions3D(Mat44 const& mat, int count, Vec3 const* inPositions, int inStride, Vec3* outPositions, int outStride);
+void MatrixTransformVectors3D(Mat44 const& mat, int count, Vec3 const* inVectors, int inStride, Vec3* outVectors, int outStride, bool isNormalizing = false);
+
 Mat44 MatrixLookAt(Vec3 const& start, Vec3 const& end, Vec3 const& worldUp = Vec3(0.f,1.f,0.f), Vec3 const& worldForwar = Vec3(0.f,0.f,1.f));
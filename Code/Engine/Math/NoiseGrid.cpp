@@ -0,0 +1,349 @@
+#include "Engine/Math/NoiseGrid.hpp"
+#include "Engine/Math/SmoothNoise.hpp"
+#include "Engine/Math/RawNoiseSimd.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/Job.hpp"
+#include <math.h>
+
+static constexpr int NOISE_GRID_GRAIN_SAMPLES = 4096;  //samples per parallel chunk, whole rows
+
+//same constants as SmoothNoise.cpp and RawNoise.hpp, the lanes must hash and offset identically
+static constexpr float OCTAVE_OFFSET = 0.636764989593174f;
+static constexpr unsigned int NOISE_PRIME1 = 198491317;
+static constexpr unsigned int NOISE_PRIME2 = 6542989;
+static constexpr double ONE_OVER_MAX_UINT = (1.0 / (double)0xFFFFFFFF);
+
+//////////////////////////////////////////////////////////////////////////
+enum eNoiseGridType
+{
+    NOISE_GRID_FRACTAL_2D,
+    NOISE_GRID_PERLIN_2D,
+    NOISE_GRID_FRACTAL_3D,
+    NOISE_GRID_PERLIN_3D,
+};
+
+struct NoiseGridSettings
+{
+    eNoiseGridType type = NOISE_GRID_FRACTAL_2D;
+    float* outNoise = nullptr;
+    Vec3 origin;
+    Vec3 step;
+    int width = 0;
+    int height = 0;
+    float scale = 1.f;
+    unsigned int numOctaves = 1;
+    float octavePersistence = 0.5f;
+    float octaveScale = 2.f;
+    bool renormalize = true;
+    unsigned int seed = 0;
+    float totalAmplitude = 0.f;     //the same for every sample, summed once
+};
+
+#if !defined(MATH_SIMD_SSE)
+//////////////////////////////////////////////////////////////////////////
+static float ComputeNoiseSample(NoiseGridSettings const& settings, float posX, float posY, float posZ)
+{
+    switch (settings.type) {
+    case NOISE_GRID_FRACTAL_2D:
+        return Compute2dFractalNoise(posX, posY, settings.scale, settings.numOctaves, settings.octavePersistence, settings.octaveScale, settings.renormalize, settings.seed);
+    case NOISE_GRID_PERLIN_2D:
+        return Compute2dPerlinNoise(posX, posY, settings.scale, settings.numOctaves, settings.octavePersistence, settings.octaveScale, settings.renormalize, settings.seed);
+    case NOISE_GRID_FRACTAL_3D:
+        return Compute3dFractalNoise(posX, posY, posZ, settings.scale, settings.numOctaves, settings.octavePersistence, settings.octaveScale, settings.renormalize, settings.seed);
+    default:
+        return Compute3dPerlinNoise(posX, posY, posZ, settings.scale, settings.numOctaves, settings.octavePersistence, settings.octaveScale, settings.renormalize, settings.seed);
+    }
+}
+#else
+//////////////////////////////////////////////////////////////////////////
+static __m128 SmoothStep3Lanes(__m128 t)
+{
+    __m128 threeTT = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(3.f), t), t);
+    __m128 twoTTT = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(_mm_set1_ps(2.f), t), t), t);
+    return _mm_sub_ps(threeTT, twoTTT);
+}
+
+//////////////////////////////////////////////////////////////////////////
+static __m128 RenormalizeLanes(__m128 totalNoise, NoiseGridSettings const& settings)
+{
+    if (!settings.renormalize || !(settings.totalAmplitude > 0.f)) {
+        return totalNoise;
+    }
+
+    totalNoise = _mm_div_ps(totalNoise, _mm_set1_ps(settings.totalAmplitude));
+    totalNoise = _mm_add_ps(_mm_mul_ps(totalNoise, _mm_set1_ps(0.5f)), _mm_set1_ps(0.5f));
+    totalNoise = SmoothStep3Lanes(totalNoise);
+    return _mm_sub_ps(_mm_mul_ps(totalNoise, _mm_set1_ps(2.f)), _mm_set1_ps(1.f));
+}
+
+//////////////////////////////////////////////////////////////////////////
+// gradients[noise & 7] of Compute2dPerlinNoise without the table: +4
+// negates, 1, 2, 5 and 6 swap the components, 2, 3, 4 and 5 have negative x
+static __m128 DotPerlinGradient2dLanes(__m128i noise, __m128 displacementX, float displacementY)
+{
+    __m128i const signBit = _mm_set1_epi32((int)0x80000000);
+    __m128 isSwapped = _mm_castsi128_ps(_mm_srai_epi32(_mm_slli_epi32(_mm_xor_si128(noise, _mm_srli_epi32(noise, 1)), 31), 31));
+    __m128 const major = _mm_set1_ps(0.923879533f);
+    __m128 const minor = _mm_set1_ps(0.382683432f);
+    __m128 gradientX = _mm_or_ps(_mm_and_ps(isSwapped, minor), _mm_andnot_ps(isSwapped, major));
+    __m128 gradientY = _mm_or_ps(_mm_and_ps(isSwapped, major), _mm_andnot_ps(isSwapped, minor));
+    __m128i signX = _mm_and_si128(_mm_xor_si128(_mm_slli_epi32(noise, 30), _mm_slli_epi32(noise, 29)), signBit);
+    __m128i signY = _mm_and_si128(_mm_slli_epi32(noise, 29), signBit);
+    gradientX = _mm_xor_ps(gradientX, _mm_castsi128_ps(signX));
+    gradientY = _mm_xor_ps(gradientY, _mm_castsi128_ps(signY));
+    return _mm_add_ps(_mm_mul_ps(gradientX, displacementX), _mm_mul_ps(gradientY, _mm_set1_ps(displacementY)));
+}
+
+//////////////////////////////////////////////////////////////////////////
+// gradients[noise & 7] of Compute3dPerlinNoise, bits 0, 1 and 2 negate x, y and z
+static __m128 DotPerlinGradient3dLanes(__m128i noise, __m128 displacementX, float displacementY, float displacementZ)
+{
+    __m128i const signBit = _mm_set1_epi32((int)0x80000000);
+    __m128 const component = _mm_set1_ps(fSQRT_3_OVER_3);
+    __m128 gradientX = _mm_xor_ps(component, _mm_castsi128_ps(_mm_and_si128(_mm_slli_epi32(noise, 31), signBit)));
+    __m128 gradientY = _mm_xor_ps(component, _mm_castsi128_ps(_mm_and_si128(_mm_slli_epi32(noise, 30), signBit)));
+    __m128 gradientZ = _mm_xor_ps(component, _mm_castsi128_ps(_mm_and_si128(_mm_slli_epi32(noise, 29), signBit)));
+    __m128 dotXY = _mm_add_ps(_mm_mul_ps(gradientX, displacementX), _mm_mul_ps(gradientY, _mm_set1_ps(displacementY)));
+    return _mm_add_ps(dotXY, _mm_mul_ps(gradientZ, _mm_set1_ps(displacementZ)));
+}
+
+//////////////////////////////////////////////////////////////////////////
+static __m128 BlendLanes(__m128 weightA, __m128 valueA, __m128 weightB, __m128 valueB)
+{
+    return _mm_add_ps(_mm_mul_ps(weightA, valueA), _mm_mul_ps(weightB, valueB));
+}
+
+//////////////////////////////////////////////////////////////////////////
+// four samples of a row, x in lanes. Everything along y and z is the same
+// for the whole row and stays scalar. Operation order follows SmoothNoise.cpp
+static __m128 ComputeNoiseLanes(NoiseGridSettings const& settings, __m128 posX, float posY, float posZ)
+{
+    bool is3d = settings.type == NOISE_GRID_FRACTAL_3D || settings.type == NOISE_GRID_PERLIN_3D;
+    bool isPerlin = settings.type == NOISE_GRID_PERLIN_2D || settings.type == NOISE_GRID_PERLIN_3D;
+    __m128 const one = _mm_set1_ps(1.f);
+    __m128i const oneInt = _mm_set1_epi32(1);
+
+    float invScale = (1.f / settings.scale);
+    __m128 currentX = _mm_mul_ps(posX, _mm_set1_ps(invScale));
+    float currentY = posY * invScale;
+    float currentZ = posZ * invScale;
+    float currentAmplitude = 1.f;
+    unsigned int seed = settings.seed;
+    __m128 totalNoise = _mm_setzero_ps();
+    for (unsigned int octaveNum = 0; octaveNum < settings.numOctaves; octaveNum++) {
+        __m128i indexWestX;
+        __m128 cellMinX = FloorLanes(currentX, indexWestX);
+        __m128i indexEastX = _mm_add_epi32(indexWestX, oneInt);
+        float cellMinY = floorf(currentY);
+        float cellMinZ = floorf(currentZ);
+        unsigned int indexSouthY = (unsigned int)(int)cellMinY;
+        unsigned int indexBelowZ = is3d ? (unsigned int)(int)cellMinZ : 0;
+        __m128i rowSouthBelow = _mm_set1_epi32((int)(NOISE_PRIME1 * indexSouthY + NOISE_PRIME2 * indexBelowZ));
+        __m128i rowNorthBelow = _mm_set1_epi32((int)(NOISE_PRIME1 * (indexSouthY + 1) + NOISE_PRIME2 * indexBelowZ));
+
+        __m128 displacementWestX = _mm_sub_ps(currentX, cellMinX);
+        __m128 displacementEastX = _mm_sub_ps(currentX, _mm_add_ps(cellMinX, one));
+        float displacementSouthY = currentY - cellMinY;
+        float displacementNorthY = currentY - (cellMinY + 1.f);
+        float displacementBelowZ = currentZ - cellMinZ;
+        float displacementAboveZ = currentZ - (cellMinZ + 1.f);
+
+        __m128 weightEast = SmoothStep3Lanes(displacementWestX);
+        __m128 weightWest = _mm_sub_ps(one, weightEast);
+        float weightNorth = SmoothStep3(displacementSouthY);
+        float weightSouth = 1.f - weightNorth;
+
+        __m128i noiseSW = Get1dNoiseUintLanes(_mm_add_epi32(indexWestX, rowSouthBelow), seed);
+        __m128i noiseSE = Get1dNoiseUintLanes(_mm_add_epi32(indexEastX, rowSouthBelow), seed);
+        __m128i noiseNW = Get1dNoiseUintLanes(_mm_add_epi32(indexWestX, rowNorthBelow), seed);
+        __m128i noiseNE = Get1dNoiseUintLanes(_mm_add_epi32(indexEastX, rowNorthBelow), seed);
+        __m128 valueSW, valueSE, valueNW, valueNE;
+        if (!isPerlin) {
+            valueSW = GetNoiseScaledLanes(noiseSW, ONE_OVER_MAX_UINT);
+            valueSE = GetNoiseScaledLanes(noiseSE, ONE_OVER_MAX_UINT);
+            valueNW = GetNoiseScaledLanes(noiseNW, ONE_OVER_MAX_UINT);
+            valueNE = GetNoiseScaledLanes(noiseNE, ONE_OVER_MAX_UINT);
+        }
+        else if (!is3d) {
+            valueSW = DotPerlinGradient2dLanes(noiseSW, displacementWestX, displacementSouthY);
+            valueSE = DotPerlinGradient2dLanes(noiseSE, displacementEastX, displacementSouthY);
+            valueNW = DotPerlinGradient2dLanes(noiseNW, displacementWestX, displacementNorthY);
+            valueNE = DotPerlinGradient2dLanes(noiseNE, displacementEastX, displacementNorthY);
+        }
+        else {
+            valueSW = DotPerlinGradient3dLanes(noiseSW, displacementWestX, displacementSouthY, displacementBelowZ);
+            valueSE = DotPerlinGradient3dLanes(noiseSE, displacementEastX, displacementSouthY, displacementBelowZ);
+            valueNW = DotPerlinGradient3dLanes(noiseNW, displacementWestX, displacementNorthY, displacementBelowZ);
+            valueNE = DotPerlinGradient3dLanes(noiseNE, displacementEastX, displacementNorthY, displacementBelowZ);
+        }
+        __m128 blendSouth = BlendLanes(weightEast, valueSE, weightWest, valueSW);
+        __m128 blendNorth = BlendLanes(weightEast, valueNE, weightWest, valueNW);
+        __m128 blendTotal = BlendLanes(_mm_set1_ps(weightSouth), blendSouth, _mm_set1_ps(weightNorth), blendNorth);
+
+        if (is3d) {
+            //the layer above, blendTotal so far is the one below
+            __m128i rowSouthAbove = _mm_set1_epi32((int)(NOISE_PRIME1 * indexSouthY + NOISE_PRIME2 * (indexBelowZ + 1)));
+            __m128i rowNorthAbove = _mm_set1_epi32((int)(NOISE_PRIME1 * (indexSouthY + 1) + NOISE_PRIME2 * (indexBelowZ + 1)));
+            noiseSW = Get1dNoiseUintLanes(_mm_add_epi32(indexWestX, rowSouthAbove), seed);
+            noiseSE = Get1dNoiseUintLanes(_mm_add_epi32(indexEastX, rowSouthAbove), seed);
+            noiseNW = Get1dNoiseUintLanes(_mm_add_epi32(indexWestX, rowNorthAbove), seed);
+            noiseNE = Get1dNoiseUintLanes(_mm_add_epi32(indexEastX, rowNorthAbove), seed);
+            if (!isPerlin) {
+                valueSW = GetNoiseScaledLanes(noiseSW, ONE_OVER_MAX_UINT);
+                valueSE = GetNoiseScaledLanes(noiseSE, ONE_OVER_MAX_UINT);
+                valueNW = GetNoiseScaledLanes(noiseNW, ONE_OVER_MAX_UINT);
+                valueNE = GetNoiseScaledLanes(noiseNE, ONE_OVER_MAX_UINT);
+            }
+            else {
+                valueSW = DotPerlinGradient3dLanes(noiseSW, displacementWestX, displacementSouthY, displacementAboveZ);
+                valueSE = DotPerlinGradient3dLanes(noiseSE, displacementEastX, displacementSouthY, displacementAboveZ);
+                valueNW = DotPerlinGradient3dLanes(noiseNW, displacementWestX, displacementNorthY, displacementAboveZ);
+                valueNE = DotPerlinGradient3dLanes(noiseNE, displacementEastX, displacementNorthY, displacementAboveZ);
+            }
+            __m128 blendAboveSouth = BlendLanes(weightEast, valueSE, weightWest, valueSW);
+            __m128 blendAboveNorth = BlendLanes(weightEast, valueNE, weightWest, valueNW);
+            __m128 blendAbove = BlendLanes(_mm_set1_ps(weightSouth), blendAboveSouth, _mm_set1_ps(weightNorth), blendAboveNorth);
+            float weightAbove = SmoothStep3(displacementBelowZ);
+            float weightBelow = 1.f - weightAbove;
+            blendTotal = BlendLanes(_mm_set1_ps(weightBelow), blendTotal, _mm_set1_ps(weightAbove), blendAbove);
+        }
+
+        __m128 noiseThisOctave;
+        switch (settings.type) {
+        case NOISE_GRID_PERLIN_2D:
+            noiseThisOctave = _mm_mul_ps(blendTotal, _mm_set1_ps(1.f / 0.662578106f));
+            break;
+        case NOISE_GRID_PERLIN_3D:
+            noiseThisOctave = _mm_mul_ps(blendTotal, _mm_set1_ps(1.f / 0.793856621f));
+            break;
+        default:
+            noiseThisOctave = _mm_mul_ps(_mm_set1_ps(2.f), _mm_sub_ps(blendTotal, _mm_set1_ps(0.5f)));
+            break;
+        }
+
+        totalNoise = _mm_add_ps(totalNoise, _mm_mul_ps(noiseThisOctave, _mm_set1_ps(currentAmplitude)));
+        currentAmplitude *= settings.octavePersistence;
+        currentX = _mm_add_ps(_mm_mul_ps(currentX, _mm_set1_ps(settings.octaveScale)), _mm_set1_ps(OCTAVE_OFFSET));
+        currentY *= settings.octaveScale;
+        currentY += OCTAVE_OFFSET;
+        currentZ *= settings.octaveScale;
+        currentZ += OCTAVE_OFFSET;
+        seed++;
+    }
+
+    return RenormalizeLanes(totalNoise, settings);
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+static void FillNoiseRows(void* context, int participantIndex, int rowBegin, int rowEnd)
+{
+    UNUSED(participantIndex);
+    NoiseGridSettings const& settings = *(NoiseGridSettings const*)context;
+    int const width = settings.width;
+    for (int rowIdx = rowBegin; rowIdx < rowEnd; rowIdx++) {
+        float posY = settings.origin.y + settings.step.y * (float)(rowIdx % settings.height);
+        float posZ = settings.origin.z + settings.step.z * (float)(rowIdx / settings.height);
+        float* rowNoise = settings.outNoise + (size_t)rowIdx * (size_t)width;
+#if defined(MATH_SIMD_SSE)
+        __m128i const laneOffsets = _mm_setr_epi32(0, 1, 2, 3);
+        __m128 const originX = _mm_set1_ps(settings.origin.x);
+        __m128 const stepX = _mm_set1_ps(settings.step.x);
+        for (int x = 0; x < width; x += 4) {
+            __m128 indexX = _mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32(x), laneOffsets));
+            __m128 noise = ComputeNoiseLanes(settings, _mm_add_ps(originX, _mm_mul_ps(stepX, indexX)), posY, posZ);
+            if (x + 4 <= width) {
+                _mm_storeu_ps(rowNoise + x, noise);
+                continue;
+            }
+
+            //row tail, the extra lanes were computed past the end and are dropped
+            float lanes[4];
+            _mm_storeu_ps(lanes, noise);
+            for (int laneIdx = 0; laneIdx < width - x; laneIdx++) {
+                rowNoise[x + laneIdx] = lanes[laneIdx];
+            }
+        }
+#else
+        for (int x = 0; x < width; x++) {
+            rowNoise[x] = ComputeNoiseSample(settings, settings.origin.x + settings.step.x * (float)x, posY, posZ);
+        }
+#endif
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+static void FillNoiseGrid(NoiseGridSettings& settings, int depth)
+{
+    if (settings.width <= 0 || settings.height <= 0 || depth <= 0) {
+        return;
+    }
+
+    float currentAmplitude = 1.f;
+    for (unsigned int octaveNum = 0; octaveNum < settings.numOctaves; octaveNum++) {
+        settings.totalAmplitude += currentAmplitude;
+        currentAmplitude *= settings.octavePersistence;
+    }
+
+    int grainRows = NOISE_GRID_GRAIN_SAMPLES / settings.width;
+    ParallelForRanges(0, settings.height * depth, grainRows, FillNoiseRows, &settings);
+}
+
+//////////////////////////////////////////////////////////////////////////
+static NoiseGridSettings MakeNoiseGridSettings(eNoiseGridType type, float* outNoise, Vec3 const& origin, Vec3 const& step, int width, int height,
+    float scale, unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed)
+{
+    NoiseGridSettings settings;
+    settings.type = type;
+    settings.outNoise = outNoise;
+    settings.origin = origin;
+    settings.step = step;
+    settings.width = width;
+    settings.height = height;
+    settings.scale = scale;
+    settings.numOctaves = numOctaves;
+    settings.octavePersistence = octavePersistence;
+    settings.octaveScale = octaveScale;
+    settings.renormalize = renormalize;
+    settings.seed = seed;
+    return settings;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Fill2dFractalNoise(float* outNoise, Vec2 const& origin, Vec2 const& step, int width, int height,
+    float scale, unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed)
+{
+    NoiseGridSettings settings = MakeNoiseGridSettings(NOISE_GRID_FRACTAL_2D, outNoise, Vec3(origin), Vec3(step), width, height,
+        scale, numOctaves, octavePersistence, octaveScale, renormalize, seed);
+    FillNoiseGrid(settings, 1);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Fill2dPerlinNoise(float* outNoise, Vec2 const& origin, Vec2 const& step, int width, int height,
+    float scale, unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed)
+{
+    NoiseGridSettings settings = MakeNoiseGridSettings(NOISE_GRID_PERLIN_2D, outNoise, Vec3(origin), Vec3(step), width, height,
+        scale, numOctaves, octavePersistence, octaveScale, renormalize, seed);
+    FillNoiseGrid(settings, 1);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Fill3dFractalNoise(float* outNoise, Vec3 const& origin, Vec3 const& step, int width, int height, int depth,
+    float scale, unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed)
+{
+    NoiseGridSettings settings = MakeNoiseGridSettings(NOISE_GRID_FRACTAL_3D, outNoise, origin, step, width, height,
+        scale, numOctaves, octavePersistence, octaveScale, renormalize, seed);
+    FillNoiseGrid(settings, depth);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Fill3dPerlinNoise(float* outNoise, Vec3 const& origin, Vec3 const& step, int width, int height, int depth,
+    float scale, unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed)
+{
+    NoiseGridSettings settings = MakeNoiseGridSettings(NOISE_GRID_PERLIN_3D, outNoise, origin, step, width, height,
+        scale, numOctaves, octavePersistence, octaveScale, renormalize, seed);
+    FillNoiseGrid(settings, depth);
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+struct Vec2;
+struct Vec3;
+
+//////////////////////////////////////////////////////////////////////////
+// whole grids of SmoothNoise in one call, for terrain and textures that
+// would otherwise call Compute*Noise once per vertex. Output is row major,
+// x fastest then y then z. Sample (x, y, z) is the per sample function at
+// origin + step * (x, y, z), computed as origin.x + step.x * (float)x.
+// SSE builds evaluate four samples of a row at once and match the per
+// sample functions bit for bit, other builds call them directly. Large
+// grids are split by rows across JOB_GENERAL workers
+void Fill2dFractalNoise(float* outNoise, Vec2 const& origin, Vec2 const& step, int width, int height,
+    float scale = 1.f, unsigned int numOctaves = 1, float octavePersistence = 0.5f, float octaveScale = 2.f, bool renormalize = true, unsigned int seed = 0);
+void Fill2dPerlinNoise(float* outNoise, Vec2 const& origin, Vec2 const& step, int width, int height,
+    float scale = 1.f, unsigned int numOctaves = 1, float octavePersistence = 0.5f, float octaveScale = 2.f, bool renormalize = true, unsigned int seed = 0);
+void Fill3dFractalNoise(float* outNoise, Vec3 const& origin, Vec3 const& step, int width, int height, int depth,
+    float scale = 1.f, unsigned int numOctaves = 1, float octavePersistence = 0.5f, float octaveScale = 2.f, bool renormalize = true, unsigned int seed = 0);
+void Fill3dPerlinNoise(float* outNoise, Vec3 const& origin, Vec3 const& step, int width, int height, int depth,
+    float scale = 1.f, unsigned int numOctaves = 1, float octavePersistence = 0.5f, float octaveScale = 2.f, bool renormalize = true, unsigned int seed = 0);
@@ -1,9 +1,119 @@
 #include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Engine/Math/RawNoise.hpp"
+#include "Engine/Math/RawNoiseSimd.hpp"
+#include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/Vec2.hpp"
 #include "Engine/Math/Vec3.hpp"
+#include <math.h>
 #include <stdlib.h>
 
+static constexpr double ONE_OVER_MAX_UINT = (1.0 / (double)0xFFFFFFFF);
+static constexpr double ONE_OVER_MAX_UINT_ONE = (1.0 / ((double)0xFFFFFFFF + 1.0));
+
+//taylor terms, exact to float precision within +-45 degrees
+static constexpr float SIN_TERM3 = -1.f / 6.f;
+static constexpr float SIN_TERM5 = 1.f / 120.f;
+static constexpr float SIN_TERM7 = -1.f / 5040.f;
+static constexpr float SIN_TERM9 = 1.f / 362880.f;
+static constexpr float COS_TERM2 = -1.f / 2.f;
+static constexpr float COS_TERM4 = 1.f / 24.f;
+static constexpr float COS_TERM6 = -1.f / 720.f;
+static constexpr float COS_TERM8 = 1.f / 40320.f;
+
+//////////////////////////////////////////////////////////////////////////
+// cos and sin of the nearest quarter turn offset by at most 45 degrees.
+// The batch fills use this for every item so the SSE lanes and the
+// leftovers agree, CosSinDegreesLanes does the same operations in order
+static void GetCosSinDegrees( float degrees, float& outCos, float& outSin )
+{
+	float quarterTurns = degrees * (1.f / 90.f);
+	float nearestQuarter = floorf(quarterTurns + .5f);
+	int quadrant = (int)nearestQuarter;
+	float radians = (quarterTurns - nearestQuarter) * fHalf_PI;
+	float radiansSquared = radians * radians;
+	float sinValue = radians * (1.f + radiansSquared * (SIN_TERM3 + radiansSquared * (SIN_TERM5 + radiansSquared * (SIN_TERM7 + radiansSquared * SIN_TERM9))));
+	float cosValue = 1.f + radiansSquared * (COS_TERM2 + radiansSquared * (COS_TERM4 + radiansSquared * (COS_TERM6 + radiansSquared * COS_TERM8)));
+
+	//rotate by the quadrant, (c,s) (-s,c) (-c,-s) (s,-c). Indexed and
+	//multiplied rather than branched, the quadrants are random
+	float const values[2] = { cosValue, sinValue };
+	float const signs[2] = { 1.f, -1.f };
+	int isSwapped = quadrant & 1;
+	outCos = signs[((quadrant + 1) >> 1) & 1] * values[isSwapped];
+	outSin = signs[(quadrant >> 1) & 1] * values[isSwapped ^ 1];
+}
+
+#if defined(MATH_SIMD_SSE)
+//////////////////////////////////////////////////////////////////////////
+static void CosSinDegreesLanes( __m128 degrees, __m128& outCos, __m128& outSin )
+{
+	__m128 quarterTurns = _mm_mul_ps(degrees, _mm_set1_ps(1.f / 90.f));
+	__m128i quadrants;
+	__m128 nearestQuarter = FloorLanes(_mm_add_ps(quarterTurns, _mm_set1_ps(.5f)), quadrants);
+	__m128 radians = _mm_mul_ps(_mm_sub_ps(quarterTurns, nearestQuarter), _mm_set1_ps(fHalf_PI));
+	__m128 radiansSquared = _mm_mul_ps(radians, radians);
+
+	__m128 sinValues = _mm_add_ps(_mm_set1_ps(SIN_TERM7), _mm_mul_ps(radiansSquared, _mm_set1_ps(SIN_TERM9)));
+	sinValues = _mm_add_ps(_mm_set1_ps(SIN_TERM5), _mm_mul_ps(radiansSquared, sinValues));
+	sinValues = _mm_add_ps(_mm_set1_ps(SIN_TERM3), _mm_mul_ps(radiansSquared, sinValues));
+	sinValues = _mm_mul_ps(radians, _mm_add_ps(_mm_set1_ps(1.f), _mm_mul_ps(radiansSquared, sinValues)));
+	__m128 cosValues = _mm_add_ps(_mm_set1_ps(COS_TERM6), _mm_mul_ps(radiansSquared, _mm_set1_ps(COS_TERM8)));
+	cosValues = _mm_add_ps(_mm_set1_ps(COS_TERM4), _mm_mul_ps(radiansSquared, cosValues));
+	cosValues = _mm_add_ps(_mm_set1_ps(COS_TERM2), _mm_mul_ps(radiansSquared, cosValues));
+	cosValues = _mm_add_ps(_mm_set1_ps(1.f), _mm_mul_ps(radiansSquared, cosValues));
+
+	__m128 isSwapped = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrants, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+	__m128 swappedCos = _mm_or_ps(_mm_and_ps(isSwapped, sinValues), _mm_andnot_ps(isSwapped, cosValues));
+	__m128 swappedSin = _mm_or_ps(_mm_and_ps(isSwapped, cosValues), _mm_andnot_ps(isSwapped, sinValues));
+	//quadrant bit 1 moved up to the float sign bit
+	__m128i cosSigns = _mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrants, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30);
+	__m128i sinSigns = _mm_slli_epi32(_mm_and_si128(quadrants, _mm_set1_epi32(2)), 30);
+	outCos = _mm_xor_ps(swappedCos, _mm_castsi128_ps(cosSigns));
+	outSin = _mm_xor_ps(swappedSin, _mm_castsi128_ps(sinSigns));
+}
+
+//////////////////////////////////////////////////////////////////////////
+// the next four rolls, lane order is roll order
+static __m128 RollZeroToAlmostOneLanes( unsigned int& inOutPosition, unsigned int seed )
+{
+	__m128i positions = _mm_add_epi32(_mm_set1_epi32((int)inOutPosition), _mm_setr_epi32(0, 1, 2, 3));
+	inOutPosition += 4;
+	return GetNoiseScaledLanes(Get1dNoiseUintLanes(positions, seed), ONE_OVER_MAX_UINT_ONE);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// the next eight rolls split into the first and second roll of four items
+static void RollPairsZeroToAlmostOneLanes( unsigned int& inOutPosition, unsigned int seed, __m128& outFirsts, __m128& outSeconds )
+{
+	__m128 rollsA = RollZeroToAlmostOneLanes(inOutPosition, seed);
+	__m128 rollsB = RollZeroToAlmostOneLanes(inOutPosition, seed);
+	outFirsts = _mm_shuffle_ps(rollsA, rollsB, _MM_SHUFFLE(2, 0, 2, 0));
+	outSeconds = _mm_shuffle_ps(rollsA, rollsB, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+//////////////////////////////////////////////////////////////////////////
+static void StoreVec2Lanes( Vec2* outVecs, __m128 xs, __m128 ys )
+{
+	float* outFloats = &outVecs->x;
+	_mm_storeu_ps(outFloats, _mm_unpacklo_ps(xs, ys));
+	_mm_storeu_ps(outFloats + 4, _mm_unpackhi_ps(xs, ys));
+}
+
+//////////////////////////////////////////////////////////////////////////
+static void StoreVec3Lanes( Vec3* outVecs, __m128 xs, __m128 ys, __m128 zs )
+{
+	alignas(16) float laneXs[4];
+	alignas(16) float laneYs[4];
+	alignas(16) float laneZs[4];
+	_mm_store_ps(laneXs, xs);
+	_mm_store_ps(laneYs, ys);
+	_mm_store_ps(laneZs, zs);
+	for( int laneIdx = 0; laneIdx < 4; laneIdx++ ) {
+		outVecs[laneIdx] = Vec3(laneXs[laneIdx], laneYs[laneIdx], laneZs[laneIdx]);
+	}
+}
+#endif
+
 //////////////////////////////////////////////////////////////////////////
 int RandomNumberGenerator::RollRandomIntLessThan( int maxNotInclusive )
 {
@@ -32,7 +142,6 @@ float RandomNumberGenerator::RollRandomFloatZeroToOneInclusive()
 //////////////////////////////////////////////////////////////////////////
 float RandomNumberGenerator::RollRandomFloatZeroToAlmostOne()
 {
-	constexpr double ONE_OVER_MAX_UINT_ONE = (1.0 / ((double)0xFFFFFFFF + 1.0));
 	return (float)(ONE_OVER_MAX_UINT_ONE * (double)Get1dNoiseUint( m_position++, m_seed ));
 }
 
@@ -69,6 +178,147 @@ Vec3 RandomNumberGenerator::RollRandomDirection3D()
 	return Vec3(thetaValue.x * phitaValue.x, phitaValue.y, thetaValue.y * phitaValue.x);
 }
 
+//////////////////////////////////////////////////////////////////////////
+void RandomNumberGenerator::FillRandomFloatsInRange( float* outFloats, int count, float minInclusive, float maxInclusive )
+{
+	float range = maxInclusive - minInclusive;
+	int floatIdx = 0;
+#if defined(MATH_SIMD_SSE)
+	__m128 const ranges = _mm_set1_ps(range);
+	__m128 const mins = _mm_set1_ps(minInclusive);
+	for( ; floatIdx + 4 <= count; floatIdx += 4 ) {
+		__m128i positions = _mm_add_epi32(_mm_set1_epi32((int)m_position), _mm_setr_epi32(0, 1, 2, 3));
+		m_position += 4;
+		__m128 zeroToOnes = GetNoiseScaledLanes(Get1dNoiseUintLanes(positions, m_seed), ONE_OVER_MAX_UINT);
+		_mm_storeu_ps(outFloats + floatIdx, _mm_add_ps(_mm_mul_ps(zeroToOnes, ranges), mins));
+	}
+#endif
+	for( ; floatIdx < count; floatIdx++ ) {
+		outFloats[floatIdx] = RollRandomFloatZeroToOneInclusive() * range + minInclusive;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void RandomNumberGenerator::FillRandomDirections2D( Vec2* outDirections, int count )
+{
+	int directionIdx = 0;
+#if defined(MATH_SIMD_SSE)
+	for( ; directionIdx + 4 <= count; directionIdx += 4 ) {
+		__m128 degrees = _mm_mul_ps(_mm_set1_ps(360.f), RollZeroToAlmostOneLanes(m_position, m_seed));
+		__m128 cosValues;
+		__m128 sinValues;
+		CosSinDegreesLanes(degrees, cosValues, sinValues);
+		StoreVec2Lanes(outDirections + directionIdx, cosValues, sinValues);
+	}
+#endif
+	for( ; directionIdx < count; directionIdx++ ) {
+		Vec2& direction = outDirections[directionIdx];
+		GetCosSinDegrees(RollRandomFloatLessThan(360.f), direction.x, direction.y);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void RandomNumberGenerator::FillRandomDirections3D( Vec3* outDirections, int count )
+{
+	int directionIdx = 0;
+#if defined(MATH_SIMD_SSE)
+	for( ; directionIdx + 4 <= count; directionIdx += 4 ) {
+		__m128 thetaRolls;
+		__m128 phitaRolls;
+		RollPairsZeroToAlmostOneLanes(m_position, m_seed, thetaRolls, phitaRolls);
+		__m128 thetaCos;
+		__m128 thetaSin;
+		__m128 phitaCos;
+		__m128 phitaSin;
+		CosSinDegreesLanes(_mm_mul_ps(_mm_set1_ps(360.f), thetaRolls), thetaCos, thetaSin);
+		CosSinDegreesLanes(_mm_sub_ps(_mm_mul_ps(_mm_set1_ps(180.f), phitaRolls), _mm_set1_ps(90.f)), phitaCos, phitaSin);
+		StoreVec3Lanes(outDirections + directionIdx, _mm_mul_ps(thetaCos, phitaCos), phitaSin, _mm_mul_ps(thetaSin, phitaCos));
+	}
+#endif
+	for( ; directionIdx < count; directionIdx++ ) {
+		float theta = RollRandomFloatLessThan(360.f);
+		float phita = RollRandomFloatLessThan(180.f) - 90.f;
+		Vec2 thetaValue;
+		Vec2 phitaValue;
+		GetCosSinDegrees(theta, thetaValue.x, thetaValue.y);
+		GetCosSinDegrees(phita, phitaValue.x, phitaValue.y);
+		outDirections[directionIdx] = Vec3(thetaValue.x * phitaValue.x, phitaValue.y, thetaValue.y * phitaValue.x);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// angle roll then area roll, the sqrt keeps points from bunching at the center
+void RandomNumberGenerator::FillRandomPointsInDisc( Vec2* outPoints, int count, Vec2 const& center, float radius )
+{
+	int pointIdx = 0;
+#if defined(MATH_SIMD_SSE)
+	for( ; pointIdx + 4 <= count; pointIdx += 4 ) {
+		__m128 angleRolls;
+		__m128 areaRolls;
+		RollPairsZeroToAlmostOneLanes(m_position, m_seed, angleRolls, areaRolls);
+		__m128 cosValues;
+		__m128 sinValues;
+		CosSinDegreesLanes(_mm_mul_ps(_mm_set1_ps(360.f), angleRolls), cosValues, sinValues);
+		__m128 distances = _mm_mul_ps(_mm_set1_ps(radius), _mm_sqrt_ps(areaRolls));
+		StoreVec2Lanes(outPoints + pointIdx, _mm_add_ps(_mm_set1_ps(center.x), _mm_mul_ps(distances, cosValues)),
+			_mm_add_ps(_mm_set1_ps(center.y), _mm_mul_ps(distances, sinValues)));
+	}
+#endif
+	for( ; pointIdx < count; pointIdx++ ) {
+		float cosValue;
+		float sinValue;
+		GetCosSinDegrees(RollRandomFloatLessThan(360.f), cosValue, sinValue);
+		float distance = radius * sqrtf(RollRandomFloatZeroToAlmostOne());
+		outPoints[pointIdx] = Vec2(center.x + distance * cosValue, center.y + distance * sinValue);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// angle roll then height roll, equal height bands of a sphere have equal area
+void RandomNumberGenerator::FillRandomPointsOnSphere( Vec3* outPoints, int count, Vec3 const& center, float radius )
+{
+	int pointIdx = 0;
+#if defined(MATH_SIMD_SSE)
+	for( ; pointIdx + 4 <= count; pointIdx += 4 ) {
+		__m128 angleRolls;
+		__m128 heightRolls;
+		RollPairsZeroToAlmostOneLanes(m_position, m_seed, angleRolls, heightRolls);
+		__m128 cosValues;
+		__m128 sinValues;
+		CosSinDegreesLanes(_mm_mul_ps(_mm_set1_ps(360.f), angleRolls), cosValues, sinValues);
+		__m128 heights = _mm_sub_ps(_mm_set1_ps(1.f), _mm_mul_ps(_mm_set1_ps(2.f), heightRolls));
+		__m128 ringRadiusSquared = _mm_max_ps(_mm_sub_ps(_mm_set1_ps(1.f), _mm_mul_ps(heights, heights)), _mm_setzero_ps());
+		__m128 ringRadius = _mm_mul_ps(_mm_set1_ps(radius), _mm_sqrt_ps(ringRadiusSquared));
+		StoreVec3Lanes(outPoints + pointIdx, _mm_add_ps(_mm_set1_ps(center.x), _mm_mul_ps(ringRadius, cosValues)),
+			_mm_add_ps(_mm_set1_ps(center.y), _mm_mul_ps(ringRadius, sinValues)),
+			_mm_add_ps(_mm_set1_ps(center.z), _mm_mul_ps(_mm_set1_ps(radius), heights)));
+	}
+#endif
+	for( ; pointIdx < count; pointIdx++ ) {
+		float cosValue;
+		float sinValue;
+		GetCosSinDegrees(RollRandomFloatLessThan(360.f), cosValue, sinValue);
+		float height = 1.f - 2.f * RollRandomFloatZeroToAlmostOne();
+		float ringRadiusSquared = 1.f - height * height;
+		float ringRadius = radius * sqrtf(ringRadiusSquared > 0.f ? ringRadiusSquared : 0.f);
+		outPoints[pointIdx] = Vec3(center.x + ringRadius * cosValue, center.y + ringRadius * sinValue, center.z + radius * height);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void RandomNumberGenerator::Jump( unsigned int rollCount )
+{
+	m_position += rollCount;
+}
+
+//////////////////////////////////////////////////////////////////////////
+RandomNumberGenerator RandomNumberGenerator::Split()
+{
+	RandomNumberGenerator stream = *this;
+	Jump(RNG_SPLIT_STREAM_ROLLS);
+	return stream;
+}
+
 //////////////////////////////////////////////////////////////////////////
 void RandomNumberGenerator::Reset( unsigned int seed /*= 0 */ )
 {
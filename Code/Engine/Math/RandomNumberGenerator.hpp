@@ -16,9 +16,30 @@ public:
 	Vec2  RollRandomDirection2D();
 	Vec3  RollRandomDirection3D();
 
+	// count rolls at once, SSE builds do four at a time. Floats are bit identical to that
+	// many RollRandomFloatInRange calls. Directions use the same rolls as the single
+	// versions with polynomial sin and cos, they agree to float precision
+	void  FillRandomFloatsInRange( float* outFloats, int count, float minInclusive, float maxInclusive );
+	void  FillRandomDirections2D( Vec2* outDirections, int count );
+	void  FillRandomDirections3D( Vec3* outDirections, int count );
+	// uniform over the disc area and the sphere surface, two rolls per point
+	void  FillRandomPointsInDisc( Vec2* outPoints, int count, Vec2 const& center, float radius );
+	void  FillRandomPointsOnSphere( Vec3* outPoints, int count, Vec3 const& center, float radius );
+
+	// a roll is the noise of (position, seed), and another seed only shifts which part of
+	// the same 2^32 long sequence is used, so streams are kept apart by position.
+	// Jump skips rolls, a worker filling items [first, last) of a shared array can Jump
+	// to its first roll and get what one thread would. Split hands out the next
+	// RNG_SPLIT_STREAM_ROLLS rolls as a new generator and jumps past them
+	void  Jump( unsigned int rollCount );
+	RandomNumberGenerator Split();
+
 	void  Reset( unsigned int seed = 0 );
 
 	unsigned int GetSeed() const { return m_seed; }
+	unsigned int GetPosition() const { return m_position; }
+
+	static constexpr unsigned int RNG_SPLIT_STREAM_ROLLS = 1u << 24;	//256 splits before the sequence wraps
 
 private:
 	unsigned int  m_seed = 0;	
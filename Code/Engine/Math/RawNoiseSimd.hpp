@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Engine/Math/MathSimd.hpp"
+
+#if defined(MATH_SIMD_SSE)
+//////////////////////////////////////////////////////////////////////////
+// Get1dNoiseUint of RawNoise.hpp for four positions, bit identical
+inline __m128i Get1dNoiseUintLanes(__m128i positions, unsigned int seed)
+{
+    __m128i mangledBits = MultiplyLanes(positions, _mm_set1_epi32((int)0xd2a80a23));
+    mangledBits = _mm_add_epi32(mangledBits, _mm_set1_epi32((int)seed));
+    mangledBits = _mm_xor_si128(mangledBits, _mm_srli_epi32(mangledBits, 7));
+    mangledBits = _mm_add_epi32(mangledBits, _mm_set1_epi32((int)0xa884f197));
+    mangledBits = _mm_xor_si128(mangledBits, _mm_srli_epi32(mangledBits, 8));
+    mangledBits = MultiplyLanes(mangledBits, _mm_set1_epi32((int)0x1b56c4e9));
+    mangledBits = _mm_xor_si128(mangledBits, _mm_srli_epi32(mangledBits, 11));
+    return mangledBits;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// (float)(scale * (double)noise) per lane, how Get*NoiseZeroToOne and the
+// RandomNumberGenerator rolls map noise to floats. Unsigned to double is
+// the signed conversion with the top bit flipped and added back
+inline __m128 GetNoiseScaledLanes(__m128i noise, double scale)
+{
+    __m128d const topBit = _mm_set1_pd(2147483648.0);
+    __m128d const scales = _mm_set1_pd(scale);
+    __m128i flippedNoise = _mm_xor_si128(noise, _mm_set1_epi32((int)0x80000000));
+    __m128d low = _mm_add_pd(_mm_cvtepi32_pd(flippedNoise), topBit);
+    __m128d high = _mm_add_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(flippedNoise, _MM_SHUFFLE(3, 2, 3, 2))), topBit);
+    return _mm_movelh_ps(_mm_cvtpd_ps(_mm_mul_pd(scales, low)), _mm_cvtpd_ps(_mm_mul_pd(scales, high)));
+}
+#endif
@@ -740,3 +740,310 @@ float Compute4dPerlinNoise( float posX, float posY, float posZ, float posT, floa
 	return totalNoise;
 }
 
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Simplex noise internals: one octave each, mapped to ~[-1,1] like the Perlin octaves above.
+//
+// A sample sums falloff-weighted gradient dots from the corners of the simplex (triangle,
+//	tetrahedron, 5-cell) it falls in, so it touches N+1 corners instead of Perlin's 2^N.  The
+//	simplex is found by skewing space so the simplex grid lines up with the integer grid.
+//	Corner gradients come from the same bit-noise (and seeds) as the Perlin functions.
+//
+// The falloff radius is sqrt(0.5) in every dimension; the 0.6 often used for 3D/4D reaches past
+//	the neighboring simplexes and leaves faint seams.
+/////////////////////////////////////////////////////////////////////////////////////////////////
+constexpr float SIMPLEX_RADIUS_SQUARED = 0.5f;
+
+
+//-----------------------------------------------------------------------------------------------
+static float GetSimplexFalloff( float distanceSquared )
+{
+	float falloff = SIMPLEX_RADIUS_SQUARED - distanceSquared;
+	falloff = 0.5f * (falloff + fabsf( falloff )); // Clamp to 0 without a branch; which corners reach us is random
+	falloff *= falloff;
+	return falloff * falloff; // (r^2 - d^2)^4
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static float ComputeSimplexOctave2d( float posX, float posY, unsigned int seed )
+{
+	const float SKEW = 0.366025403784f;		// (sqrt(3)-1)/2; squashes triangle pairs onto unit squares
+	const float UNSKEW = 0.211324865405f;	// (3-sqrt(3))/6; and back again
+	static const Vec2 gradients[ 8 ] = // Same 8 quarter-cardinal unit vectors as 2D Perlin
+	{
+		Vec2( +0.923879533f, +0.382683432f ),
+		Vec2( +0.382683432f, +0.923879533f ),
+		Vec2( -0.382683432f, +0.923879533f ),
+		Vec2( -0.923879533f, +0.382683432f ),
+		Vec2( -0.923879533f, -0.382683432f ),
+		Vec2( -0.382683432f, -0.923879533f ),
+		Vec2( +0.382683432f, -0.923879533f ),
+		Vec2( +0.923879533f, -0.382683432f )
+	};
+
+	// Find the skewed unit square, then which of its two triangles we are in
+	float skew = (posX + posY) * SKEW;
+	float cellX = floorf( posX + skew );
+	float cellY = floorf( posY + skew );
+	float unskew = (cellX + cellY) * UNSKEW;
+	Vec2 displacement0( posX - (cellX - unskew), posY - (cellY - unskew) );
+	int stepX = (int) (displacement0.x > displacement0.y);	// Lower triangle steps east first,
+	int stepY = 1 - stepX;									//	upper triangle steps north first
+
+	Vec2 displacement1( displacement0.x - (float) stepX + UNSKEW, displacement0.y - (float) stepY + UNSKEW );
+	Vec2 displacement2( displacement0.x - 1.f + 2.f * UNSKEW, displacement0.y - 1.f + 2.f * UNSKEW );
+
+	int indexX = (int) cellX;
+	int indexY = (int) cellY;
+	const Vec2& gradient0 = gradients[ Get2dNoiseUint( indexX, indexY, seed ) & 0x00000007 ];
+	const Vec2& gradient1 = gradients[ Get2dNoiseUint( indexX + stepX, indexY + stepY, seed ) & 0x00000007 ];
+	const Vec2& gradient2 = gradients[ Get2dNoiseUint( indexX + 1, indexY + 1, seed ) & 0x00000007 ];
+
+	float total = GetSimplexFalloff( displacement0.GetLengthSquared() ) * DotProduct2D( gradient0, displacement0 );
+	total += GetSimplexFalloff( displacement1.GetLengthSquared() ) * DotProduct2D( gradient1, displacement1 );
+	total += GetSimplexFalloff( displacement2.GetLengthSquared() ) * DotProduct2D( gradient2, displacement2 );
+	return total * (1.f / 0.009996f); // 2D simplex is in [-.009996,.009996]; map to ~[-1,1]
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static float ComputeSimplexOctave3d( float posX, float posY, float posZ, unsigned int seed )
+{
+	const float SKEW = 1.f / 3.f;
+	const float UNSKEW = 1.f / 6.f;
+	static const Vec3 gradients[ 16 ] = // The 12 cube edges, 4 of them twice to get a power of two
+	{
+		Vec3( +fSQRT_2_OVER_2, +fSQRT_2_OVER_2, 0.f ), Vec3( -fSQRT_2_OVER_2, +fSQRT_2_OVER_2, 0.f ),
+		Vec3( +fSQRT_2_OVER_2, -fSQRT_2_OVER_2, 0.f ), Vec3( -fSQRT_2_OVER_2, -fSQRT_2_OVER_2, 0.f ),
+		Vec3( +fSQRT_2_OVER_2, 0.f, +fSQRT_2_OVER_2 ), Vec3( -fSQRT_2_OVER_2, 0.f, +fSQRT_2_OVER_2 ),
+		Vec3( +fSQRT_2_OVER_2, 0.f, -fSQRT_2_OVER_2 ), Vec3( -fSQRT_2_OVER_2, 0.f, -fSQRT_2_OVER_2 ),
+		Vec3( 0.f, +fSQRT_2_OVER_2, +fSQRT_2_OVER_2 ), Vec3( 0.f, -fSQRT_2_OVER_2, +fSQRT_2_OVER_2 ),
+		Vec3( 0.f, +fSQRT_2_OVER_2, -fSQRT_2_OVER_2 ), Vec3( 0.f, -fSQRT_2_OVER_2, -fSQRT_2_OVER_2 ),
+		Vec3( +fSQRT_2_OVER_2, +fSQRT_2_OVER_2, 0.f ), Vec3( -fSQRT_2_OVER_2, +fSQRT_2_OVER_2, 0.f ),
+		Vec3( 0.f, -fSQRT_2_OVER_2, +fSQRT_2_OVER_2 ), Vec3( 0.f, -fSQRT_2_OVER_2, -fSQRT_2_OVER_2 )
+	};
+
+	// Find the skewed unit cube; its six tetrahedra are the six orderings of the axes
+	float skew = (posX + posY + posZ) * SKEW;
+	float cellX = floorf( posX + skew );
+	float cellY = floorf( posY + skew );
+	float cellZ = floorf( posZ + skew );
+	float unskew = (cellX + cellY + cellZ) * UNSKEW;
+	Vec3 displacement0( posX - (cellX - unskew), posY - (cellY - unskew), posZ - (cellZ - unskew) );
+
+	// Rank each axis by how far along it we are (2 = furthest); the first corner steps the axis
+	//	ranked 2, the second corner the two ranked >= 1.  Comparisons, not branches (unpredictable)
+	int xAboveY = (int) (displacement0.x > displacement0.y);
+	int xAboveZ = (int) (displacement0.x > displacement0.z);
+	int yAboveZ = (int) (displacement0.y > displacement0.z);
+	int rankX = xAboveY + xAboveZ;
+	int rankY = (1 - xAboveY) + yAboveZ;
+	int rankZ = (1 - xAboveZ) + (1 - yAboveZ);
+	int firstX = rankX >> 1;		// 1 for rank 2
+	int firstY = rankY >> 1;
+	int firstZ = rankZ >> 1;
+	int secondX = (rankX + 1) >> 1;	// 1 for rank 1 or 2
+	int secondY = (rankY + 1) >> 1;
+	int secondZ = (rankZ + 1) >> 1;
+
+	Vec3 displacement1( displacement0.x - (float) firstX + UNSKEW, displacement0.y - (float) firstY + UNSKEW, displacement0.z - (float) firstZ + UNSKEW );
+	Vec3 displacement2( displacement0.x - (float) secondX + 2.f * UNSKEW, displacement0.y - (float) secondY + 2.f * UNSKEW, displacement0.z - (float) secondZ + 2.f * UNSKEW );
+	Vec3 displacement3( displacement0.x - 1.f + 3.f * UNSKEW, displacement0.y - 1.f + 3.f * UNSKEW, displacement0.z - 1.f + 3.f * UNSKEW );
+
+	int indexX = (int) cellX;
+	int indexY = (int) cellY;
+	int indexZ = (int) cellZ;
+	const Vec3& gradient0 = gradients[ Get3dNoiseUint( indexX, indexY, indexZ, seed ) & 0x0000000f ];
+	const Vec3& gradient1 = gradients[ Get3dNoiseUint( indexX + firstX, indexY + firstY, indexZ + firstZ, seed ) & 0x0000000f ];
+	const Vec3& gradient2 = gradients[ Get3dNoiseUint( indexX + secondX, indexY + secondY, indexZ + secondZ, seed ) & 0x0000000f ];
+	const Vec3& gradient3 = gradients[ Get3dNoiseUint( indexX + 1, indexY + 1, indexZ + 1, seed ) & 0x0000000f ];
+
+	float total = GetSimplexFalloff( displacement0.GetLengthSquared() ) * DotProduct3D( gradient0, displacement0 );
+	total += GetSimplexFalloff( displacement1.GetLengthSquared() ) * DotProduct3D( gradient1, displacement1 );
+	total += GetSimplexFalloff( displacement2.GetLengthSquared() ) * DotProduct3D( gradient2, displacement2 );
+	total += GetSimplexFalloff( displacement3.GetLengthSquared() ) * DotProduct3D( gradient3, displacement3 );
+	return total * (1.f / 0.009198f); // 3D simplex is in [-.009198,.009198]; map to ~[-1,1]
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static float ComputeSimplexOctave4d( float posX, float posY, float posZ, float posT, unsigned int seed )
+{
+	const float SKEW = 0.309016994375f;		// (sqrt(5)-1)/4
+	const float UNSKEW = 0.138196601125f;	// (5-sqrt(5))/20
+	const float C = fSQRT_3_OVER_3;
+	static const Vec4 gradients[ 32 ] = // Toward the middles of the 32 cubes bounding the hypercube,
+	{									//	i.e. (0,+-1,+-1,+-1)/sqrt(3) with the zero on each axis
+		Vec4( 0.f, +C, +C, +C ), Vec4( 0.f, -C, +C, +C ), Vec4( 0.f, +C, -C, +C ), Vec4( 0.f, -C, -C, +C ),
+		Vec4( 0.f, +C, +C, -C ), Vec4( 0.f, -C, +C, -C ), Vec4( 0.f, +C, -C, -C ), Vec4( 0.f, -C, -C, -C ),
+		Vec4( +C, 0.f, +C, +C ), Vec4( -C, 0.f, +C, +C ), Vec4( +C, 0.f, -C, +C ), Vec4( -C, 0.f, -C, +C ),
+		Vec4( +C, 0.f, +C, -C ), Vec4( -C, 0.f, +C, -C ), Vec4( +C, 0.f, -C, -C ), Vec4( -C, 0.f, -C, -C ),
+		Vec4( +C, +C, 0.f, +C ), Vec4( -C, +C, 0.f, +C ), Vec4( +C, -C, 0.f, +C ), Vec4( -C, -C, 0.f, +C ),
+		Vec4( +C, +C, 0.f, -C ), Vec4( -C, +C, 0.f, -C ), Vec4( +C, -C, 0.f, -C ), Vec4( -C, -C, 0.f, -C ),
+		Vec4( +C, +C, +C, 0.f ), Vec4( -C, +C, +C, 0.f ), Vec4( +C, -C, +C, 0.f ), Vec4( -C, -C, +C, 0.f ),
+		Vec4( +C, +C, -C, 0.f ), Vec4( -C, +C, -C, 0.f ), Vec4( +C, -C, -C, 0.f ), Vec4( -C, -C, -C, 0.f )
+	};
+
+	// Find the skewed unit hypercube; its 24 simplexes are the 24 orderings of the axes
+	float skew = (posX + posY + posZ + posT) * SKEW;
+	float cellX = floorf( posX + skew );
+	float cellY = floorf( posY + skew );
+	float cellZ = floorf( posZ + skew );
+	float cellT = floorf( posT + skew );
+	float unskew = (cellX + cellY + cellZ + cellT) * UNSKEW;
+	Vec4 displacement0( posX - (cellX - unskew), posY - (cellY - unskew), posZ - (cellZ - unskew), posT - (cellT - unskew) );
+
+	// Rank each axis by how far along it we are (3 = furthest); corner N steps the axes ranked >= 4-N
+	int xAboveY = (int) (displacement0.x > displacement0.y);
+	int xAboveZ = (int) (displacement0.x > displacement0.z);
+	int xAboveT = (int) (displacement0.x > displacement0.w);
+	int yAboveZ = (int) (displacement0.y > displacement0.z);
+	int yAboveT = (int) (displacement0.y > displacement0.w);
+	int zAboveT = (int) (displacement0.z > displacement0.w);
+	int rankX = xAboveY + xAboveZ + xAboveT;
+	int rankY = (1 - xAboveY) + yAboveZ + yAboveT;
+	int rankZ = (1 - xAboveZ) + (1 - yAboveZ) + zAboveT;
+	int rankT = (1 - xAboveT) + (1 - yAboveT) + (1 - zAboveT);
+
+	int indexX = (int) cellX;
+	int indexY = (int) cellY;
+	int indexZ = (int) cellZ;
+	int indexT = (int) cellT;
+	float total = 0.f;
+	for( int cornerNum = 0; cornerNum < 5; ++ cornerNum )
+	{
+		int stepX = (rankX + cornerNum) >> 2; // 1 once rank >= 4 - cornerNum
+		int stepY = (rankY + cornerNum) >> 2;
+		int stepZ = (rankZ + cornerNum) >> 2;
+		int stepT = (rankT + cornerNum) >> 2;
+		float cornerUnskew = (float) cornerNum * UNSKEW;
+		Vec4 displacement( displacement0.x - (float) stepX + cornerUnskew, displacement0.y - (float) stepY + cornerUnskew,
+			displacement0.z - (float) stepZ + cornerUnskew, displacement0.w - (float) stepT + cornerUnskew );
+
+		unsigned int noise = Get4dNoiseUint( indexX + stepX, indexY + stepY, indexZ + stepZ, indexT + stepT, seed );
+		const Vec4& gradient = gradients[ noise & 0x0000001f ];
+		total += GetSimplexFalloff( displacement.GetLengthSquared() ) * DotProduct4D( gradient, displacement );
+	}
+	return total * (1.f / 0.009198f); // 4D simplex is in [-.009198,.009198]; map to ~[-1,1]
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Simplex noise takes the same octave/seed/renormalize parameters as Perlin noise, above.
+//
+float Compute2dSimplexNoise( float posX, float posY, float scale, unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	const float OCTAVE_OFFSET = 0.636764989593174f; // Translation/bias to add to each octave
+
+	float totalNoise = 0.f;
+	float totalAmplitude = 0.f;
+	float currentAmplitude = 1.f;
+	float invScale = (1.f / scale);
+	Vec2 currentPos( posX * invScale, posY * invScale );
+
+	for( unsigned int octaveNum = 0; octaveNum < numOctaves; ++ octaveNum )
+	{
+		float noiseThisOctave = ComputeSimplexOctave2d( currentPos.x, currentPos.y, seed );
+
+		// Accumulate results and prepare for next octave (if any)
+		totalNoise += noiseThisOctave * currentAmplitude;
+		totalAmplitude += currentAmplitude;
+		currentAmplitude *= octavePersistence;
+		currentPos *= octaveScale;
+		currentPos.x += OCTAVE_OFFSET; // Add "irrational" offset to de-align octave grids
+		currentPos.y += OCTAVE_OFFSET; // Add "irrational" offset to de-align octave grids
+		++ seed; // Eliminates octaves "echoing" each other (since each octave is uniquely seeded)
+	}
+
+	// Re-normalize total noise to within [-1,1] and fix octaves pulling us far away from limits
+	if( renormalize && totalAmplitude > 0.f )
+	{
+		totalNoise /= totalAmplitude;				// Amplitude exceeds 1.0 if octaves are used
+		totalNoise = (totalNoise * 0.5f) + 0.5f;	// Map to [0,1]
+		totalNoise = SmoothStep3( totalNoise );		// Push towards extents (octaves pull us away)
+		totalNoise = (totalNoise * 2.0f) - 1.f;		// Map back to [-1,1]
+	}
+
+	return totalNoise;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+float Compute3dSimplexNoise( float posX, float posY, float posZ, float scale, unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	const float OCTAVE_OFFSET = 0.636764989593174f; // Translation/bias to add to each octave
+
+	float totalNoise = 0.f;
+	float totalAmplitude = 0.f;
+	float currentAmplitude = 1.f;
+	float invScale = (1.f / scale);
+	Vec3 currentPos( posX * invScale, posY * invScale, posZ * invScale );
+
+	for( unsigned int octaveNum = 0; octaveNum < numOctaves; ++ octaveNum )
+	{
+		float noiseThisOctave = ComputeSimplexOctave3d( currentPos.x, currentPos.y, currentPos.z, seed );
+
+		// Accumulate results and prepare for next octave (if any)
+		totalNoise += noiseThisOctave * currentAmplitude;
+		totalAmplitude += currentAmplitude;
+		currentAmplitude *= octavePersistence;
+		currentPos *= octaveScale;
+		currentPos.x += OCTAVE_OFFSET; // Add "irrational" offset to de-align octave grids
+		currentPos.y += OCTAVE_OFFSET; // Add "irrational" offset to de-align octave grids
+		currentPos.z += OCTAVE_OFFSET; // Add "irrational" offset to de-align octave grids
+		++ seed; // Eliminates octaves "echoing" each other (since each octave is uniquely seeded)
+	}
+
+	// Re-normalize total noise to within [-1,1] and fix octaves pulling us far away from limits
+	if( renormalize && totalAmplitude > 0.f )
+	{
+		totalNoise /= totalAmplitude;				// Amplitude exceeds 1.0 if octaves are used
+		totalNoise = (totalNoise * 0.5f) + 0.5f;	// Map to [0,1]
+		totalNoise = SmoothStep3( totalNoise );		// Push towards extents (octaves pull us away)
+		totalNoise = (totalNoise * 2.0f) - 1.f;		// Map back to [-1,1]
+	}
+
+	return totalNoise;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+float Compute4dSimplexNoise( float posX, float posY, float posZ, float posT, float scale, unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	const float OCTAVE_OFFSET = 0.636764989593174f; // Translation/bias to add to each octave
+
+	float totalNoise = 0.f;
+	float totalAmplitude = 0.f;
+	float currentAmplitude = 1.f;
+	float invScale = (1.f / scale);
+	Vec4 currentPos( posX * invScale, posY * invScale, posZ * invScale, posT * invScale );
+
+	for( unsigned int octaveNum = 0; octaveNum < numOctaves; ++ octaveNum )
+	{
+		float noiseThisOctave = ComputeSimplexOctave4d( currentPos.x, currentPos.y, currentPos.z, currentPos.w, seed );
+
+		// Accumulate results and prepare for next octave (if any)
+		totalNoise += noiseThisOctave * currentAmplitude;
+		totalAmplitude += currentAmplitude;
+		currentAmplitude *= octavePersistence;
+		currentPos *= octaveScale;
+		currentPos.x += OCTAVE_OFFSET; // Add "irrational" offset to de-align octave grids
+		currentPos.y += OCTAVE_OFFSET; // Add "irrational" offset to de-align octave grids
+		currentPos.z += OCTAVE_OFFSET; // Add "irrational" offset to de-align octave grids
+		currentPos.w += OCTAVE_OFFSET; // Add "irrational" offset to de-align octave grids
+		++ seed; // Eliminates octaves "echoing" each other (since each octave is uniquely seeded)
+	}
+
+	// Re-normalize total noise to within [-1,1] and fix octaves pulling us far away from limits
+	if( renormalize && totalAmplitude > 0.f )
+	{
+		totalNoise /= totalAmplitude;				// Amplitude exceeds 1.0 if octaves are used
+		totalNoise = (totalNoise * 0.5f) + 0.5f;	// Map to [0,1]
+		totalNoise = SmoothStep3( totalNoise );		// Push towards extents (octaves pull us away)
+		totalNoise = (totalNoise * 2.0f) - 1.f;		// Map back to [-1,1]
+	}
+
+	return totalNoise;
+}
@@ -85,14 +85,17 @@ float Compute4dPerlinNoise( float posX, float posY, float posZ, float posT, floa
 // Also, higher-dimensional cross-sections of Simplex noise look different than their lower-
 //	dimensional counterparts, which I dislike.
 //
-// I'm also not empirically certain firsthand (or entirely convinced) that it's actually
-//	that much faster (if at all) in 2D and 3D (my primary use-cases).  Need to test.
+// It only visits N+1 corners per octave instead of Perlin's 2^N, so it pulls ahead as dimensions
+//	go up; run "math_noise_speed_benchmark" in the dev console to compare on your machine.
+//	1D simplex would be identical to 1D Perlin, so there is none.
 //
-// #TODO: Implement simplex noise in 2D, 3D, 4D (1D simplex is identical to 1D Perlin, I think?)
-// #TODO: Test comparative simplex noise implementation in 2D/3D to compare speeds.
+// Parameters are the same as for the Perlin functions above.
 //
+float Compute2dSimplexNoise( float posX, float posY, float scale=1.f, unsigned int numOctaves=1, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+float Compute3dSimplexNoise( float posX, float posY, float posZ, float scale=1.f, unsigned int numOctaves=1, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+float Compute4dSimplexNoise( float posX, float posY, float posZ, float posT, float scale=1.f, unsigned int numOctaves=1, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+
 /////////////////////////////////////////////////////////////////////////////////////////////////
-// WARNING: 3D+ Simplex Noise for texture/image synthesis is protected by U.S. Patent 6,867,776!
+// Note: 3D+ Simplex Noise for texture/image synthesis was protected by U.S. Patent 6,867,776,
+//	which expired in January 2022.
 /////////////////////////////////////////////////////////////////////////////////////////////////
-
-
@@ -0,0 +1,378 @@
+#include "Engine/Physics2D/AABBTree2D.hpp"
+#include "Engine/Physics2D/Collider2D.hpp"
+#include <algorithm>
+#include <cfloat>
+
+//////////////////////////////////////////////////////////////////////////
+static AABB2 GetUnion(AABB2 const& bounds0, AABB2 const& bounds1)
+{
+    AABB2 result = bounds0;
+    result.StretchToIncludeBounds(bounds1);
+    return result;
+}
+
+//////////////////////////////////////////////////////////////////////////
+static float GetPerimeter(AABB2 const& bounds)
+{
+    return 2.f * (bounds.maxs.x - bounds.mins.x + bounds.maxs.y - bounds.mins.y);
+}
+
+//////////////////////////////////////////////////////////////////////////
+AABBTree2D::AABBTree2D(float fatMargin)
+    : m_fatMargin(fatMargin)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
+void AABBTree2D::Update(std::vector<Collider2D*> const& colliders)
+{
+    if (m_proxies.size() < colliders.size()) {
+        m_proxies.resize(colliders.size());
+    }
+
+    for (unsigned int colliderIdx = 0; colliderIdx < (unsigned int)m_proxies.size(); colliderIdx++) {
+        Collider2D const* collider = colliderIdx < colliders.size() ? colliders[colliderIdx] : nullptr;
+        if (collider != nullptr && collider->m_rigidbody == nullptr) {  //not attached yet, no world shape
+            collider = nullptr;
+        }
+
+        Proxy& proxy = m_proxies[colliderIdx];
+        if (proxy.collider != collider) {   //slot emptied or reused
+            if (proxy.leaf != -1) {
+                DestroyProxy(colliderIdx);
+            }
+            if (collider != nullptr) {
+                CreateProxy(colliderIdx, collider, GetColliderBounds(collider));
+            }
+            continue;
+        }
+        if (collider == nullptr) {
+            continue;
+        }
+
+        proxy.tightBounds = GetColliderBounds(collider);
+        Node& leaf = m_nodes[proxy.leaf];
+        if (!leaf.bounds.IsBoundsInside(proxy.tightBounds)) {
+            RemoveLeaf(proxy.leaf);
+            Vec2 margin(m_fatMargin, m_fatMargin);
+            m_nodes[proxy.leaf].bounds = AABB2(proxy.tightBounds.mins - margin, proxy.tightBounds.maxs + margin);
+            InsertLeaf(proxy.leaf);
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void AABBTree2D::FindPairs(std::vector<ColliderPair2D>& outPairs)
+{
+    outPairs.clear();
+    if (m_root == -1) {
+        return;
+    }
+
+    for (unsigned int colliderIdx = 0; colliderIdx < (unsigned int)m_proxies.size(); colliderIdx++) {
+        Proxy const& proxy = m_proxies[colliderIdx];
+        if (proxy.leaf == -1) {
+            continue;
+        }
+
+        size_t firstPair = outPairs.size();
+        m_queryStack.clear();
+        m_queryStack.push_back(m_root);
+        while (!m_queryStack.empty()) {
+            int nodeIdx = m_queryStack.back();
+            m_queryStack.pop_back();
+            Node const& node = m_nodes[nodeIdx];
+            if (!node.bounds.IsBoundsOverlap(proxy.tightBounds)) {
+                continue;
+            }
+
+            if (node.IsLeaf()) {
+                //each pair once, from its lower slot
+                if (node.colliderIdx > colliderIdx && m_proxies[node.colliderIdx].tightBounds.IsBoundsOverlap(proxy.tightBounds)) {
+                    outPairs.emplace_back(colliderIdx, node.colliderIdx);
+                }
+            }
+            else {
+                m_queryStack.push_back(node.child0);
+                m_queryStack.push_back(node.child1);
+            }
+        }
+
+        std::sort(outPairs.begin() + firstPair, outPairs.end(),
+            [](ColliderPair2D const& a, ColliderPair2D const& b) { return a.second < b.second; });
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// queries keep their stack local so scene queries can run on several threads
+template<typename OVERLAP_TEST>
+void AABBTree2D::CollectOverlapping(OVERLAP_TEST const& isOverlapping, std::vector<unsigned int>& outColliderIdxs) const
+{
+    outColliderIdxs.clear();
+    if (m_root == -1) {
+        return;
+    }
+
+    //stack buffer covers any sane tree, a degenerate one spills to the heap
+    int localStack[QUERY_STACK_SIZE];
+    std::vector<int> heapStack;
+    int* stack = localStack;
+    int stackCapacity = QUERY_STACK_SIZE;
+    int stackCount = 0;
+    stack[stackCount++] = m_root;
+    while (stackCount > 0) {
+        Node const& node = m_nodes[stack[--stackCount]];
+        if (!isOverlapping(node.bounds)) {
+            continue;
+        }
+
+        if (node.IsLeaf()) {
+            if (isOverlapping(m_proxies[node.colliderIdx].tightBounds)) {
+                outColliderIdxs.push_back(node.colliderIdx);
+            }
+        }
+        else {
+            if (stackCount + 2 > stackCapacity) {
+                stackCapacity *= 2;
+                if (heapStack.empty()) {
+                    heapStack.assign(localStack, localStack + stackCount);
+                }
+                heapStack.resize(stackCapacity);
+                stack = heapStack.data();
+            }
+            stack[stackCount++] = node.child0;
+            stack[stackCount++] = node.child1;
+        }
+    }
+    std::sort(outColliderIdxs.begin(), outColliderIdxs.end());
+}
+
+//////////////////////////////////////////////////////////////////////////
+void AABBTree2D::Query(AABB2 const& bounds, std::vector<unsigned int>& outColliderIdxs) const
+{
+    CollectOverlapping([&bounds](AABB2 const& nodeBounds) { return nodeBounds.IsBoundsOverlap(bounds); }, outColliderIdxs);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void AABBTree2D::QueryRay(Vec2 const& start, Vec2 const& end, std::vector<unsigned int>& outColliderIdxs) const
+{
+    CollectOverlapping([&start, &end](AABB2 const& nodeBounds) { return DoesSegmentHitBounds(start, end, nodeBounds); }, outColliderIdxs);
+}
+
+//////////////////////////////////////////////////////////////////////////
+int AABBTree2D::GetHeight() const
+{
+    return m_root == -1 ? 0 : m_nodes[m_root].height;
+}
+
+//////////////////////////////////////////////////////////////////////////
+int AABBTree2D::AllocateNode()
+{
+    if (m_freeList == -1) {
+        m_nodes.emplace_back();
+        return (int)m_nodes.size() - 1;
+    }
+
+    int nodeIdx = m_freeList;
+    m_freeList = m_nodes[nodeIdx].parent;
+    m_nodes[nodeIdx] = Node();
+    return nodeIdx;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void AABBTree2D::FreeNode(int nodeIdx)
+{
+    m_nodes[nodeIdx].parent = m_freeList;
+    m_nodes[nodeIdx].height = -1;
+    m_freeList = nodeIdx;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void AABBTree2D::InsertLeaf(int leaf)
+{
+    if (m_root == -1) {
+        m_root = leaf;
+        m_nodes[leaf].parent = -1;
+        return;
+    }
+
+    //walk down to the sibling that grows the total perimeter least
+    AABB2 leafBounds = m_nodes[leaf].bounds;
+    int nodeIdx = m_root;
+    while (!m_nodes[nodeIdx].IsLeaf()) {
+        Node const& node = m_nodes[nodeIdx];
+        float perimeter = GetPerimeter(node.bounds);
+        float combinedPerimeter = GetPerimeter(GetUnion(node.bounds, leafBounds));
+        float newParentCost = 2.f * combinedPerimeter;
+        float inheritedCost = 2.f * (combinedPerimeter - perimeter);
+
+        float childCosts[2];
+        int children[2] = { node.child0, node.child1 };
+        for (int i = 0; i < 2; i++) {
+            Node const& child = m_nodes[children[i]];
+            float childCost = GetPerimeter(GetUnion(child.bounds, leafBounds)) + inheritedCost;
+            if (!child.IsLeaf()) {
+                childCost -= GetPerimeter(child.bounds);
+            }
+            childCosts[i] = childCost;
+        }
+
+        if (newParentCost < childCosts[0] && newParentCost < childCosts[1]) {
+            break;
+        }
+        nodeIdx = childCosts[0] < childCosts[1] ? children[0] : children[1];
+    }
+
+    int sibling = nodeIdx;
+    int oldParent = m_nodes[sibling].parent;
+    int newParent = AllocateNode();
+    m_nodes[newParent].parent = oldParent;
+    m_nodes[newParent].bounds = GetUnion(leafBounds, m_nodes[sibling].bounds);
+    m_nodes[newParent].height = m_nodes[sibling].height + 1;
+    m_nodes[newParent].child0 = sibling;
+    m_nodes[newParent].child1 = leaf;
+    m_nodes[sibling].parent = newParent;
+    m_nodes[leaf].parent = newParent;
+    if (oldParent == -1) {
+        m_root = newParent;
+    }
+    else if (m_nodes[oldParent].child0 == sibling) {
+        m_nodes[oldParent].child0 = newParent;
+    }
+    else {
+        m_nodes[oldParent].child1 = newParent;
+    }
+
+    //refit and rotate up to the root
+    nodeIdx = m_nodes[leaf].parent;
+    while (nodeIdx != -1) {
+        Node& node = m_nodes[nodeIdx];
+        node.height = 1 + std::max(m_nodes[node.child0].height, m_nodes[node.child1].height);
+        node.bounds = GetUnion(m_nodes[node.child0].bounds, m_nodes[node.child1].bounds);
+        Rotate(nodeIdx);
+        nodeIdx = m_nodes[nodeIdx].parent;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void AABBTree2D::RemoveLeaf(int leaf)
+{
+    if (leaf == m_root) {
+        m_root = -1;
+        return;
+    }
+
+    int parent = m_nodes[leaf].parent;
+    int grandParent = m_nodes[parent].parent;
+    int sibling = m_nodes[parent].child0 == leaf ? m_nodes[parent].child1 : m_nodes[parent].child0;
+    FreeNode(parent);
+    m_nodes[sibling].parent = grandParent;
+    if (grandParent == -1) {
+        m_root = sibling;
+        return;
+    }
+
+    if (m_nodes[grandParent].child0 == parent) {
+        m_nodes[grandParent].child0 = sibling;
+    }
+    else {
+        m_nodes[grandParent].child1 = sibling;
+    }
+
+    int nodeIdx = grandParent;
+    while (nodeIdx != -1) {
+        Node& node = m_nodes[nodeIdx];
+        node.height = 1 + std::max(m_nodes[node.child0].height, m_nodes[node.child1].height);
+        node.bounds = GetUnion(m_nodes[node.child0].bounds, m_nodes[node.child1].bounds);
+        nodeIdx = node.parent;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// swaps a child with a grandchild on the other side when that shrinks the
+// summed perimeter of the two inner nodes, keeps query cost low even with
+// huge static leaves where height balancing would make it worse
+void AABBTree2D::Rotate(int nodeIdx)
+{
+    Node& a = m_nodes[nodeIdx];
+    if (a.height < 2) {
+        return;
+    }
+
+    int iB = a.child0;
+    int iC = a.child1;
+    Node& b = m_nodes[iB];
+    Node& c = m_nodes[iC];
+    float perimeterB = b.IsLeaf() ? 0.f : GetPerimeter(b.bounds);
+    float perimeterC = c.IsLeaf() ? 0.f : GetPerimeter(c.bounds);
+
+    //candidates: swap b with one of c's children, or c with one of b's children
+    float bestCost = perimeterB + perimeterC;
+    int bestSwap = -1;
+    float costs[4] = { FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX };
+    if (!c.IsLeaf()) {
+        costs[0] = perimeterB + GetPerimeter(GetUnion(b.bounds, m_nodes[c.child1].bounds));    //b <-> c.child0
+        costs[1] = perimeterB + GetPerimeter(GetUnion(b.bounds, m_nodes[c.child0].bounds));    //b <-> c.child1
+    }
+    if (!b.IsLeaf()) {
+        costs[2] = perimeterC + GetPerimeter(GetUnion(c.bounds, m_nodes[b.child1].bounds));    //c <-> b.child0
+        costs[3] = perimeterC + GetPerimeter(GetUnion(c.bounds, m_nodes[b.child0].bounds));    //c <-> b.child1
+    }
+    for (int swapIdx = 0; swapIdx < 4; swapIdx++) {
+        if (costs[swapIdx] < bestCost) {
+            bestCost = costs[swapIdx];
+            bestSwap = swapIdx;
+        }
+    }
+    if (bestSwap == -1) {
+        return;
+    }
+
+    //child of a moves down into inner, grandchild moves up into a
+    int innerIdx = bestSwap < 2 ? iC : iB;
+    int downIdx = bestSwap < 2 ? iB : iC;
+    Node& inner = m_nodes[innerIdx];
+    int& upSlot = (bestSwap & 1) == 0 ? inner.child0 : inner.child1;
+    int upIdx = upSlot;
+    upSlot = downIdx;
+    if (a.child0 == downIdx) {
+        a.child0 = upIdx;
+    }
+    else {
+        a.child1 = upIdx;
+    }
+    m_nodes[downIdx].parent = innerIdx;
+    m_nodes[upIdx].parent = nodeIdx;
+
+    inner.bounds = GetUnion(m_nodes[inner.child0].bounds, m_nodes[inner.child1].bounds);
+    inner.height = 1 + std::max(m_nodes[inner.child0].height, m_nodes[inner.child1].height);
+    a.height = 1 + std::max(m_nodes[a.child0].height, m_nodes[a.child1].height);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void AABBTree2D::CreateProxy(unsigned int colliderIdx, Collider2D const* collider, AABB2 const& tightBounds)
+{
+    int leaf = AllocateNode();
+    Vec2 margin(m_fatMargin, m_fatMargin);
+    m_nodes[leaf].bounds = AABB2(tightBounds.mins - margin, tightBounds.maxs + margin);
+    m_nodes[leaf].colliderIdx = colliderIdx;
+    InsertLeaf(leaf);
+    m_leafCount++;
+
+    Proxy& proxy = m_proxies[colliderIdx];
+    proxy.collider = collider;
+    proxy.leaf = leaf;
+    proxy.tightBounds = tightBounds;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void AABBTree2D::DestroyProxy(unsigned int colliderIdx)
+{
+    Proxy& proxy = m_proxies[colliderIdx];
+    RemoveLeaf(proxy.leaf);
+    FreeNode(proxy.leaf);
+    m_leafCount--;
+
+    proxy.collider = nullptr;
+    proxy.leaf = -1;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Engine/Physics2D/BroadPhase2D.hpp"
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+// incremental dynamic AABB tree, leaves hold bounds fattened by a margin so
+// a collider is only reinserted once it moved out of them. Kept shallow by
+// perimeter reducing rotations, inserts pick the sibling with the least
+// perimeter growth.
+class AABBTree2D : public BroadPhase2D
+{
+public:
+    explicit AABBTree2D(float fatMargin = .1f);
+    virtual ~AABBTree2D() override {}
+
+    virtual void Update(std::vector<Collider2D*> const& colliders) override;
+    virtual void FindPairs(std::vector<ColliderPair2D>& outPairs) override;
+    virtual void Query(AABB2 const& bounds, std::vector<unsigned int>& outColliderIdxs) const override;
+    virtual void QueryRay(Vec2 const& start, Vec2 const& end, std::vector<unsigned int>& outColliderIdxs) const override;
+
+    int GetHeight() const;
+    int GetLeafCount() const { return m_leafCount; }
+
+private:
+    static constexpr int QUERY_STACK_SIZE = 256;   //on-stack part of a traversal stack, holds at most height + 1 nodes
+
+    struct Node
+    {
+        AABB2 bounds;           //fat for leaves
+        int parent = -1;        //next free node while on the free list
+        int child0 = -1;
+        int child1 = -1;
+        int height = 0;         //leaf 0, free -1
+        unsigned int colliderIdx = 0;
+
+        bool IsLeaf() const { return child0 == -1; }
+    };
+
+    struct Proxy
+    {
+        Collider2D const* collider = nullptr;
+        int leaf = -1;
+        AABB2 tightBounds;
+    };
+
+    int AllocateNode();
+    void FreeNode(int nodeIdx);
+    void InsertLeaf(int leaf);
+    void RemoveLeaf(int leaf);
+    void Rotate(int nodeIdx);
+    void CreateProxy(unsigned int colliderIdx, Collider2D const* collider, AABB2 const& tightBounds);
+    void DestroyProxy(unsigned int colliderIdx);
+    template<typename OVERLAP_TEST>
+    void CollectOverlapping(OVERLAP_TEST const& isOverlapping, std::vector<unsigned int>& outColliderIdxs) const;
+
+private:
+    float m_fatMargin = .1f;
+    std::vector<Node> m_nodes;
+    int m_root = -1;
+    int m_freeList = -1;
+    int m_leafCount = 0;
+    std::vector<Proxy> m_proxies;   //by collider slot
+    std::vector<int> m_queryStack;
+};
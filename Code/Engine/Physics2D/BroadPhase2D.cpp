@@ -0,0 +1,39 @@
+#include "Engine/Physics2D/BroadPhase2D.hpp"
+#include "Engine/Physics2D/Collider2D.hpp"
+#include <algorithm>
+
+//////////////////////////////////////////////////////////////////////////
+AABB2 BroadPhase2D::GetColliderBounds(Collider2D const* collider)
+{
+    Disc2 bounds = collider->GetWorldBounds();
+    Vec2 halfDimensions(bounds.radius, bounds.radius);
+    return AABB2(bounds.center - halfDimensions, bounds.center + halfDimensions);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// slab test, narrows the segment's [0,1] range to the part inside each axis range
+static bool ClipSegmentToSlab(float start, float delta, float slabMin, float slabMax, float& inOutEnter, float& inOutExit)
+{
+    if (delta == 0.f) {
+        return start >= slabMin && start <= slabMax;
+    }
+
+    float inverseDelta = 1.f / delta;
+    float enter = (slabMin - start) * inverseDelta;
+    float exit = (slabMax - start) * inverseDelta;
+    if (enter > exit) {
+        std::swap(enter, exit);
+    }
+    inOutEnter = std::max(inOutEnter, enter);
+    inOutExit = std::min(inOutExit, exit);
+    return inOutEnter <= inOutExit;
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool BroadPhase2D::DoesSegmentHitBounds(Vec2 const& start, Vec2 const& end, AABB2 const& bounds)
+{
+    float enter = 0.f;
+    float exit = 1.f;
+    return ClipSegmentToSlab(start.x, end.x - start.x, bounds.mins.x, bounds.maxs.x, enter, exit) &&
+        ClipSegmentToSlab(start.y, end.y - start.y, bounds.mins.y, bounds.maxs.y, enter, exit);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/Disc2.hpp"
+#include <vector>
+
+class Collider2D;
+
+//////////////////////////////////////////////////////////////////////////
+enum eBroadPhase2DType
+{
+    BROAD_PHASE_ALL_PAIRS,  //every pair goes to narrow phase, O(n^2)
+    BROAD_PHASE_AABB_TREE,
+    BROAD_PHASE_SPATIAL_HASH,   //uniform grid rebuilt every step, for piles of similar sized colliders
+
+    NUM_BROAD_PHASE_TYPES
+};
+
+//////////////////////////////////////////////////////////////////////////
+struct ColliderPair2D
+{
+    unsigned int first = 0;     //slot in Physics2D::m_colliders, first < second
+    unsigned int second = 0;
+
+    ColliderPair2D() = default;
+    ColliderPair2D(unsigned int firstIdx, unsigned int secondIdx) : first(firstIdx), second(secondIdx) {}
+};
+
+//////////////////////////////////////////////////////////////////////////
+// finds colliders whose bounds may overlap before the narrow phase.
+// Pairs come out sorted by (first, second), the order an all pairs loop
+// visits them, so the solver result doesn't depend on the broad phase.
+class BroadPhase2D
+{
+public:
+    virtual ~BroadPhase2D() {}
+
+    virtual void Update(std::vector<Collider2D*> const& colliders) = 0;    //once per step, picks up added, removed and moved colliders
+    virtual void FindPairs(std::vector<ColliderPair2D>& outPairs) = 0;
+    //slots whose bounds as of the last Update overlap, ascending. Const and
+    //without shared scratch, several threads may query between updates
+    virtual void Query(AABB2 const& bounds, std::vector<unsigned int>& outColliderIdxs) const = 0;
+    virtual void QueryRay(Vec2 const& start, Vec2 const& end, std::vector<unsigned int>& outColliderIdxs) const = 0;
+
+    static AABB2 GetColliderBounds(Collider2D const* collider);
+    static bool DoesSegmentHitBounds(Vec2 const& start, Vec2 const& end, AABB2 const& bounds);
+};
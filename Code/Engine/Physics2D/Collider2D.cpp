@@ -10,6 +10,10 @@
 typedef bool (*collision_check_cb)(Collider2D const*, Collider2D const*);
 typedef bool (*manifold_get)(Collider2D const*, Collider2D const*, Manifold2* outManifold);
 
+//exact float compares can cycle on touching or degenerate shapes, give up after this many
+static constexpr int GJK_MAX_ITERATIONS = 32;
+static constexpr int EPA_MAX_ITERATIONS = 32;
+
 //////////////////////////////////////////////////////////////////////////
 static bool DiscVDiscCollisionCheck(Collider2D const* col0, Collider2D const* col1)
 {
@@ -65,7 +69,7 @@ static bool PolygonVPolygonCollisionCheck(Collider2D const* col0, Collider2D con
     simplex[1] = GetSupport(-direction, col0, col1);
     simplex[2] = GetSupport(direction.GetRotated90Degrees(), col0, col1);
 
-    while (true) {
+    for (int iteration = 0; iteration < GJK_MAX_ITERATIONS; iteration++) {
         Vec2 line0To1 = simplex[1] - simplex[0];
         Vec2 line1To2 = simplex[2] - simplex[1];
         Vec2 line2To0 = simplex[0] - simplex[2];
@@ -103,7 +107,7 @@ static bool PolygonVPolygonCollisionCheck(Collider2D const* col0, Collider2D con
         else {
             simplex[replacedIdx] = newVert;
         }
-   }
+    }
 
     return false;
 }
@@ -177,7 +181,6 @@ static bool DiscVPolygonManifoldGet(Collider2D const* col0, Collider2D const* co
     return true;
 }
 
-#include "Engine/Renderer/DebugRender.hpp"
 
 //////////////////////////////////////////////////////////////////////////
 static bool PolygonVPolygonManifoldGet(Collider2D const* col0, Collider2D const* col1, Manifold2* outManifold)
@@ -194,7 +197,7 @@ static bool PolygonVPolygonManifoldGet(Collider2D const* col0, Collider2D const*
 
     //GJK to find start simplex
     bool originInside = false;
-    while (true) {
+    for (int iteration = 0; iteration < GJK_MAX_ITERATIONS; iteration++) {
         Vec2 line0To1 = simplex[1] - simplex[0];
         Vec2 line1To2 = simplex[2] - simplex[1];
         Vec2 line2To0 = simplex[0] - simplex[2];
@@ -243,7 +246,7 @@ static bool PolygonVPolygonManifoldGet(Collider2D const* col0, Collider2D const*
     float closestDist = FLT_MAX;
     Vec2 closestNormal;
     size_t closestIndex = 0;
-    while (true) {
+    for (int iteration = 0; ; iteration++) {
         for (size_t i = 0; i < simplex.size(); i++) {
             size_t j = i + 1;
             if (j == simplex.size()) {
@@ -262,22 +265,27 @@ static bool PolygonVPolygonManifoldGet(Collider2D const* col0, Collider2D const*
         }
 
         Vec2 newVert = GetSupport(-closestNormal, col0, col1);
+        bool isClosestFound = iteration + 1 >= EPA_MAX_ITERATIONS;   //out of iterations, take the closest so far
         for (size_t i = 0; i < simplex.size(); i++) {
             if (newVert == simplex[i]) {
-                //already find the closest
-                outManifold->normal = closestNormal;
-                outManifold->penetration = closestDist;
+                isClosestFound = true;
+                break;
+            }
+        }
 
-                PolygonCollider2D const* poly0 = static_cast<PolygonCollider2D const*>(col0);
-                LineSegment2 edge0 = poly0->GetContactEdge(-closestNormal,closestDist);
+        if (isClosestFound) {
+            outManifold->normal = closestNormal;
+            outManifold->penetration = closestDist;
 
-                PolygonCollider2D const* poly1 = static_cast<PolygonCollider2D const*>(col1);
-                LineSegment2 edge1 = poly1->GetContactEdge(closestNormal,closestDist);
+            PolygonCollider2D const* poly0 = static_cast<PolygonCollider2D const*>(col0);
+            LineSegment2 edge0 = poly0->GetContactEdge(-closestNormal,closestDist);
 
-                outManifold->contact = ClipLineSegmentToLineSegment(edge1, edge0);
+            PolygonCollider2D const* poly1 = static_cast<PolygonCollider2D const*>(col1);
+            LineSegment2 edge1 = poly1->GetContactEdge(closestNormal,closestDist);
 
-                return true;
-            }
+            outManifold->contact = ClipLineSegmentToLineSegment(edge1, edge0);
+
+            return true;
         }
 
         //need expand
@@ -8,6 +8,7 @@
 #include <vector>
 
 struct Vertex_PCU;
+struct AABB2;
 class Physics2D;
 class Rigidbody2D;
 struct Manifold2;
@@ -44,6 +45,10 @@ public: // Interface
     virtual Vec2    GetSupport(Vec2 const& direction) const = 0;
 	virtual Vec2	GetClosestPoint( Vec2 pos ) const = 0;
 	virtual bool	Contains( Vec2 pos ) const = 0;
+	virtual bool	OverlapsBounds(AABB2 const& bounds) const = 0;
+	// disc of radius swept start to end, 0 for a ray. Fraction along it and surface normal
+	// of the first touch, misses if it overlaps at the start
+	virtual bool	Raycast(Vec2 const& start, Vec2 const& end, float radius, float& outFraction, Vec2& outNormal) const = 0;
 	virtual float	CalculateMomentInertia(float mass) const = 0;
 
 	// debug helpers
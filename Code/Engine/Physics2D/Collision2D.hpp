@@ -10,6 +10,7 @@ struct Collision2D
     Collider2D* other = nullptr;
     Manifold2 manifold;
 
+    Collision2D() = default;
     Collision2D(Collider2D* first, Collider2D* second, Manifold2 mani);
 
     Collision2D GetInverse() const;
@@ -0,0 +1,111 @@
+#include "Engine/Physics2D/ContactCache2D.hpp"
+#include <cstdint>
+
+//////////////////////////////////////////////////////////////////////////
+ContactCache2D::ContactCache2D(int capacity)
+{
+    unsigned int size = 2;
+    while (size < (unsigned int)capacity) {
+        size <<= 1;
+    }
+    m_entries.resize(size);
+    m_mask = size - 1;
+}
+
+//////////////////////////////////////////////////////////////////////////
+ContactCache2D::Entry* ContactCache2D::Find(Collider2D const* me, Collider2D const* other)
+{
+    for (unsigned int slotIdx = GetHomeSlot(me, other); ; slotIdx = (slotIdx + 1) & m_mask) {
+        Entry& entry = m_entries[slotIdx];
+        if (entry.IsEmpty()) {
+            return nullptr;
+        }
+        if (entry.collision.me == me && entry.collision.other == other) {
+            return &entry;
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+ContactCache2D::Entry& ContactCache2D::FindOrAdd(Collider2D* me, Collider2D* other, bool* out_isAdded)
+{
+    if (Entry* entry = Find(me, other)) {
+        *out_isAdded = false;
+        return *entry;
+    }
+
+    //keep at most half full, probes stay short
+    if (2 * (m_count + 1) > (int)m_entries.size()) {
+        Grow();
+    }
+    unsigned int slotIdx = GetHomeSlot(me, other);
+    while (!m_entries[slotIdx].IsEmpty()) {
+        slotIdx = (slotIdx + 1) & m_mask;
+    }
+
+    Entry& entry = m_entries[slotIdx];
+    entry.collision.me = me;
+    entry.collision.other = other;
+    entry.sequence = m_nextSequence++;
+    m_count++;
+    *out_isAdded = true;
+    return entry;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void ContactCache2D::Remove(Collider2D const* me, Collider2D const* other)
+{
+    Entry* found = Find(me, other);
+    if (found == nullptr) {
+        return;
+    }
+
+    //pull later entries of the run back over the hole unless that moves them before their home slot
+    unsigned int holeIdx = (unsigned int)(found - m_entries.data());
+    for (unsigned int slotIdx = (holeIdx + 1) & m_mask; !m_entries[slotIdx].IsEmpty(); slotIdx = (slotIdx + 1) & m_mask) {
+        Entry const& entry = m_entries[slotIdx];
+        unsigned int homeIdx = GetHomeSlot(entry.collision.me, entry.collision.other);
+        if (((slotIdx - homeIdx) & m_mask) >= ((slotIdx - holeIdx) & m_mask)) {
+            m_entries[holeIdx] = entry;
+            holeIdx = slotIdx;
+        }
+    }
+    m_entries[holeIdx] = Entry();
+    m_count--;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void ContactCache2D::Clear()
+{
+    for (Entry& entry : m_entries) {
+        entry = Entry();
+    }
+    m_count = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+unsigned int ContactCache2D::GetHomeSlot(Collider2D const* me, Collider2D const* other) const
+{
+    uint64_t hash = (uint64_t)(uintptr_t)me * 0x9E3779B97F4A7C15ull;
+    hash ^= (uint64_t)(uintptr_t)other * 0xC2B2AE3D27D4EB4Full;
+    hash ^= hash >> 29;
+    return (unsigned int)hash & m_mask;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void ContactCache2D::Grow()
+{
+    std::vector<Entry> oldEntries(m_entries.size() << 1);
+    oldEntries.swap(m_entries);
+    m_mask = (unsigned int)m_entries.size() - 1;
+    for (Entry const& entry : oldEntries) {
+        if (entry.IsEmpty()) {
+            continue;
+        }
+        unsigned int slotIdx = GetHomeSlot(entry.collision.me, entry.collision.other);
+        while (!m_entries[slotIdx].IsEmpty()) {
+            slotIdx = (slotIdx + 1) & m_mask;
+        }
+        m_entries[slotIdx] = entry;
+    }
+}
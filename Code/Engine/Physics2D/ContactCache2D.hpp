@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Engine/Physics2D/Collision2D.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+// contacts that persist across steps, keyed by (me, other) collider pair.
+// Open addressing with linear probing and backward shift removal, so
+// lookups stay O(1) without tombstones piling up.
+class ContactCache2D
+{
+public:
+    struct Entry
+    {
+        Collision2D collision;          //last step's, manifold impulses kept for warm starting
+        Vec2 anchor;                    //me's rigidbody position when the manifold was found
+        unsigned int lastStep = 0;      //step that last found the pair touching
+        unsigned int sequence = 0;      //insertion order, keeps event order independent of addresses
+
+        bool IsEmpty() const { return collision.me == nullptr; }
+    };
+
+public:
+    explicit ContactCache2D(int capacity = 64);    //rounded up to power of two
+
+    Entry* Find(Collider2D const* me, Collider2D const* other);
+    Entry& FindOrAdd(Collider2D* me, Collider2D* other, bool* out_isAdded);
+    void Remove(Collider2D const* me, Collider2D const* other);
+    void Clear();
+
+    int GetCount() const                    { return m_count; }
+    int GetCapacity() const                 { return (int)m_entries.size(); }
+    Entry& GetEntryAt(int slotIdx)          { return m_entries[slotIdx]; }     //may be empty
+
+private:
+    unsigned int GetHomeSlot(Collider2D const* me, Collider2D const* other) const;
+    void Grow();
+
+private:
+    std::vector<Entry> m_entries;
+    unsigned int m_mask = 0;
+    int m_count = 0;
+    unsigned int m_nextSequence = 0;
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Physics2D/RigidbodyStore2D.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+enum eContactEventType : unsigned char
+{
+    CONTACT_EVENT_BEGIN,    //onOverlapStart, OnTriggerEnter
+    CONTACT_EVENT_STAY,     //onOverlapStay, OnTriggerStay
+    CONTACT_EVENT_END,      //onOverlapStop, OnTriggerLeave
+    CONTACT_EVENT_HIT,      //onCollision, after the solver, never for triggers
+};
+
+enum eContactEventFlag : unsigned char
+{
+    CONTACT_EVENT_ME_TRIGGER = 1 << 0,
+    CONTACT_EVENT_OTHER_TRIGGER = 1 << 1,
+};
+
+//////////////////////////////////////////////////////////////////////////
+// one per pair, not per side. Handles instead of pointers, the bodies of
+// an END event may be gone by the time it is drained, GetRigidbody() then
+// returns nullptr but the handles still compare equal to the ones kept
+struct ContactEvent2D
+{
+    RigidbodyHandle2D me;
+    RigidbodyHandle2D other;
+    Vec2 point;                 //middle of the contact
+    Vec2 normal;                //manifold normal of the pair
+    float normalImpulse = 0.f;  //summed over contact points, HIT only
+    eContactEventType type = CONTACT_EVENT_BEGIN;
+    unsigned char flags = 0;
+
+    bool IsTrigger() const { return flags != 0; }
+};
@@ -2,7 +2,9 @@
 #include "Engine/Physics2D/Rigidbody2D.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Math/MathUtils.hpp"
-#include "Engine/Renderer/RenderContext.hpp"
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
 
 //////////////////////////////////////////////////////////////////////////
 DiscCollider2D::DiscCollider2D( Vec2 const& localPos, float radius )
@@ -41,9 +43,8 @@ Vec2 DiscCollider2D::GetSupport(Vec2 const& direction) const
 //////////////////////////////////////////////////////////////////////////
 Vec2 DiscCollider2D::GetClosestPoint( Vec2 pos ) const
 {
-    Mat44 negaRotate = Mat44::CreateZRotationDegrees(-m_rigidbody->GetRotationDegrees());
-    Vec2 newLocalPos = negaRotate.TransformVector2D(pos-m_worldPosition-m_disc.center);
-	return m_disc.GetNearestPoint(newLocalPos) + m_worldPosition + m_disc.center;
+	//round, the body's rotation doesn't change it
+	return GetNearestPointOnDisc2D(pos, m_worldPosition, m_disc.radius);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -54,6 +55,22 @@ bool DiscCollider2D::Contains( Vec2 pos ) const
 	return m_disc.IsPointInside(newLocalPos);
 }
 
+//////////////////////////////////////////////////////////////////////////
+bool DiscCollider2D::OverlapsBounds(AABB2 const& bounds) const
+{
+	return DoDiscAndAABBOverlap2D(m_worldPosition, m_disc.radius, bounds);
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool DiscCollider2D::Raycast(Vec2 const& start, Vec2 const& end, float radius, float& outFraction, Vec2& outNormal) const
+{
+	if (!DoesRayHitDisc2D(start, end, m_worldPosition, m_disc.radius + radius, outFraction)) {
+		return false;
+	}
+	outNormal = (Interpolate(start, end, outFraction) - m_worldPosition).GetNormalized();
+	return true;
+}
+
 //////////////////////////////////////////////////////////////////////////
 float DiscCollider2D::CalculateMomentInertia(float mass) const
 {
@@ -16,6 +16,8 @@ public: // implement the interface of Collider2D
 	virtual Vec2 GetSupport(Vec2 const& direction) const override;
 	virtual Vec2 GetClosestPoint( Vec2 pos ) const override;
 	virtual bool Contains(Vec2 pos) const override;
+	virtual bool OverlapsBounds(AABB2 const& bounds) const override;
+	virtual bool Raycast(Vec2 const& start, Vec2 const& end, float radius, float& outFraction, Vec2& outNormal) const override;
 	virtual float CalculateMomentInertia(float mass) const override;
 
 	virtual void AddVertsForDebugRender( std::vector<Vertex_PCU>& verts, Rgba8 const& borderColor, Rgba8 const& fillColor, 
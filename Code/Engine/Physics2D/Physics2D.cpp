@@ -3,108 +3,219 @@
 #include "Engine/Physics2D/DiscCollider2D.hpp"
 #include "Engine/Physics2D/PolygonCollider2D.hpp"
 #include "Engine/Physics2D/Collider2D.hpp"
+#include "Engine/Physics2D/AABBTree2D.hpp"
+#include "Engine/Physics2D/SpatialHashGrid2D.hpp"
+#include "Engine/Physics2D/ContactCache2D.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Core/Timer.hpp"
 #include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Job.hpp"
 #include "Engine/Core/EventSystem.hpp"
 #include "Engine/Core/StringUtils.hpp"
-#include "Engine/Renderer/DebugRender.hpp"
 #include "Engine/Math/Vec3.hpp"
+#include <algorithm>
+
+static constexpr int NARROW_PHASE_GRAIN_SIZE = 64;   //min pairs per chunk, a few dozen GJK/EPA runs outweigh claiming a chunk
+static constexpr float WARM_START_MIN_NORMAL_DOT = .95f;   //contact normal turned more than ~18 degrees, cold start
+static constexpr float WARM_START_MAX_DRIFT = .2f;         //contact point moved further than this times the smaller radius, cold start
+static constexpr float SLEEP_LINEAR_TOLERANCE = .1f;       //units per second
+static constexpr float SLEEP_ANGULAR_TOLERANCE = .1f;      //radians per second
+static constexpr float SLEEP_DELAY_SECONDS = .5f;          //island slow for this long falls asleep
+static constexpr float CCD_MIN_MOVE_FRACTION = .5f;        //of the radius per step, slower discs are left to the narrow phase
+static constexpr float CCD_TARGET_SEPARATION = .05f;       //of the radius, conservative advancement stops this close
+static constexpr int CCD_MAX_ITERATIONS = 20;
+static constexpr int RAYCAST_GRAIN_SIZE = 32;              //min rays per chunk of a batch
 
-static std::vector<Collision2D> sCollisions;
-static std::vector<bool> sStillCollides;
+//////////////////////////////////////////////////////////////////////////
+//Collision events
+//////////////////////////////////////////////////////////////////////////
+void Physics2D::AppendAndFireEventsForNewCollision(Collision2D& collision)
+{
+    bool isAdded = false;
+    ContactCache2D::Entry& entry = m_contactCache.FindOrAdd(collision.me, collision.other, &isAdded);
+    if (m_isEventsDeferred) {
+        PushContactEvent(isAdded ? CONTACT_EVENT_BEGIN : CONTACT_EVENT_STAY, isAdded ? collision : entry.collision);
+        if (!isAdded && m_isWarmStarting) {
+            TakeCachedImpulses(collision, entry);
+        }
+    }
+    else if (!isAdded) {
+        Collision2D const& col = entry.collision;
+        Collision2D invCol = col.GetInverse();
+        if (col.me->IsTrigger()) {
+            col.me->OnTriggerStay(col.me, col.other);
+        }
+        if (col.other->IsTrigger()) {
+            col.other->OnTriggerStay(col.other, col.me);
+        }
+        if (!col.me->IsTrigger() && !col.other->IsTrigger()) {
+            col.me->m_rigidbody->onOverlapStay(col);
+            col.other->m_rigidbody->onOverlapStay(invCol);
+        }
+        if (m_isWarmStarting) {
+            TakeCachedImpulses(collision, entry);
+        }
+    }
+    else {
+        Collision2D invCol = collision.GetInverse();
+        if (!collision.me->IsTrigger() && !collision.other->IsTrigger()) {
+            collision.me->m_rigidbody->onOverlapStart(collision);
+            collision.other->m_rigidbody->onOverlapStart(invCol);
+        }
+        if (collision.me->IsTrigger()) {
+            collision.me->OnTriggerEnter(collision.me, collision.other);
+        }
+        if (collision.other->IsTrigger()) {
+            collision.other->OnTriggerEnter(collision.other, collision.me);
+        }
+    }
+
+    entry.collision = collision;
+    entry.anchor = collision.me->m_rigidbody->GetWorldPosition();
+    entry.lastStep = m_stepIndex;
+}
 
 //////////////////////////////////////////////////////////////////////////
-//Static methods
+void Physics2D::EraseAndFireEventsForOldCollision(Collision2D const& collision)
+{
+    ContactCache2D::Entry* entry = m_contactCache.Find(collision.me, collision.other);
+    if (entry == nullptr) {
+        return;
+    }
+
+    Collision2D col = entry->collision;
+    m_contactCache.Remove(col.me, col.other);
+    FireEventsForOldCollision(col);
+}
+
 //////////////////////////////////////////////////////////////////////////
-static void AppendAndFireEventsForNewCollision(Collision2D const& collision)
+void Physics2D::FireEventsForOldCollision(Collision2D const& col)
 {
-    for (size_t i = 0; i < sCollisions.size(); i++) {
-        Collision2D& col = sCollisions[i];
-        if (col.me == collision.me && col.other == collision.other) {
-            Collision2D invCol = col.GetInverse();            
-            if (col.me->IsTrigger()) {
-                col.me->OnTriggerStay(col.me, col.other);
-            } 
-            if (col.other->IsTrigger()) {
-                col.other->OnTriggerStay(col.other, col.me);
-            }
-            if (!col.me->IsTrigger() && !col.other->IsTrigger()) {
-                col.me->m_rigidbody->onOverlapStay(col);
-                col.other->m_rigidbody->onOverlapStay(invCol);
-            }
+    if (m_isEventsDeferred) {
+        PushContactEvent(CONTACT_EVENT_END, col);
+        return;
+    }
 
-            sCollisions[i] = collision;
-            sStillCollides[i] = true;
-            return;
-        }
+    Collision2D invCol = col.GetInverse();
+    if (!col.me->IsTrigger() && !col.other->IsTrigger()) {
+        col.me->m_rigidbody->onOverlapStop(col);
+        col.other->m_rigidbody->onOverlapStop(invCol);
+    }
+    if (col.me->IsTrigger()) {
+        col.me->OnTriggerLeave(col.me, col.other);
+    }
+    if (col.other->IsTrigger()) {
+        col.other->OnTriggerLeave(col.other, col.me);
     }
+}
 
-    Collision2D invCol = collision.GetInverse();
-    if (!collision.me->IsTrigger() && !collision.other->IsTrigger()) {
-        collision.me->m_rigidbody->onOverlapStart(collision);
-        collision.other->m_rigidbody->onOverlapStart(invCol);
+//////////////////////////////////////////////////////////////////////////
+void Physics2D::PushContactEvent(eContactEventType type, Collision2D const& collision)
+{
+    ContactEvent2D& contactEvent = m_contactEvents.emplace_back();
+    contactEvent.me = collision.me->m_rigidbody->m_handle;
+    contactEvent.other = collision.other->m_rigidbody->m_handle;
+    contactEvent.point = collision.manifold.GetContact();
+    contactEvent.normal = collision.manifold.normal;
+    contactEvent.type = type;
+    if (type == CONTACT_EVENT_HIT) {
+        contactEvent.normalImpulse = collision.manifold.normalImpulse.x + collision.manifold.normalImpulse.y;
     }
     if (collision.me->IsTrigger()) {
-        collision.me->OnTriggerEnter(collision.me, collision.other);
+        contactEvent.flags |= CONTACT_EVENT_ME_TRIGGER;
     }
     if (collision.other->IsTrigger()) {
-        collision.other->OnTriggerEnter(collision.other, collision.me);
+        contactEvent.flags |= CONTACT_EVENT_OTHER_TRIGGER;
     }
-    sCollisions.push_back(collision);
-    sStillCollides.push_back(true);
 }
 
 //////////////////////////////////////////////////////////////////////////
-static void EraseAndFireEventsForOldCollision(Collision2D const& collision)
+void Physics2D::SetEventsDeferred(bool isDeferred)
 {
-    for (size_t i = 0; i < sCollisions.size(); i++) {
-        Collision2D& col = sCollisions[i];
-        if (col.me == collision.me && col.other == collision.other) {
-            Collision2D invCol = col.GetInverse();
-            if (!col.me->IsTrigger() && !col.other->IsTrigger()) {
-                col.me->m_rigidbody->onOverlapStop(col);
-                col.other->m_rigidbody->onOverlapStop(invCol);
-            }
-            if (col.me->IsTrigger()) {
-                col.me->OnTriggerLeave(col.me, col.other);
-            }
-            if (col.other->IsTrigger()) {
-                col.other->OnTriggerLeave(col.other, col.me);
-            }
+    m_isEventsDeferred = isDeferred;
+}
 
-            sCollisions.erase(sCollisions.begin() + i);
-            sStillCollides.erase(sStillCollides.begin() + i);
-            return;
+//////////////////////////////////////////////////////////////////////////
+// hands over everything queued since the last drain, outEvents' storage is
+// recycled as the next buffer so draining every frame doesn't allocate
+void Physics2D::DrainContactEvents(std::vector<ContactEvent2D>& outEvents)
+{
+    outEvents.clear();
+    outEvents.swap(m_contactEvents);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Physics2D::CleanUpPastCollisions()
+{
+    //pairs not found this step, or about to be deleted, leave in the order they entered.
+    //Sleeping pairs aren't tested and stay cached with their impulses
+    m_staleContacts.clear();
+    for (int slotIdx = 0; slotIdx < m_contactCache.GetCapacity(); slotIdx++) {
+        ContactCache2D::Entry const& entry = m_contactCache.GetEntryAt(slotIdx);
+        if (entry.IsEmpty()) {
+            continue;
+        }
+        Collision2D const& col = entry.collision;
+        if (col.me->m_isDestroyed || col.other->m_isDestroyed ||
+            (entry.lastStep != m_stepIndex && !IsPairSleeping(col.me->m_rigidbody, col.other->m_rigidbody))) {
+            m_staleContacts.push_back(entry);
         }
     }
+    std::sort(m_staleContacts.begin(), m_staleContacts.end(),
+        [](ContactCache2D::Entry const& a, ContactCache2D::Entry const& b) { return a.sequence < b.sequence; });
+
+    for (ContactCache2D::Entry const& entry : m_staleContacts) {
+        m_contactCache.Remove(entry.collision.me, entry.collision.other);
+    }
+    for (ContactCache2D::Entry const& entry : m_staleContacts) {
+        FireEventsForOldCollision(entry.collision);
+    }
 }
 
 //////////////////////////////////////////////////////////////////////////
-static void CleanUpPastCollisions()
+// carries last step's accumulated impulses over when the contact points
+// are still roughly where they were relative to me, otherwise cold starts
+void Physics2D::TakeCachedImpulses(Collision2D& collision, ContactCache2D::Entry const& entry) const
 {
-    for (size_t i = 0; i < sCollisions.size();) {
-        if (!sStillCollides[i]) {
-            Collision2D& col = sCollisions[i];
-            if (!col.me->IsTrigger() && !col.other->IsTrigger()) {
-                col.me->m_rigidbody->onOverlapStop(col);
-                col.other->m_rigidbody->onOverlapStop(col.GetInverse());
-            }
-            if (col.me->IsTrigger()) {
-                col.me->OnTriggerLeave(col.me, col.other);
-            }
-            if (col.other->IsTrigger()) {
-                col.other->OnTriggerLeave(col.other, col.me);
-            }
+    Manifold2& manifold = collision.manifold;
+    Manifold2 const& cached = entry.collision.manifold;
+    if (manifold.contact.IsSegmentPoint() != cached.contact.IsSegmentPoint() ||
+        DotProduct2D(manifold.normal, cached.normal) < WARM_START_MIN_NORMAL_DOT) {
+        return;
+    }
 
-            sCollisions.erase(sCollisions.begin() + i);
-            sStillCollides.erase(sStillCollides.begin() + i);
-        }
-        else {
-            sStillCollides[i] = false;
-            i++;
+    float radius = MinFloat(collision.me->GetWorldBounds().radius, collision.other->GetWorldBounds().radius);
+    float maxDistSquared = WARM_START_MAX_DRIFT * WARM_START_MAX_DRIFT * radius * radius;
+    Vec2 anchor = collision.me->m_rigidbody->GetWorldPosition();
+    Vec2 start = manifold.contact.start - anchor;
+    Vec2 end = manifold.contact.end - anchor;
+    Vec2 cachedStart = cached.contact.start - entry.anchor;
+    Vec2 cachedEnd = cached.contact.end - entry.anchor;
+
+    //two point manifolds may come back with the ends swapped
+    float directDistSquared = MaxFloat(GetDistanceSquared2D(start, cachedStart), GetDistanceSquared2D(end, cachedEnd));
+    float swappedDistSquared = MaxFloat(GetDistanceSquared2D(start, cachedEnd), GetDistanceSquared2D(end, cachedStart));
+    bool isSwapped = swappedDistSquared < directDistSquared;
+    if (MinFloat(directDistSquared, swappedDistSquared) > maxDistSquared) {
+        return;
+    }
+
+    Vec2 bounceImpulse = isSwapped ? Vec2(cached.bounceImpulse.y, cached.bounceImpulse.x) : cached.bounceImpulse;
+    Vec2 tangentImpulse = isSwapped ? Vec2(cached.tangentImpulse.y, cached.tangentImpulse.x) : cached.tangentImpulse;
+    manifold.bounceImpulse = bounceImpulse;
+    manifold.normalImpulse = bounceImpulse;     //bias part is not carried over
+    manifold.tangentImpulse = tangentImpulse;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Physics2D::StoreImpulsesInCache()
+{
+    for (Collision2D const& collision : m_collisions) {
+        ContactCache2D::Entry* entry = m_contactCache.Find(collision.me, collision.other);
+        if (entry != nullptr) {
+            entry->collision.manifold = collision.manifold;
         }
     }
 }
@@ -121,6 +232,7 @@ Physics2D::Physics2D()
 //////////////////////////////////////////////////////////////////////////
 Physics2D::~Physics2D()
 {
+    WakeAllSleepingIslands();
     for (size_t idx = 0; idx < m_rigidbodies.size(); idx++) {
         if (m_rigidbodies[idx] != nullptr) {
             m_rigidbodies[idx]->Destroy();
@@ -128,15 +240,31 @@ Physics2D::~Physics2D()
     }
 
     CleanUpDestroyed();
+    delete m_broadPhase;
+    m_broadPhase = nullptr;
 }
 
 //////////////////////////////////////////////////////////////////////////
-void Physics2D::Startup()
+void Physics2D::Startup(eBroadPhase2DType broadPhaseType, float hashCellSize)
 {
     m_stepTimer->SetTimerSeconds(m_clock, m_fixedDeltaTime);
     for (int i = 0; i < PHYSICS_LAYER_COUNT; i++) {
         m_layerInteractions[i] = 0xffffffff;
     }
+
+    delete m_broadPhase;
+    m_broadPhase = nullptr;
+    m_broadPhaseType = broadPhaseType;
+    switch (broadPhaseType) {
+    case BROAD_PHASE_AABB_TREE:
+        m_broadPhase = new AABBTree2D();
+        break;
+    case BROAD_PHASE_SPATIAL_HASH:
+        m_broadPhase = new SpatialHashGrid2D(hashCellSize);
+        break;
+    default:
+        break;
+    }
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -230,6 +358,9 @@ Rigidbody2D* Physics2D::CreateRigidbody()
 {
 	Rigidbody2D* rigidbody = new Rigidbody2D();
 	rigidbody->m_system = this;
+	rigidbody->m_store = &m_bodyStore;
+	rigidbody->m_handle = m_bodyStore.Add(rigidbody);
+	rigidbody->UpdateStoreFlags();
 	for( size_t rIdx = 0; rIdx < m_rigidbodies.size(); rIdx++ )
 	{
 		if( m_rigidbodies[rIdx] == nullptr )
@@ -243,10 +374,20 @@ Rigidbody2D* Physics2D::CreateRigidbody()
 	return rigidbody;
 }
 
+//////////////////////////////////////////////////////////////////////////
+Rigidbody2D* Physics2D::GetRigidbody(RigidbodyHandle2D handle) const
+{
+    Rigidbody2D* rigidbody = m_bodyStore.Resolve(handle);
+    return rigidbody != nullptr && !rigidbody->m_isDestroyed ? rigidbody : nullptr;
+}
+
 //////////////////////////////////////////////////////////////////////////
 void Physics2D::DestroyRigidbody( Rigidbody2D* rb )
 {
+	WakeTouchingBodies(rb);
+	rb->WakeUp();
 	rb->m_isDestroyed = true;
+	rb->UpdateStoreFlags();
 
 	Collider2D* collider = rb->GetCollider();
 	if( collider != nullptr )
@@ -291,70 +432,383 @@ void Physics2D::DestroyCollider( Collider2D* collider )
 //////////////////////////////////////////////////////////////////////////
 void Physics2D::AdvanceSimulation(float deltaSeconds)
 {
-    onFixedUpdate(deltaSeconds);
+    m_profiler.BeginStep();
+    {
+        ScopedStepPhase2D scope(m_profiler, STEP_PHASE_FIXED_UPDATE);
+        onFixedUpdate(deltaSeconds);
+    }
     
+    m_stepIndex++;
     DetectCollisions();
-    for (Collision2D col : m_collisions) {
-        AppendAndFireEventsForNewCollision(col);
+    {
+        ScopedStepPhase2D scope(m_profiler, STEP_PHASE_SOLVER);
+        WakeBodiesInContact();
     }
-    for (size_t i = 0; i < m_collisions.size();i++) {
-        Collision2D& col = m_collisions[i];
-        Rigidbody2D* me = col.me->m_rigidbody;
-        Rigidbody2D* other = col.other->m_rigidbody;
-        if (me->m_isDestroyed || !me->m_isEnabled ||
-            other->m_isDestroyed || !other->m_isEnabled) {
-            EraseAndFireEventsForOldCollision(col);
+    {
+        ScopedStepPhase2D scope(m_profiler, STEP_PHASE_EVENTS);
+        for (Collision2D& col : m_collisions) {
+            AppendAndFireEventsForNewCollision(col);
+        }
+        for (size_t i = 0; i < m_collisions.size();i++) {
+            Collision2D& col = m_collisions[i];
+            Rigidbody2D* me = col.me->m_rigidbody;
+            Rigidbody2D* other = col.other->m_rigidbody;
+            if (me->m_isDestroyed || !me->m_isEnabled ||
+                other->m_isDestroyed || !other->m_isEnabled) {
+                EraseAndFireEventsForOldCollision(col);
+            }
         }
     }
 
-    ResolveCollisions();
-    for (Collision2D col : m_collisions) {
-        if (!col.me->IsTrigger() && !col.other->IsTrigger()) {
-            Collision2D invCol = col.GetInverse();
-            col.me->m_rigidbody->onCollision(col);
-            col.other->m_rigidbody->onCollision(invCol);
+    {
+        ScopedStepPhase2D scope(m_profiler, STEP_PHASE_SOLVER);
+        ResolveCollisions();
+        if (m_isWarmStarting) {
+            StoreImpulsesInCache();
+        }
+    }
+    {
+        ScopedStepPhase2D scope(m_profiler, STEP_PHASE_EVENTS);
+        for (Collision2D const& col : m_collisions) {
+            if (IsTriggerCollision(col)) {
+                continue;
+            }
+            if (m_isEventsDeferred) {
+                PushContactEvent(CONTACT_EVENT_HIT, col);
+            }
+            else {
+                Collision2D invCol = col.GetInverse();
+                col.me->m_rigidbody->onCollision(col);
+                col.other->m_rigidbody->onCollision(invCol);
+            }
         }
     }
 
-    BeginSimulation();
-    ApplyEffectors();//global forces to dynamic rigid bodies
-    MoveRigidbodies(deltaSeconds);//apply euler step to all rigid bodies
+    {
+        ScopedStepPhase2D scope(m_profiler, STEP_PHASE_INTEGRATE);
+        MoveRigidbodies(deltaSeconds);//gravity, drag and euler step for all rigid bodies
+    }
+    {
+        ScopedStepPhase2D scope(m_profiler, STEP_PHASE_CONTINUOUS);
+        SolveContinuousCollisions();
+    }
+    {
+        ScopedStepPhase2D scope(m_profiler, STEP_PHASE_SLEEP);
+        UpdateSleep(deltaSeconds);
+    }
 
-    CleanUpPastCollisions();
-    CleanUpDestroyed();//clean up destroyed objects
+    {
+        ScopedStepPhase2D scope(m_profiler, STEP_PHASE_CLEANUP);
+        CleanUpPastCollisions();
+        CleanUpDestroyed();//clean up destroyed objects
+    }
+    m_isBroadPhaseStale = true;
+    m_profiler.EndStep();
 }
 
 //////////////////////////////////////////////////////////////////////////
-void Physics2D::ApplyEffectors()
+void Physics2D::MoveRigidbodies(float deltaSeconds)
 {
-    //gravity
+    //flags in the store already skip static, disabled, sleeping and destroyed bodies
     Vec2 gravityAcceleration = m_gravityAcceleration * Vec2(0.f, -1.f);
-    for (size_t idx = 0; idx < m_rigidbodies.size(); idx++)
-    {
-        Rigidbody2D* rigidbody = m_rigidbodies[idx];
-        if (rigidbody == nullptr || rigidbody->m_mode != eSimulationMode::DYNAMIC || 
-            rigidbody->m_isDestroyed || !rigidbody->m_isEnabled)
-        {
+    m_bodyStore.Integrate(gravityAcceleration, deltaSeconds);
+
+    for (int bodyIdx = 0; bodyIdx < m_bodyStore.GetCount(); bodyIdx++) {
+        Rigidbody2D* rigidbody = m_bodyStore.m_owners[bodyIdx];
+        if ((m_bodyStore.m_flags[bodyIdx] & BODY_FLAG_INTEGRATE) != 0 && rigidbody->m_collider != nullptr) {
+            rigidbody->m_collider->UpdateWorldShape();
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// conservative advancement of a disc moving start to start + move against a
+// polygon that doesn't move, each step is the current gap over the speed so
+// it can't pass through. 1 if it doesn't hit, overlapped at the start or
+// starts close but moves away, convex so the gap only grows from there
+static float ComputeDiscTimeOfImpact(Vec2 const& start, Vec2 const& move, float radius, PolygonCollider2D const* polygon)
+{
+    float moveLength = move.GetLength();
+    float targetSeparation = CCD_TARGET_SEPARATION * radius;
+    float time = 0.f;
+    for (int iteration = 0; iteration < CCD_MAX_ITERATIONS; iteration++) {
+        Vec2 center = start + time * move;
+        Vec2 closestPoint = polygon->GetClosestPoint(center);
+        float separation = GetDistance2D(center, closestPoint) - radius;
+        if (polygon->Contains(center) || separation <= 0.f) {
+            return time > 0.f ? time : 1.f;     //overlapping at the start is the narrow phase's
+        }
+        if (separation <= targetSeparation) {
+            bool isApproaching = DotProduct2D(move, center - closestPoint) < 0.f;
+            return time > 0.f || isApproaching ? time : 1.f;
+        }
+
+        time += (separation - .5f * targetSeparation) / moveLength;
+        if (time >= 1.f) {
+            return 1.f;
+        }
+    }
+    return time;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Physics2D::SolveContinuousCollisions()
+{
+    m_continuousHitCount = 0;
+    for (int bodyIdx = 0; bodyIdx < m_bodyStore.GetCount(); bodyIdx++) {
+        if ((m_bodyStore.m_flags[bodyIdx] & BODY_FLAG_CONTINUOUS) == 0) {
+            continue;
+        }
+        Rigidbody2D* rigidbody = m_bodyStore.m_owners[bodyIdx];
+        Collider2D* collider = rigidbody->m_collider;
+        if (rigidbody->m_mode != DYNAMIC || collider == nullptr || collider->GetType() != COLLIDER2D_DISC || collider->IsTrigger()) {
+            continue;
+        }
+
+        DiscCollider2D* disc = (DiscCollider2D*)collider;
+        float radius = disc->m_disc.radius;
+        Vec2 startPosition = m_bodyStore.GetLastPosition(bodyIdx);
+        Vec2 move = m_bodyStore.GetPosition(bodyIdx) - startPosition;
+        if (move.GetLengthSquared() <= CCD_MIN_MOVE_FRACTION * CCD_MIN_MOVE_FRACTION * radius * radius) {
+            continue;
+        }
+
+        //swept disc bounds, targets keep their end of step pose
+        Vec2 start = startPosition + disc->m_disc.center;
+        Vec2 end = start + move;
+        AABB2 sweptBounds(Vec2(std::min(start.x, end.x) - radius, std::min(start.y, end.y) - radius),
+            Vec2(std::max(start.x, end.x) + radius, std::max(start.y, end.y) + radius));
+        QueryColliders(sweptBounds, m_queryResults);
+
+        float hitTime = 1.f;
+        PolygonCollider2D const* hitPolygon = nullptr;
+        for (unsigned int colliderIdx : m_queryResults) {
+            Collider2D const* target = m_colliders[colliderIdx];
+            if (target == nullptr || target == collider || target->GetType() != COLLIDER2D_POLYGON || target->IsTrigger()) {
+                continue;
+            }
+            Rigidbody2D const* targetBody = target->m_rigidbody;
+            if (targetBody->m_mode == DYNAMIC || targetBody->m_isDestroyed || !targetBody->m_isEnabled ||
+                !DoLayersInteract(rigidbody->m_layerIndex, targetBody->m_layerIndex)) {
+                continue;
+            }
+
+            PolygonCollider2D const* polygon = (PolygonCollider2D const*)target;
+            float time = ComputeDiscTimeOfImpact(start, move, radius, polygon);
+            if (time < hitTime) {
+                hitTime = time;
+                hitPolygon = polygon;
+            }
+        }
+        if (hitPolygon == nullptr) {
             continue;
         }
 
-        rigidbody->ApplyGravityForce(gravityAcceleration);
-        rigidbody->ApplyDragForce();
+        //stop at the time of impact and bounce off, the rest of the step is dropped
+        Vec2 hitCenter = start + hitTime * move;
+        Vec2 normal = (hitCenter - hitPolygon->GetClosestPoint(hitCenter)).GetNormalized();
+        Vec2 targetVelocity = hitPolygon->m_rigidbody->GetVelocity();
+        Vec2 relativeVelocity = m_bodyStore.GetVelocity(bodyIdx) - targetVelocity;
+        float normalSpeed = DotProduct2D(relativeVelocity, normal);
+        if (normalSpeed < 0.f) {
+            relativeVelocity -= (1.f + collider->GetBounceWith(hitPolygon)) * normalSpeed * normal;
+            m_bodyStore.SetVelocity(bodyIdx, relativeVelocity + targetVelocity);
+        }
+        m_bodyStore.SetPosition(bodyIdx, startPosition + hitTime * move);
+        collider->UpdateWorldShape();
+        m_continuousHitCount++;
     }
 }
 
 //////////////////////////////////////////////////////////////////////////
-void Physics2D::MoveRigidbodies(float deltaSeconds)
+void Physics2D::QueryColliders(AABB2 const& bounds, std::vector<unsigned int>& outColliderIdxs) const
+{
+    if (m_broadPhase != nullptr) {
+        m_broadPhase->Query(bounds, outColliderIdxs);
+        return;
+    }
+
+    outColliderIdxs.clear();
+    for (unsigned int colliderIdx = 0; colliderIdx < (unsigned int)m_colliders.size(); colliderIdx++) {
+        Collider2D const* collider = m_colliders[colliderIdx];
+        if (collider != nullptr && bounds.IsBoundsOverlap(BroadPhase2D::GetColliderBounds(collider))) {
+            outColliderIdxs.push_back(colliderIdx);
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Physics2D::QueryCollidersOnSegment(Vec2 const& start, Vec2 const& end, std::vector<unsigned int>& outColliderIdxs) const
+{
+    if (m_broadPhase != nullptr) {
+        m_broadPhase->QueryRay(start, end, outColliderIdxs);
+        return;
+    }
+
+    outColliderIdxs.clear();
+    for (unsigned int colliderIdx = 0; colliderIdx < (unsigned int)m_colliders.size(); colliderIdx++) {
+        Collider2D const* collider = m_colliders[colliderIdx];
+        if (collider != nullptr && BroadPhase2D::DoesSegmentHitBounds(start, end, BroadPhase2D::GetColliderBounds(collider))) {
+            outColliderIdxs.push_back(colliderIdx);
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Physics2D::RefreshBroadPhase()
+{
+    if (m_broadPhase != nullptr && m_isBroadPhaseStale) {
+        m_broadPhase->Update(m_colliders);
+    }
+    m_isBroadPhaseStale = false;
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool Physics2D::IsQueryable(Collider2D const* collider, unsigned int layerMask) const
+{
+    if (collider == nullptr || collider->m_isDestroyed || collider->IsTrigger()) {
+        return false;
+    }
+    Rigidbody2D const* rigidbody = collider->m_rigidbody;
+    return !rigidbody->m_isDestroyed && rigidbody->m_isEnabled && (layerMask & (1u << rigidbody->m_layerIndex)) != 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool Physics2D::Raycast(Vec2 const& start, Vec2 const& direction, float maxDistance, RaycastHit2D& outHit, unsigned int layerMask)
+{
+    RefreshBroadPhase();
+    return RaycastWithScratch(RaycastQuery2D(start, direction, maxDistance, layerMask), outHit, m_queryResults);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// const and only touching the given scratch, RaycastBatch runs it on several threads
+bool Physics2D::RaycastWithScratch(RaycastQuery2D const& query, RaycastHit2D& outHit, std::vector<unsigned int>& scratchIdxs) const
+{
+    outHit = RaycastHit2D();
+    Vec2 direction = query.direction.GetNormalized();
+    if (query.maxDistance <= 0.f || direction == Vec2::ZERO) {
+        return false;
+    }
+
+    Vec2 end = query.start + query.maxDistance * direction;
+    QueryCollidersOnSegment(query.start, end, scratchIdxs);
+    float hitFraction = 1.f;
+    for (unsigned int colliderIdx : scratchIdxs) {
+        Collider2D* collider = m_colliders[colliderIdx];
+        if (!IsQueryable(collider, query.layerMask)) {
+            continue;
+        }
+
+        float fraction = 0.f;
+        Vec2 normal;
+        if (collider->Raycast(query.start, end, 0.f, fraction, normal) && (fraction < hitFraction || outHit.collider == nullptr)) {
+            hitFraction = fraction;
+            outHit.collider = collider;
+            outHit.normal = normal;
+        }
+    }
+    if (outHit.collider == nullptr) {
+        return false;
+    }
+
+    outHit.distance = hitFraction * query.maxDistance;
+    outHit.point = query.start + outHit.distance * direction;
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Physics2D::RaycastBatch(RaycastQuery2D const* queries, int queryCount, RaycastHit2D* outHits)
 {
-    for (size_t idx = 0; idx < m_rigidbodies.size(); idx++)
+    RefreshBroadPhase();
+    if (m_queryScratch.empty()) {
+        m_queryScratch.resize(MAX_PARALLEL_PARTICIPANTS);
+    }
+
+    struct BatchContext
     {
-        Rigidbody2D* rigidbody = m_rigidbodies[idx];
-        if (rigidbody != nullptr && rigidbody->m_mode!= eSimulationMode::STATIC && 
-            !rigidbody->m_isDestroyed && rigidbody->m_isEnabled)
-        {
-            rigidbody->Simulate(deltaSeconds);
+        Physics2D* physics;
+        RaycastQuery2D const* queries;
+        RaycastHit2D* hits;
+    };
+    BatchContext context = { this, queries, outHits };
+    ParallelForRanges(0, queryCount, RAYCAST_GRAIN_SIZE, [](void* contextPtr, int participantIndex, int rangeBegin, int rangeEnd) {
+        BatchContext& batch = *(BatchContext*)contextPtr;
+        std::vector<unsigned int>& scratchIdxs = batch.physics->m_queryScratch[participantIndex].colliderIdxs;
+        for (int queryIdx = rangeBegin; queryIdx < rangeEnd; queryIdx++) {
+            batch.physics->RaycastWithScratch(batch.queries[queryIdx], batch.hits[queryIdx], scratchIdxs);
+        }
+    }, &context);
+}
+
+//////////////////////////////////////////////////////////////////////////
+int Physics2D::OverlapAABB(AABB2 const& bounds, std::vector<Collider2D*>& outColliders, unsigned int layerMask)
+{
+    RefreshBroadPhase();
+    outColliders.clear();
+    QueryColliders(bounds, m_queryResults);
+    for (unsigned int colliderIdx : m_queryResults) {
+        Collider2D* collider = m_colliders[colliderIdx];
+        if (IsQueryable(collider, layerMask) && collider->OverlapsBounds(bounds)) {
+            outColliders.push_back(collider);
+        }
+    }
+    return (int)outColliders.size();
+}
+
+//////////////////////////////////////////////////////////////////////////
+int Physics2D::OverlapDisc(Vec2 const& center, float radius, std::vector<Collider2D*>& outColliders, unsigned int layerMask)
+{
+    RefreshBroadPhase();
+    outColliders.clear();
+    QueryColliders(AABB2(center - Vec2(radius, radius), center + Vec2(radius, radius)), m_queryResults);
+    for (unsigned int colliderIdx : m_queryResults) {
+        Collider2D* collider = m_colliders[colliderIdx];
+        if (IsQueryable(collider, layerMask) &&
+            (collider->Contains(center) || GetDistanceSquared2D(center, collider->GetClosestPoint(center)) <= radius * radius)) {
+            outColliders.push_back(collider);
+        }
+    }
+    return (int)outColliders.size();
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool Physics2D::ShapeCast(Disc2 const& disc, Vec2 const& direction, float maxDistance, RaycastHit2D& outHit, unsigned int layerMask)
+{
+    outHit = RaycastHit2D();
+    Vec2 move = maxDistance * direction.GetNormalized();
+    if (maxDistance <= 0.f || move == Vec2::ZERO || disc.radius <= 0.f) {
+        return false;
+    }
+
+    RefreshBroadPhase();
+    Vec2 start = disc.center;
+    Vec2 end = start + move;
+    AABB2 sweptBounds(Vec2(std::min(start.x, end.x) - disc.radius, std::min(start.y, end.y) - disc.radius),
+        Vec2(std::max(start.x, end.x) + disc.radius, std::max(start.y, end.y) + disc.radius));
+    QueryColliders(sweptBounds, m_queryResults);
+
+    float hitFraction = 1.f;
+    for (unsigned int colliderIdx : m_queryResults) {
+        Collider2D* collider = m_colliders[colliderIdx];
+        if (!IsQueryable(collider, layerMask)) {
+            continue;
+        }
+
+        float fraction = 0.f;
+        Vec2 normal;
+        if (collider->Raycast(start, end, disc.radius, fraction, normal) && (fraction < hitFraction || outHit.collider == nullptr)) {
+            hitFraction = fraction;
+            outHit.collider = collider;
+            outHit.normal = normal;
         }
     }
+    if (outHit.collider == nullptr) {
+        return false;
+    }
+
+    outHit.distance = hitFraction * maxDistance;
+    outHit.point = start + hitFraction * move - disc.radius * outHit.normal;
+    return true;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -362,52 +816,162 @@ void Physics2D::DetectCollisions()
 {
     m_collisions.clear();
 
-    for (size_t i = 0; i < m_colliders.size(); i++) {
-        for (size_t j = i + 1; j < m_colliders.size(); j++) {
-            Collider2D* first = m_colliders[i];
-            Collider2D* second = m_colliders[j];
-            if (first == nullptr || second == nullptr) {
-                continue;
+    if (m_broadPhase == nullptr) {
+        ScopedStepPhase2D scope(m_profiler, STEP_PHASE_NARROW_PHASE);    //pairs and manifolds in one loop
+        m_candidatePairCount = 0;
+        for (size_t i = 0; i < m_colliders.size(); i++) {
+            for (size_t j = i + 1; j < m_colliders.size(); j++) {
+                Collider2D* first = m_colliders[i];
+                Collider2D* second = m_colliders[j];
+                if (first != nullptr && second != nullptr) {
+                    m_candidatePairCount++;
+                    DetectCollision(first, second, m_collisions);
+                }
             }
+        }
+        return;
+    }
 
-            Rigidbody2D* rigid1 = first->m_rigidbody;
-            Rigidbody2D* rigid2 = second->m_rigidbody;
-            if ( rigid1->IsDestroyed() || rigid2->IsDestroyed() ||
-                !rigid1->IsEnabled() || !rigid2->IsEnabled() ||
-                !DoLayersInteract(rigid1->GetLayer(), rigid2->GetLayer())) {
-                continue;
-            }
+    {
+        ScopedStepPhase2D scope(m_profiler, STEP_PHASE_BROAD_PHASE);
+        m_broadPhase->Update(m_colliders);
+        m_isBroadPhaseStale = false;
+        m_broadPhase->FindPairs(m_candidatePairs);
+        m_candidatePairCount = (int)m_candidatePairs.size();
+    }
 
-            Manifold2 temp;
-            if (first->GetManifold(second, &temp)) {
-                Collision2D collision = Collision2D(first, second, temp);
-                m_collisions.push_back(collision);
-            }
+    ScopedStepPhase2D narrowScope(m_profiler, STEP_PHASE_NARROW_PHASE);
+    if (m_isNarrowPhaseParallel) {
+        DetectCollisionsInParallel();
+        return;
+    }
+
+    for (ColliderPair2D const& pair : m_candidatePairs) {
+        DetectCollision(m_colliders[pair.first], m_colliders[pair.second], m_collisions);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// GetManifold only reads colliders and bodies, pairs are independent until
+// the solver. Merging ranges sorted by first pair gives the same collision
+// order as the serial loop, whatever the worker count or chunking.
+void Physics2D::DetectCollisionsInParallel()
+{
+    if (m_narrowPhaseBuffers.empty()) {
+        m_narrowPhaseBuffers.resize(MAX_PARALLEL_PARTICIPANTS);
+    }
+    for (NarrowPhaseBuffer& buffer : m_narrowPhaseBuffers) {
+        buffer.collisions.clear();
+        buffer.ranges.clear();
+    }
+
+    ParallelForRanges(0, (int)m_candidatePairs.size(), NARROW_PHASE_GRAIN_SIZE, [](void* context, int participantIndex, int rangeBegin, int rangeEnd) {
+        Physics2D& physics = *(Physics2D*)context;
+        NarrowPhaseBuffer& buffer = physics.m_narrowPhaseBuffers[participantIndex];
+        NarrowPhaseRange range;
+        range.firstPair = rangeBegin;
+        range.bufferIdx = participantIndex;
+        range.firstCollision = (int)buffer.collisions.size();
+        for (int pairIdx = rangeBegin; pairIdx < rangeEnd; pairIdx++) {
+            ColliderPair2D const& pair = physics.m_candidatePairs[pairIdx];
+            physics.DetectCollision(physics.m_colliders[pair.first], physics.m_colliders[pair.second], buffer.collisions);
         }
+        range.collisionCount = (int)buffer.collisions.size() - range.firstCollision;
+        if (range.collisionCount > 0) {
+            buffer.ranges.push_back(range);
+        }
+    }, this);
+
+    m_narrowPhaseRanges.clear();
+    size_t collisionCount = 0;
+    for (NarrowPhaseBuffer const& buffer : m_narrowPhaseBuffers) {
+        m_narrowPhaseRanges.insert(m_narrowPhaseRanges.end(), buffer.ranges.begin(), buffer.ranges.end());
+        collisionCount += buffer.collisions.size();
+    }
+    std::sort(m_narrowPhaseRanges.begin(), m_narrowPhaseRanges.end(),
+        [](NarrowPhaseRange const& a, NarrowPhaseRange const& b) { return a.firstPair < b.firstPair; });
+
+    m_collisions.reserve(collisionCount);
+    for (NarrowPhaseRange const& range : m_narrowPhaseRanges) {
+        std::vector<Collision2D> const& collisions = m_narrowPhaseBuffers[range.bufferIdx].collisions;
+        m_collisions.insert(m_collisions.end(), collisions.begin() + range.firstCollision,
+            collisions.begin() + range.firstCollision + range.collisionCount);
     }
 }
 
 //////////////////////////////////////////////////////////////////////////
-void Physics2D::ResolveCollisions()
+void Physics2D::DetectCollision(Collider2D* first, Collider2D* second, std::vector<Collision2D>& outCollisions) const
 {
-    for (size_t idx = 0; idx < m_collisions.size(); idx++) {
-        ResolveCollision(m_collisions[idx]);
+    Rigidbody2D* rigid1 = first->m_rigidbody;
+    Rigidbody2D* rigid2 = second->m_rigidbody;
+    if ( rigid1->IsDestroyed() || rigid2->IsDestroyed() ||
+        !rigid1->IsEnabled() || !rigid2->IsEnabled() ||
+        !DoLayersInteract(rigid1->GetLayer(), rigid2->GetLayer()) ||
+        IsPairSleeping(rigid1, rigid2)) {
+        return;
+    }
+
+    Manifold2 temp;
+    if (first->GetManifold(second, &temp)) {
+        Collision2D collision = Collision2D(first, second, temp);
+        outCollisions.push_back(collision);
     }
 }
 
 //////////////////////////////////////////////////////////////////////////
-void Physics2D::ResolveCollision(Collision2D& collision)
+void Physics2D::ResolveCollisions()
 {
-    if (collision.me->IsTrigger() || collision.other->IsTrigger()) {
+    //islands share no dynamic body, solving them apart gives the same result
+    //as one sweep over every contact, on as many workers as there are islands
+    BuildIslands();
+    if (!m_isSolverParallel) {
+        for (Island2D const& island : m_islands) {
+            SolveIsland(island);
+        }
         return;
     }
 
-    //sequential impulse, accumulate impulse at collision
-    for (int i = 0; i < APPLY_IMPULSE_ITERATIONS; i++) {
-        ApplyImpulseInCollision(collision);
+    ParallelForRanges(0, (int)m_islands.size(), 1, [](void* context, int participantIndex, int rangeBegin, int rangeEnd) {
+        (void)participantIndex;
+        Physics2D& physics = *(Physics2D*)context;
+        for (int islandIdx = rangeBegin; islandIdx < rangeEnd; islandIdx++) {
+            physics.SolveIsland(physics.m_islands[islandIdx]);
+        }
+    }, this);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Physics2D::SolveIsland(Island2D const& island)
+{
+    //sequential impulse, each iteration sweeps every contact of the island
+    //so impulses travel through stacks, warm starting begins from last step's answer
+    int const* collisionIndices = m_islandCollisions.data() + island.firstCollision;
+    if (m_isWarmStarting) {
+        for (int i = 0; i < island.collisionCount; i++) {
+            WarmStartCollision(m_collisions[collisionIndices[i]]);
+        }
+    }
+
+    for (int iteration = 0; iteration < m_solverIterations; iteration++) {
+        for (int i = 0; i < island.collisionCount; i++) {
+            ApplyImpulseInCollision(m_collisions[collisionIndices[i]]);
+        }
+    }
+
+    for (int i = 0; i < island.collisionCount; i++) {
+        ApplyBounceInCollision(m_collisions[collisionIndices[i]]);
     }
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool Physics2D::IsTriggerCollision(Collision2D const& collision) const
+{
+    return collision.me->IsTrigger() || collision.other->IsTrigger();
+}
 
-    //apply bounciness
+//////////////////////////////////////////////////////////////////////////
+void Physics2D::ApplyBounceInCollision(Collision2D& collision)
+{
     float bounceE = collision.me->GetBounceWith(collision.other);
     ApplyImpulseOnce(collision, collision.manifold.normal, bounceE*collision.manifold.bounceImpulse.x, collision.manifold.contact.start);
     if (!collision.manifold.contact.IsSegmentPoint()) {
@@ -415,6 +979,21 @@ void Physics2D::ResolveCollision(Collision2D& collision)
     }
 }
 
+//////////////////////////////////////////////////////////////////////////
+// applies the impulses taken from the contact cache up front, iterations
+// then only correct what changed since last step
+void Physics2D::WarmStartCollision(Collision2D& collision)
+{
+    Manifold2 const& manifold = collision.manifold;
+    Vec2 tangent = manifold.normal.GetRotated90Degrees();
+    ApplyImpulseOnce(collision, manifold.normal, manifold.bounceImpulse.x, manifold.contact.start);
+    ApplyImpulseOnce(collision, tangent, manifold.tangentImpulse.x, manifold.contact.start);
+    if (!manifold.contact.IsSegmentPoint()) {
+        ApplyImpulseOnce(collision, manifold.normal, manifold.bounceImpulse.y, manifold.contact.end);
+        ApplyImpulseOnce(collision, tangent, manifold.tangentImpulse.y, manifold.contact.end);
+    }
+}
+
 //////////////////////////////////////////////////////////////////////////
 void Physics2D::ApplyImpulseInCollision(Collision2D& collision)
 {
@@ -631,19 +1210,266 @@ float Physics2D::CalculateNormalImpulseFactor(Collision2D const& collision, Vec2
 }
 
 //////////////////////////////////////////////////////////////////////////
-void Physics2D::BeginSimulation()
+//Islands and sleeping
+//////////////////////////////////////////////////////////////////////////
+void Physics2D::SetSleepingEnabled(bool isEnabled)
+{
+    m_isSleepingEnabled = isEnabled;
+    if (!isEnabled) {
+        WakeAllSleepingIslands();
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Physics2D::WakeSleepingIsland(int sleepingIslandIdx)
 {
-    for (size_t idx = 0; idx < m_rigidbodies.size(); idx++) {
-        Rigidbody2D* rigidbody = m_rigidbodies[idx];
-        if (rigidbody != nullptr && !rigidbody->IsDestroyed()) {
-            rigidbody->BeginSimulation();
+    if (sleepingIslandIdx < 0) {
+        return;
+    }
+
+    std::vector<Rigidbody2D*>& bodies = m_sleepingIslands[sleepingIslandIdx];
+    for (Rigidbody2D* rigidbody : bodies) {
+        rigidbody->m_isAwake = true;
+        rigidbody->m_sleepSeconds = 0.f;
+        rigidbody->m_sleepingIslandIdx = -1;
+        rigidbody->UpdateStoreFlags();
+    }
+    m_sleepingBodyCount -= (int)bodies.size();
+    bodies.clear();
+    m_freeSleepingIslands.push_back(sleepingIslandIdx);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Physics2D::WakeTouchingBodies(Rigidbody2D* rigidbody)
+{
+    Collider2D const* collider = rigidbody->GetCollider();
+    if (collider == nullptr || m_sleepingBodyCount == 0) {
+        return;
+    }
+
+    //rare, scanning the cache beats keeping per body contact lists
+    for (int slotIdx = 0; slotIdx < m_contactCache.GetCapacity(); slotIdx++) {
+        ContactCache2D::Entry const& entry = m_contactCache.GetEntryAt(slotIdx);
+        if (entry.IsEmpty()) {
+            continue;
+        }
+        if (entry.collision.me == collider) {
+            entry.collision.other->m_rigidbody->WakeUp();
+        }
+        else if (entry.collision.other == collider) {
+            entry.collision.me->m_rigidbody->WakeUp();
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Physics2D::WakeAllSleepingIslands()
+{
+    for (int sleepingIslandIdx = 0; sleepingIslandIdx < (int)m_sleepingIslands.size(); sleepingIslandIdx++) {
+        if (!m_sleepingIslands[sleepingIslandIdx].empty()) {
+            WakeSleepingIsland(sleepingIslandIdx);
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Physics2D::WakeBodiesInContact()
+{
+    //narrow phase only reports sleeping bodies touched by something moving
+    if (m_sleepingBodyCount == 0) {
+        return;
+    }
+    for (Collision2D const& collision : m_collisions) {
+        if (!IsTriggerCollision(collision)) {
+            collision.me->m_rigidbody->WakeUp();
+            collision.other->m_rigidbody->WakeUp();
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// a sleeping body only needs testing against bodies that could move it
+bool Physics2D::IsPairSleeping(Rigidbody2D const* rigid1, Rigidbody2D const* rigid2) const
+{
+    if (rigid1->m_isAwake && rigid2->m_isAwake) {
+        return false;
+    }
+    return !CanWakeOthers(rigid1) && !CanWakeOthers(rigid2);
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool Physics2D::CanWakeOthers(Rigidbody2D const* rigidbody) const
+{
+    switch (rigidbody->m_mode) {
+    case eSimulationMode::DYNAMIC:
+        return rigidbody->m_isAwake;
+    case eSimulationMode::KINEMATIC:
+        return rigidbody->GetVelocity() != Vec2::ZERO || m_bodyStore.m_angularVelocity[rigidbody->m_storeIdx] != 0.f;
+    default:
+        return false;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// union find over awake dynamic bodies joined by solid contacts, then
+// bodies and contacts grouped per island keeping their original order
+void Physics2D::BuildIslands()
+{
+    m_islandNodes.clear();
+    for (Rigidbody2D* rigidbody : m_rigidbodies) {
+        if (rigidbody == nullptr) {
+            continue;
+        }
+        rigidbody->m_islandIdx = -1;
+        if (rigidbody->m_mode == eSimulationMode::DYNAMIC && rigidbody->m_isAwake) {
+            rigidbody->m_islandIdx = (int)m_islandNodes.size();
+            m_islandNodes.push_back(rigidbody);
         }
     }
+
+    int nodeCount = (int)m_islandNodes.size();
+    m_awakeBodyCount = nodeCount;
+    m_islandParents.resize(nodeCount);
+    for (int nodeIdx = 0; nodeIdx < nodeCount; nodeIdx++) {
+        m_islandParents[nodeIdx] = nodeIdx;
+    }
+    for (Collision2D const& collision : m_collisions) {
+        int node1 = collision.me->m_rigidbody->m_islandIdx;
+        int node2 = collision.other->m_rigidbody->m_islandIdx;
+        if (node1 < 0 || node2 < 0 || IsTriggerCollision(collision)) {
+            continue;
+        }
+        int root1 = FindIslandRoot(node1);
+        int root2 = FindIslandRoot(node2);
+        if (root1 != root2) {   //lower root wins, numbering below doesn't depend on contact order
+            m_islandParents[std::max(root1, root2)] = std::min(root1, root2);
+        }
+    }
+
+    //islands numbered by their first body, counting sort bodies then contacts
+    m_islands.clear();
+    m_islandRootToIsland.assign(nodeCount, -1);
+    for (int nodeIdx = 0; nodeIdx < nodeCount; nodeIdx++) {
+        int root = FindIslandRoot(nodeIdx);
+        if (m_islandRootToIsland[root] == -1) {
+            m_islandRootToIsland[root] = (int)m_islands.size();
+            m_islands.emplace_back();
+        }
+        m_islands[m_islandRootToIsland[root]].bodyCount++;
+    }
+    for (int nodeIdx = 0; nodeIdx < nodeCount; nodeIdx++) {
+        m_islandNodes[nodeIdx]->m_islandIdx = m_islandRootToIsland[FindIslandRoot(nodeIdx)];
+    }
+
+    m_islandCollisionOwners.resize(m_collisions.size());
+    for (size_t collisionIdx = 0; collisionIdx < m_collisions.size(); collisionIdx++) {
+        Collision2D const& collision = m_collisions[collisionIdx];
+        int islandIdx = -1;     //no awake dynamic body, nothing to push
+        if (!IsTriggerCollision(collision)) {
+            islandIdx = collision.me->m_rigidbody->m_islandIdx;
+            islandIdx = islandIdx < 0 ? collision.other->m_rigidbody->m_islandIdx : islandIdx;
+        }
+        m_islandCollisionOwners[collisionIdx] = islandIdx;
+        if (islandIdx >= 0) {
+            m_islands[islandIdx].collisionCount++;
+        }
+    }
+
+    int bodyOffset = 0;
+    int collisionOffset = 0;
+    for (Island2D& island : m_islands) {
+        island.firstBody = bodyOffset;
+        island.firstCollision = collisionOffset;
+        bodyOffset += island.bodyCount;
+        collisionOffset += island.collisionCount;
+        island.bodyCount = 0;
+        island.collisionCount = 0;
+    }
+    m_islandBodies.resize(bodyOffset);
+    m_islandCollisions.resize(collisionOffset);
+    for (Rigidbody2D* rigidbody : m_islandNodes) {
+        Island2D& island = m_islands[rigidbody->m_islandIdx];
+        m_islandBodies[island.firstBody + island.bodyCount++] = rigidbody;
+    }
+    for (int collisionIdx = 0; collisionIdx < (int)m_collisions.size(); collisionIdx++) {
+        int islandIdx = m_islandCollisionOwners[collisionIdx];
+        if (islandIdx >= 0) {
+            Island2D& island = m_islands[islandIdx];
+            m_islandCollisions[island.firstCollision + island.collisionCount++] = collisionIdx;
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+int Physics2D::FindIslandRoot(int nodeIdx)
+{
+    while (m_islandParents[nodeIdx] != nodeIdx) {
+        m_islandParents[nodeIdx] = m_islandParents[m_islandParents[nodeIdx]];  //path halving
+        nodeIdx = m_islandParents[nodeIdx];
+    }
+    return nodeIdx;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// an island sleeps once all of its bodies stayed slow for a while, one
+// restless body keeps the whole island awake
+void Physics2D::UpdateSleep(float deltaSeconds)
+{
+    if (!m_isSleepingEnabled) {
+        return;
+    }
+
+    float linearToleranceSquared = SLEEP_LINEAR_TOLERANCE * SLEEP_LINEAR_TOLERANCE;
+    for (Island2D const& island : m_islands) {
+        float minSleepSeconds = SLEEP_DELAY_SECONDS;
+        for (int bodyIdx = island.firstBody; bodyIdx < island.firstBody + island.bodyCount; bodyIdx++) {
+            Rigidbody2D* rigidbody = m_islandBodies[bodyIdx];
+            if (!rigidbody->m_canSleep || rigidbody->m_isDestroyed ||
+                rigidbody->GetVelocity().GetLengthSquared() > linearToleranceSquared ||
+                AbsFloat(m_bodyStore.m_angularVelocity[rigidbody->m_storeIdx]) > SLEEP_ANGULAR_TOLERANCE) {
+                rigidbody->m_sleepSeconds = 0.f;
+            }
+            else {
+                rigidbody->m_sleepSeconds += deltaSeconds;
+            }
+            minSleepSeconds = MinFloat(minSleepSeconds, rigidbody->m_sleepSeconds);
+        }
+
+        if (minSleepSeconds >= SLEEP_DELAY_SECONDS) {
+            PutIslandToSleep(island);
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Physics2D::PutIslandToSleep(Island2D const& island)
+{
+    int sleepingIslandIdx = (int)m_sleepingIslands.size();
+    if (!m_freeSleepingIslands.empty()) {
+        sleepingIslandIdx = m_freeSleepingIslands.back();
+        m_freeSleepingIslands.pop_back();
+    }
+    else {
+        m_sleepingIslands.emplace_back();
+    }
+
+    std::vector<Rigidbody2D*>& bodies = m_sleepingIslands[sleepingIslandIdx];
+    bodies.assign(m_islandBodies.begin() + island.firstBody, m_islandBodies.begin() + island.firstBody + island.bodyCount);
+    for (Rigidbody2D* rigidbody : bodies) {
+        rigidbody->m_isAwake = false;
+        rigidbody->m_sleepingIslandIdx = sleepingIslandIdx;
+        rigidbody->UpdateStoreFlags();
+        m_bodyStore.SetVelocity(rigidbody->m_storeIdx, Vec2::ZERO);
+        m_bodyStore.m_angularVelocity[rigidbody->m_storeIdx] = 0.f;
+    }
+    m_awakeBodyCount -= island.bodyCount;
+    m_sleepingBodyCount += island.bodyCount;
 }
 
 //////////////////////////////////////////////////////////////////////////
 void Physics2D::InsertCollider(Collider2D* collider)
 {
+    m_isBroadPhaseStale = true;
     for (size_t cIdx = 0; cIdx < m_colliders.size(); cIdx++)
     {
         if (m_colliders[cIdx] == nullptr)
@@ -673,6 +1499,7 @@ void Physics2D::CleanUpDestroyed()
     {
         if (m_rigidbodies[rIdx]!=nullptr && m_rigidbodies[rIdx]->m_isDestroyed)
         {
+            m_bodyStore.Remove(m_rigidbodies[rIdx]->m_handle);
             delete m_rigidbodies[rIdx];
             m_rigidbodies[rIdx] = nullptr;
         }
@@ -2,7 +2,14 @@
 
 #include "Engine/Math/Vec2.hpp"
 #include "Engine/Physics2D/Collision2D.hpp"
+#include "Engine/Physics2D/BroadPhase2D.hpp"
+#include "Engine/Physics2D/ContactCache2D.hpp"
+#include "Engine/Physics2D/ContactEvent2D.hpp"
+#include "Engine/Physics2D/RigidbodyStore2D.hpp"
+#include "Engine/Physics2D/SceneQuery2D.hpp"
+#include "Engine/Physics2D/StepProfiler2D.hpp"
 #include "Engine/Core/Delegate.hpp"
+#include "Engine/Core/EngineCommon.hpp"
 #include <vector>
 
 class Rigidbody2D;
@@ -16,6 +23,8 @@ static constexpr int PHYSICS_LAYER_COUNT = 32;
 
 class Physics2D
 {
+	friend class Rigidbody2D;
+
 public:
 	Delegate<float> onFixedUpdate;
 
@@ -23,7 +32,7 @@ public:
 	Physics2D();
 	~Physics2D();
 
-	void Startup();
+	void Startup(eBroadPhase2DType broadPhaseType = BROAD_PHASE_AABB_TREE, float hashCellSize = 0.f);	//cell size 0 picks it from collider bounds
 	void BeginFrame();
 	void Update();
 	void EndFrame();
@@ -47,18 +56,78 @@ public:
 	// factory style create/destroy
 	Rigidbody2D* CreateRigidbody();
 	void DestroyRigidbody( Rigidbody2D* rb );
+	Rigidbody2D* GetRigidbody(RigidbodyHandle2D handle) const;	//nullptr once destroyed
 
 	PolygonCollider2D* CreatePolygonCollider( Vec2 const* points, unsigned int pointCount, bool isPointCloud = false );
 	DiscCollider2D* CreateDiscCollider( Vec2 const& localPosition, float radius );
 	void DestroyCollider( Collider2D* collider );
 
-private:
+	// one fixed step regardless of the clock, for tools and benchmarks
 	void AdvanceSimulation(float deltaSeconds);
-	void ApplyEffectors();
+
+	eBroadPhase2DType GetBroadPhaseType() const	{ return m_broadPhaseType; }
+	int GetCandidatePairCount() const			{ return m_candidatePairCount; }
+	int GetCollisionCount() const				{ return (int)m_collisions.size(); }
+	std::vector<Collision2D> const& GetCollisions() const	{ return m_collisions; }
+
+	void SetNarrowPhaseParallel(bool isParallel)	{ m_isNarrowPhaseParallel = isParallel; }
+	bool IsNarrowPhaseParallel() const			{ return m_isNarrowPhaseParallel; }
+
+	void SetWarmStarting(bool isWarmStarting)	{ m_isWarmStarting = isWarmStarting; }
+	bool IsWarmStarting() const					{ return m_isWarmStarting; }
+	void SetSolverIterations(int iterations)	{ m_solverIterations = iterations; }
+	int GetSolverIterations() const				{ return m_solverIterations; }
+	int GetCachedContactCount() const			{ return m_contactCache.GetCount(); }
+
+	void SetSolverParallel(bool isParallel)		{ m_isSolverParallel = isParallel; }
+	bool IsSolverParallel() const				{ return m_isSolverParallel; }
+	void SetSleepingEnabled(bool isEnabled);
+	bool IsSleepingEnabled() const				{ return m_isSleepingEnabled; }
+	int GetIslandCount() const					{ return (int)m_islands.size(); }
+	int GetAwakeBodyCount() const				{ return m_awakeBodyCount; }	//dynamic, as of the last step
+	int GetSleepingBodyCount() const			{ return m_sleepingBodyCount; }
+	int GetContinuousHitCount() const			{ return m_continuousHitCount; }	//bodies stopped at a time of impact last step
+	StepProfiler2D& GetProfiler()				{ return m_profiler; }	//per phase step times, off until enabled
+	StepProfiler2D const& GetProfiler() const	{ return m_profiler; }
+
+	// deferred events skip the delegates, contacts are queued as ContactEvent2D
+	// instead and no game code runs inside the step. Drain every frame. Turning
+	// deferral off leaves already queued events for one last drain, they are
+	// never replayed through the delegates
+	void SetEventsDeferred(bool isDeferred);
+	bool IsEventsDeferred() const				{ return m_isEventsDeferred; }
+	void DrainContactEvents(std::vector<ContactEvent2D>& outEvents);
+	int GetQueuedContactEventCount() const		{ return (int)m_contactEvents.size(); }
+
+	// called by Rigidbody2D
+	void WakeSleepingIsland(int sleepingIslandIdx);
+	void WakeTouchingBodies(Rigidbody2D* rigidbody);
+
+	// scene queries through the broad phase, against the world as it is between steps.
+	// Triggers, disabled bodies and layers outside the mask are skipped
+	bool Raycast(Vec2 const& start, Vec2 const& direction, float maxDistance, RaycastHit2D& outHit, unsigned int layerMask = PHYSICS_ALL_LAYERS);
+	void RaycastBatch(RaycastQuery2D const* queries, int queryCount, RaycastHit2D* outHits);	//spread over the job system
+	int OverlapAABB(AABB2 const& bounds, std::vector<Collider2D*>& outColliders, unsigned int layerMask = PHYSICS_ALL_LAYERS);
+	int OverlapDisc(Vec2 const& center, float radius, std::vector<Collider2D*>& outColliders, unsigned int layerMask = PHYSICS_ALL_LAYERS);
+	bool ShapeCast(Disc2 const& disc, Vec2 const& direction, float maxDistance, RaycastHit2D& outHit, unsigned int layerMask = PHYSICS_ALL_LAYERS);	//disc swept until it first touches
+
+private:
 	void MoveRigidbodies(float deltaSeconds);
+	void SolveContinuousCollisions();
+	void QueryColliders(AABB2 const& bounds, std::vector<unsigned int>& outColliderIdxs) const;
+	void QueryCollidersOnSegment(Vec2 const& start, Vec2 const& end, std::vector<unsigned int>& outColliderIdxs) const;
+	void RefreshBroadPhase();
+	bool IsQueryable(Collider2D const* collider, unsigned int layerMask) const;
+	bool RaycastWithScratch(RaycastQuery2D const& query, RaycastHit2D& outHit, std::vector<unsigned int>& scratchIdxs) const;
 	void DetectCollisions();
+	void DetectCollisionsInParallel();
+	void DetectCollision(Collider2D* first, Collider2D* second, std::vector<Collision2D>& outCollisions) const;
 	void ResolveCollisions();
-	void ResolveCollision(Collision2D& collision);
+	void BuildIslands();
+	int FindIslandRoot(int nodeIdx);
+	bool IsTriggerCollision(Collision2D const& collision) const;
+	void WarmStartCollision(Collision2D& collision);
+	void ApplyBounceInCollision(Collision2D& collision);
 	void ApplyImpulseInCollision(Collision2D& collision);
 	void ApplyImpulseOnce(Collision2D& collision, Vec2 const& impulseBase, float impulseFactor, Vec2 const& contact);
 	void CorrectObjectsInCollision(Collision2D& collision);
@@ -67,7 +136,20 @@ private:
 	float CalculateTangentImpulse(Collision2D const& collision, Vec2 const& contact) const;
 	float CalculateNormalImpulseFactor(Collision2D const& collision, Vec2 const& contact) const;
 
-	void BeginSimulation();
+	void AppendAndFireEventsForNewCollision(Collision2D& collision);
+	void EraseAndFireEventsForOldCollision(Collision2D const& collision);
+	void FireEventsForOldCollision(Collision2D const& collision);
+	void PushContactEvent(eContactEventType type, Collision2D const& collision);
+	void CleanUpPastCollisions();
+	void TakeCachedImpulses(Collision2D& collision, ContactCache2D::Entry const& entry) const;
+	void StoreImpulsesInCache();
+
+	void WakeAllSleepingIslands();
+	void WakeBodiesInContact();
+	bool IsPairSleeping(Rigidbody2D const* rigid1, Rigidbody2D const* rigid2) const;
+	bool CanWakeOthers(Rigidbody2D const* rigidbody) const;
+	void UpdateSleep(float deltaSeconds);
+
 	void InsertCollider(Collider2D* collider);
 	void CleanUpDestroyed();
 
@@ -76,9 +158,75 @@ private:
 	double m_fixedDeltaTime = 1.0/120.0;
 	float m_gravityAcceleration = 9.8f;
 	std::vector<Collision2D> m_collisions;
+	ContactCache2D m_contactCache;				//for overlap and trigger enter/stay/leave, and warm starting
+	std::vector<ContactCache2D::Entry> m_staleContacts;
+	unsigned int m_stepIndex = 0;
+	bool m_isWarmStarting = true;
+	int m_solverIterations = APPLY_IMPULSE_ITERATIONS;
+	eBroadPhase2DType m_broadPhaseType = BROAD_PHASE_ALL_PAIRS;
+	BroadPhase2D* m_broadPhase = nullptr;
+	std::vector<ColliderPair2D> m_candidatePairs;
+	int m_candidatePairCount = 0;
 	unsigned int m_layerInteractions[PHYSICS_LAYER_COUNT];
 
+	//narrow phase, each ParallelFor participant fills its own buffer and
+	//remembers which pair ranges it did, merged back in pair order
+	struct NarrowPhaseRange
+	{
+		int firstPair = 0;
+		int bufferIdx = 0;
+		int firstCollision = 0;
+		int collisionCount = 0;
+	};
+	struct alignas(64) NarrowPhaseBuffer	//own cache line, participants push_back concurrently
+	{
+		std::vector<Collision2D> collisions;
+		std::vector<NarrowPhaseRange> ranges;
+	};
+	bool m_isNarrowPhaseParallel = true;
+	bool m_isSolverParallel = true;
+	std::vector<NarrowPhaseBuffer> m_narrowPhaseBuffers;
+	std::vector<NarrowPhaseRange> m_narrowPhaseRanges;
+
+	//bodies joined by contacts, solved and put to sleep together
+	struct Island2D
+	{
+		int firstBody = 0;			//into m_islandBodies
+		int bodyCount = 0;
+		int firstCollision = 0;		//into m_islandCollisions
+		int collisionCount = 0;
+	};
+	void SolveIsland(Island2D const& island);
+	void PutIslandToSleep(Island2D const& island);
+
+	std::vector<Rigidbody2D*> m_islandNodes;		//awake dynamic bodies this step
+	std::vector<int> m_islandParents;			//union find over m_islandNodes
+	std::vector<int> m_islandRootToIsland;
+	std::vector<int> m_islandCollisionOwners;	//island per m_collisions entry, -1 if none
+	std::vector<Island2D> m_islands;
+	std::vector<Rigidbody2D*> m_islandBodies;
+	std::vector<int> m_islandCollisions;		//indices into m_collisions
+	bool m_isSleepingEnabled = true;
+	bool m_isEventsDeferred = false;
+	std::vector<ContactEvent2D> m_contactEvents;	//since the last drain
+	int m_awakeBodyCount = 0;
+	int m_sleepingBodyCount = 0;
+	int m_continuousHitCount = 0;
+	StepProfiler2D m_profiler;
+	std::vector<unsigned int> m_queryResults;
+
+	//broad phase bounds lag behind once bodies moved, queries update it first
+	bool m_isBroadPhaseStale = true;
+	struct alignas(64) QueryScratch		//per RaycastBatch participant
+	{
+		std::vector<unsigned int> colliderIdxs;
+	};
+	std::vector<QueryScratch> m_queryScratch;
+	std::vector<std::vector<Rigidbody2D*>> m_sleepingIslands;
+	std::vector<int> m_freeSleepingIslands;
+
 public:
+	RigidbodyStore2D m_bodyStore;	//motion state of every rigidbody, packed for integration
 	std::vector<Rigidbody2D*> m_rigidbodies;
 	std::vector<Collider2D*> m_colliders;
 };
\ No newline at end of file
@@ -0,0 +1,677 @@
+#include "Engine/Physics2D/Physics2D.hpp"
+#include "Engine/Physics2D/Rigidbody2D.hpp"
+#include "Engine/Physics2D/DiscCollider2D.hpp"
+#include "Engine/Physics2D/PolygonCollider2D.hpp"
+#include "Engine/Physics2D/PhysicsMaterial.hpp"
+#include "Engine/Physics2D/RigidbodyStore2D.hpp"
+#include "Engine/Physics2D/Physics2DBenchmarkScenes.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/NamedProperties.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include <algorithm>
+#include <cstring>
+
+static constexpr int ALL_PAIRS_BENCHMARK_MAX_STEPS = 3;    //O(n^2), a few steps are enough to see it
+
+//////////////////////////////////////////////////////////////////////////
+// discs and boxes scattered over a wide floor, a third of them boxes
+static void BuildBroadPhaseBenchmarkScene(Physics2D& physics, int bodyCount)
+{
+    float width = SqrtFloat((float)bodyCount) * 8.f;
+    float height = width * .5f;
+    Vec2 floorPoints[4] = { Vec2(-.5f * width, -2.f), Vec2(.5f * width, -2.f), Vec2(.5f * width, 0.f), Vec2(-.5f * width, 0.f) };
+    CreateBenchmarkBody(physics, physics.CreatePolygonCollider(floorPoints, 4), Vec2::ZERO, eSimulationMode::STATIC);
+
+    RandomNumberGenerator rng;
+    rng.Reset(1234);
+    Vec2 boxPoints[4] = { Vec2(-.5f, -.5f), Vec2(.5f, -.5f), Vec2(.5f, .5f), Vec2(-.5f, .5f) };
+    for (int bodyIdx = 0; bodyIdx < bodyCount; bodyIdx++) {
+        Collider2D* collider = nullptr;
+        if (bodyIdx % 3 == 2) {
+            collider = physics.CreatePolygonCollider(boxPoints, 4);
+        }
+        else {
+            collider = physics.CreateDiscCollider(Vec2::ZERO, .5f);
+        }
+        Vec2 position(rng.RollRandomFloatInRange(-.5f * width + 1.f, .5f * width - 1.f), rng.RollRandomFloatInRange(1.f, height));
+        CreateBenchmarkBody(physics, collider, position, eSimulationMode::DYNAMIC);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// rows of walled bins on one floor, each holding a small pile that settles
+// on its own. Bins share only static bodies so each pile is its own island
+static void BuildBinsBenchmarkScene(Physics2D& physics, int binCount, int bodiesPerBin, PhysicsMaterial const& material)
+{
+    int columnCount = RoundDownToInt(SqrtFloat((float)bodiesPerBin));
+    float binWidth = (float)columnCount;
+    float binPitch = binWidth + 3.f;
+    float floorWidth = binPitch * (float)binCount;
+    Vec2 floorPoints[4] = { Vec2(-1.f, -1.f), Vec2(floorWidth + 1.f, -1.f), Vec2(floorWidth + 1.f, 0.f), Vec2(-1.f, 0.f) };
+    CreateBenchmarkBody(physics, physics.CreatePolygonCollider(floorPoints, 4), Vec2::ZERO, eSimulationMode::STATIC, material);
+
+    RandomNumberGenerator rng;
+    rng.Reset(5678);
+    float wallHeight = (float)(bodiesPerBin / columnCount + 2);
+    Vec2 wallPoints[4] = { Vec2(-.5f, 0.f), Vec2(.5f, 0.f), Vec2(.5f, wallHeight), Vec2(-.5f, wallHeight) };
+    Vec2 boxPoints[4] = { Vec2(-.45f, -.45f), Vec2(.45f, -.45f), Vec2(.45f, .45f), Vec2(-.45f, .45f) };
+    for (int binIdx = 0; binIdx < binCount; binIdx++) {
+        float binLeft = (float)binIdx * binPitch + 1.f;
+        CreateBenchmarkBody(physics, physics.CreatePolygonCollider(wallPoints, 4), Vec2(binLeft - .5f, 0.f), eSimulationMode::STATIC, material);
+        CreateBenchmarkBody(physics, physics.CreatePolygonCollider(wallPoints, 4), Vec2(binLeft + binWidth + .5f, 0.f), eSimulationMode::STATIC, material);
+        for (int bodyIdx = 0; bodyIdx < bodiesPerBin; bodyIdx++) {
+            Collider2D* collider = nullptr;
+            if (bodyIdx % 3 == 2) {
+                collider = physics.CreatePolygonCollider(boxPoints, 4);
+            }
+            else {
+                collider = physics.CreateDiscCollider(Vec2::ZERO, .5f);
+            }
+            Vec2 position(binLeft + .5f + (float)(bodyIdx % columnCount) + rng.RollRandomFloatInRange(-.02f, .02f),
+                .5f + (float)(bodyIdx / columnCount));
+            CreateBenchmarkBody(physics, collider, position, eSimulationMode::DYNAMIC, material);
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+COMMAND(physics_broadphase_benchmark, "candidate pairs and step time per broad phase over discs and polygons, bodies=10000 steps=60 cell=0", eEventFlag::EVENT_CONSOLE)
+{
+    int bodyCount = args.GetValue("bodies", 10000);
+    int stepCount = args.GetValue("steps", 60);
+    float cellSize = args.GetValue("cell", 0.f);    //spatial hash only, 0 picks it from the bodies
+    if (bodyCount <= 0 || stepCount <= 0) {
+        g_theConsole->PrintError(Stringf("bodies %i or steps %i invalid", bodyCount, stepCount));
+        return false;
+    }
+
+    char const* broadPhaseNames[NUM_BROAD_PHASE_TYPES] = { "all pairs", "aabb tree", "spatial hash" };
+    g_theConsole->PrintString(Rgba8(255, 255, 0), Stringf("%-12s %8s %12s %10s %10s", "broad phase", "steps", "pairs/step", "contacts", "ms/step"));
+    for (int typeIdx = 0; typeIdx < NUM_BROAD_PHASE_TYPES; typeIdx++) {
+        eBroadPhase2DType broadPhaseType = (eBroadPhase2DType)typeIdx;
+        int steps = broadPhaseType == BROAD_PHASE_ALL_PAIRS ? Clamp(stepCount, 1, ALL_PAIRS_BENCHMARK_MAX_STEPS) : stepCount;
+
+        Physics2D* physics = new Physics2D();
+        physics->Startup(broadPhaseType, cellSize);
+        BuildBroadPhaseBenchmarkScene(*physics, bodyCount);
+
+        double pairCount = 0.0;
+        double contactCount = 0.0;
+        double startTime = GetCurrentTimeSeconds();
+        for (int stepIdx = 0; stepIdx < steps; stepIdx++) {
+            physics->AdvanceSimulation((float)physics->GetFixedDeltaTime());
+            pairCount += (double)physics->GetCandidatePairCount();
+            contactCount += (double)physics->GetCollisionCount();
+        }
+        double elapsed = GetCurrentTimeSeconds() - startTime;
+        delete physics;
+
+        g_theConsole->PrintString(Rgba8::WHITE, Stringf("%-12s %8i %12.0f %10.1f %10.3f", broadPhaseNames[typeIdx], steps,
+            pairCount / (double)steps, contactCount / (double)steps, elapsed * 1000.0 / (double)steps));
+    }
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+COMMAND(physics_narrowphase_benchmark, "step time of a settling pile with serial and job system narrow phase, bodies=3000 steps=120", eEventFlag::EVENT_CONSOLE)
+{
+    int bodyCount = args.GetValue("bodies", 3000);
+    int stepCount = args.GetValue("steps", 120);
+    if (bodyCount <= 0 || stepCount <= 0) {
+        g_theConsole->PrintError(Stringf("bodies %i or steps %i invalid", bodyCount, stepCount));
+        return false;
+    }
+
+    char const* modeNames[2] = { "serial", "parallel" };
+    std::vector<Vec2> finalPositions[2];
+    g_theConsole->PrintString(Rgba8(255, 255, 0), Stringf("%-12s %8s %12s %10s", "narrow phase", "steps", "contacts", "ms/step"));
+    for (int modeIdx = 0; modeIdx < 2; modeIdx++) {
+        Physics2D* physics = new Physics2D();
+        physics->Startup();
+        physics->SetNarrowPhaseParallel(modeIdx == 1);
+        BuildPileBenchmarkScene(*physics, bodyCount);
+
+        double contactCount = 0.0;
+        double startTime = GetCurrentTimeSeconds();
+        for (int stepIdx = 0; stepIdx < stepCount; stepIdx++) {
+            physics->AdvanceSimulation((float)physics->GetFixedDeltaTime());
+            contactCount += (double)physics->GetCollisionCount();
+        }
+        double elapsed = GetCurrentTimeSeconds() - startTime;
+        for (Rigidbody2D const* rigidbody : physics->m_rigidbodies) {
+            if (rigidbody != nullptr) {
+                finalPositions[modeIdx].push_back(rigidbody->GetWorldPosition());
+            }
+        }
+        delete physics;
+
+        g_theConsole->PrintString(Rgba8::WHITE, Stringf("%-12s %8i %12.1f %10.3f", modeNames[modeIdx], stepCount,
+            contactCount / (double)stepCount, elapsed * 1000.0 / (double)stepCount));
+    }
+
+    //bit exact, the merge keeps the serial collision order
+    bool isSame = finalPositions[0].size() == finalPositions[1].size() &&
+        std::equal(finalPositions[0].begin(), finalPositions[0].end(), finalPositions[1].begin(),
+            [](Vec2 const& a, Vec2 const& b) { return a.x == b.x && a.y == b.y; });
+    if (!isSame) {
+        g_theConsole->PrintError("parallel narrow phase diverged from serial");
+        return false;
+    }
+    g_theConsole->PrintString(Rgba8::GREEN, "final positions identical");
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+COMMAND(physics_warmstart_benchmark, "how far an inelastic pile settles per solver iteration count, cold and warm started, bodies=400 steps=480", eEventFlag::EVENT_CONSOLE)
+{
+    int bodyCount = args.GetValue("bodies", 400);
+    int stepCount = args.GetValue("steps", 480);
+    if (bodyCount <= 0 || stepCount <= 0) {
+        g_theConsole->PrintError(Stringf("bodies %i or steps %i invalid", bodyCount, stepCount));
+        return false;
+    }
+
+    //averaged over the last second, a settled pile is still and barely overlapping
+    int measureStart = stepCount - Clamp(stepCount, 1, 120);
+    int iterationCounts[4] = { 1, 2, 4, APPLY_IMPULSE_ITERATIONS };
+    g_theConsole->PrintString(Rgba8(255, 255, 0), Stringf("%-6s %10s %12s %14s %10s", "warm", "iterations", "avg speed", "avg overlap", "ms/step"));
+    for (int warmIdx = 0; warmIdx < 2; warmIdx++) {
+        for (int iterations : iterationCounts) {
+            Physics2D* physics = new Physics2D();
+            physics->Startup();
+            physics->SetWarmStarting(warmIdx == 1);
+            physics->SetSolverIterations(iterations);
+            BuildPileBenchmarkScene(*physics, bodyCount, PhysicsMaterial(0.f, .5f));
+
+            double speedSum = 0.0;
+            double penetrationSum = 0.0;
+            int speedCount = 0;
+            int penetrationCount = 0;
+            double startTime = GetCurrentTimeSeconds();
+            for (int stepIdx = 0; stepIdx < stepCount; stepIdx++) {
+                physics->AdvanceSimulation((float)physics->GetFixedDeltaTime());
+                if (stepIdx < measureStart) {
+                    continue;
+                }
+                for (Rigidbody2D const* rigidbody : physics->m_rigidbodies) {
+                    if (rigidbody != nullptr && rigidbody->GetSimulationMode() == eSimulationMode::DYNAMIC) {
+                        speedSum += (double)rigidbody->GetVelocity().GetLength();
+                        speedCount++;
+                    }
+                }
+                for (Collision2D const& collision : physics->GetCollisions()) {
+                    penetrationSum += (double)collision.manifold.penetration;
+                    penetrationCount++;
+                }
+            }
+            double elapsed = GetCurrentTimeSeconds() - startTime;
+            delete physics;
+
+            g_theConsole->PrintString(Rgba8::WHITE, Stringf("%-6s %10i %12.4f %14.4f %10.3f", warmIdx == 1 ? "on" : "off", iterations,
+                speedSum / (double)(speedCount > 0 ? speedCount : 1), penetrationSum / (double)(penetrationCount > 0 ? penetrationCount : 1), elapsed * 1000.0 / (double)stepCount));
+        }
+    }
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+COMMAND(physics_sleep_benchmark, "step time of settling piles solved per island serially, on the job system and with sleeping, bins=20 bodies=100 steps=900", eEventFlag::EVENT_CONSOLE)
+{
+    int binCount = args.GetValue("bins", 20);
+    int bodiesPerBin = args.GetValue("bodies", 100);
+    int stepCount = args.GetValue("steps", 900);
+    if (binCount <= 0 || bodiesPerBin <= 0 || stepCount <= 0) {
+        g_theConsole->PrintError(Stringf("bins %i, bodies %i or steps %i invalid", binCount, bodiesPerBin, stepCount));
+        return false;
+    }
+
+    //timed over the last second, by then most piles came to rest
+    int measureStart = stepCount - Clamp(stepCount, 1, 120);
+    char const* modeNames[3] = { "serial", "parallel", "sleeping" };
+    std::vector<Vec2> finalPositions[2];
+    g_theConsole->PrintString(Rgba8(255, 255, 0), Stringf("%-10s %8s %10s %10s %10s", "solver", "islands", "awake", "asleep", "ms/step"));
+    for (int modeIdx = 0; modeIdx < 3; modeIdx++) {
+        Physics2D* physics = new Physics2D();
+        physics->Startup(BROAD_PHASE_SPATIAL_HASH);
+        physics->SetSolverParallel(modeIdx != 0);
+        physics->SetSleepingEnabled(modeIdx == 2);
+        BuildBinsBenchmarkScene(*physics, binCount, bodiesPerBin, PhysicsMaterial(0.f, .5f));
+
+        double measuredTime = 0.0;
+        for (int stepIdx = 0; stepIdx < stepCount; stepIdx++) {
+            double startTime = GetCurrentTimeSeconds();
+            physics->AdvanceSimulation((float)physics->GetFixedDeltaTime());
+            if (stepIdx >= measureStart) {
+                measuredTime += GetCurrentTimeSeconds() - startTime;
+            }
+        }
+        if (modeIdx < 2) {
+            for (Rigidbody2D const* rigidbody : physics->m_rigidbodies) {
+                if (rigidbody != nullptr) {
+                    finalPositions[modeIdx].push_back(rigidbody->GetWorldPosition());
+                }
+            }
+        }
+
+        g_theConsole->PrintString(Rgba8::WHITE, Stringf("%-10s %8i %10i %10i %10.3f", modeNames[modeIdx], physics->GetIslandCount(),
+            physics->GetAwakeBodyCount(), physics->GetSleepingBodyCount(), measuredTime * 1000.0 / (double)(stepCount - measureStart)));
+        delete physics;
+    }
+
+    //islands share no dynamic body, solving them apart changes nothing
+    bool isSame = finalPositions[0].size() == finalPositions[1].size() &&
+        std::equal(finalPositions[0].begin(), finalPositions[0].end(), finalPositions[1].begin(),
+            [](Vec2 const& a, Vec2 const& b) { return a.x == b.x && a.y == b.y; });
+    if (!isSame) {
+        g_theConsole->PrintError("parallel island solve diverged from serial");
+        return false;
+    }
+    g_theConsole->PrintString(Rgba8::GREEN, "final positions identical");
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+COMMAND(physics_wake_check, "a box asleep on a static floor has to wake and fall once the floor is set, moved or rotated away, steps=600", eEventFlag::EVENT_CONSOLE)
+{
+    int stepCount = args.GetValue("steps", 600);
+    if (stepCount <= 0) {
+        g_theConsole->PrintError(Stringf("steps %i invalid", stepCount));
+        return false;
+    }
+
+    char const* moveNames[3] = { "set position", "move", "rotate" };
+    Vec2 floorPoints[4] = { Vec2(-4.f, -1.f), Vec2(4.f, -1.f), Vec2(4.f, 0.f), Vec2(-4.f, 0.f) };
+    Vec2 boxPoints[4] = { Vec2(-.5f, -.5f), Vec2(.5f, -.5f), Vec2(.5f, .5f), Vec2(-.5f, .5f) };
+    bool isPassed = true;
+    for (int moveIdx = 0; moveIdx < 3; moveIdx++) {
+        Physics2D* physics = new Physics2D();
+        physics->Startup(BROAD_PHASE_AABB_TREE);
+        physics->SetSleepingEnabled(true);
+        Rigidbody2D* floor = CreateBenchmarkBody(*physics, physics->CreatePolygonCollider(floorPoints, 4), Vec2::ZERO, eSimulationMode::STATIC);
+        Rigidbody2D* box = CreateBenchmarkBody(*physics, physics->CreatePolygonCollider(boxPoints, 4), Vec2(2.f, .5f), eSimulationMode::DYNAMIC);
+
+        for (int stepIdx = 0; stepIdx < stepCount && box->IsAwake(); stepIdx++) {
+            physics->AdvanceSimulation((float)physics->GetFixedDeltaTime());
+        }
+        if (box->IsAwake()) {
+            g_theConsole->PrintError(Stringf("%s: box never fell asleep in %i steps", moveNames[moveIdx], stepCount));
+            delete physics;
+            return false;
+        }
+
+        float restHeight = box->GetWorldPosition().y;
+        if (moveIdx == 0) {
+            floor->SetPosition(Vec2(0.f, -5.f));
+        }
+        else if (moveIdx == 1) {
+            floor->Move(Vec2(0.f, -5.f));
+        }
+        else {
+            floor->SetRotationInRadius(90.f);   //stands on end, the box is off to its side
+        }
+        bool isWoken = box->IsAwake();
+        int fallStepCount = RoundDownToInt(.5f / (float)physics->GetFixedDeltaTime());   //over a meter of free fall
+        for (int stepIdx = 0; stepIdx < fallStepCount; stepIdx++) {
+            physics->AdvanceSimulation((float)physics->GetFixedDeltaTime());
+        }
+        float fallDistance = restHeight - box->GetWorldPosition().y;
+        bool isFallen = isWoken && fallDistance > .5f;
+        g_theConsole->PrintString(isFallen ? Rgba8::WHITE : Rgba8::RED, Stringf("%-13s woken %-5s fell %.3f", moveNames[moveIdx], isWoken ? "true" : "false", fallDistance));
+        isPassed = isPassed && isFallen;
+        delete physics;
+    }
+
+    if (!isPassed) {
+        g_theConsole->PrintError("a sleeping box ignored its floor moving away");
+        return false;
+    }
+    g_theConsole->PrintString(Rgba8::GREEN, "sleeping bodies wake when their static floor moves");
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+COMMAND(physics_integration_benchmark, "gravity, drag and euler step over the packed body store, scalar and SSE, bodies=1000000 steps=30", eEventFlag::EVENT_CONSOLE)
+{
+    int bodyCount = args.GetValue("bodies", 1000000);
+    int stepCount = args.GetValue("steps", 30);
+    if (bodyCount <= 0 || stepCount <= 0) {
+        g_theConsole->PrintError(Stringf("bodies %i or steps %i invalid", bodyCount, stepCount));
+        return false;
+    }
+
+    //same bodies twice, one store per path, so their results can be compared
+    RigidbodyStore2D* stores[2] = { new RigidbodyStore2D(), new RigidbodyStore2D() };
+    RandomNumberGenerator rng;
+    rng.Reset(4321);
+    for (int bodyIdx = 0; bodyIdx < bodyCount; bodyIdx++) {
+        Vec2 position(rng.RollRandomFloatInRange(-500.f, 500.f), rng.RollRandomFloatInRange(0.f, 500.f));
+        Vec2 velocity(rng.RollRandomFloatInRange(-5.f, 5.f), rng.RollRandomFloatInRange(-5.f, 5.f));
+        float mass = rng.RollRandomFloatInRange(.5f, 2.f);
+        float drag = rng.RollRandomFloatInRange(0.f, .2f);
+        unsigned char flags = BODY_FLAG_ACTIVE | BODY_FLAG_INTEGRATE;
+        if (bodyIdx % 8 != 7) {     //a few kinematic ones in between
+            flags |= BODY_FLAG_FORCES;
+        }
+        for (RigidbodyStore2D* store : stores) {
+            store->Add(nullptr);
+            store->SetPosition(bodyIdx, position);
+            store->SetVelocity(bodyIdx, velocity);
+            store->m_mass[bodyIdx] = mass;
+            store->m_massInverse[bodyIdx] = 1.f / mass;
+            store->m_drag[bodyIdx] = drag;
+            store->m_angularVelocity[bodyIdx] = velocity.x;
+            store->m_flags[bodyIdx] = flags;
+        }
+    }
+
+    char const* pathNames[2] = { "scalar", "sse" };
+    Vec2 gravityAcceleration(0.f, -9.8f);
+    float deltaSeconds = 1.f / 120.f;
+    g_theConsole->PrintString(Rgba8(255, 255, 0), Stringf("%-8s %10s %12s %14s", "path", "ms/step", "ns/body", "M bodies/s"));
+    for (int pathIdx = 0; pathIdx < 2; pathIdx++) {
+        double startTime = GetCurrentTimeSeconds();
+        for (int stepIdx = 0; stepIdx < stepCount; stepIdx++) {
+            if (pathIdx == 0) {
+                stores[pathIdx]->IntegrateScalar(gravityAcceleration, deltaSeconds);
+            }
+            else {
+                stores[pathIdx]->Integrate(gravityAcceleration, deltaSeconds);
+            }
+        }
+        double secondsPerStep = (GetCurrentTimeSeconds() - startTime) / (double)stepCount;
+        g_theConsole->PrintString(Rgba8::WHITE, Stringf("%-8s %10.3f %12.3f %14.1f", pathNames[pathIdx], secondsPerStep * 1000.0,
+            secondsPerStep * 1.0e9 / (double)bodyCount, (double)bodyCount / secondsPerStep * 1.0e-6));
+    }
+
+    bool isSame = true;
+    for (int bodyIdx = 0; bodyIdx < bodyCount && isSame; bodyIdx++) {
+        isSame = stores[0]->m_positionX[bodyIdx] == stores[1]->m_positionX[bodyIdx] && stores[0]->m_positionY[bodyIdx] == stores[1]->m_positionY[bodyIdx] &&
+            stores[0]->m_velocityX[bodyIdx] == stores[1]->m_velocityX[bodyIdx] && stores[0]->m_velocityY[bodyIdx] == stores[1]->m_velocityY[bodyIdx] &&
+            stores[0]->m_rotation[bodyIdx] == stores[1]->m_rotation[bodyIdx];
+    }
+    delete stores[0];
+    delete stores[1];
+    if (!isSame) {
+        g_theConsole->PrintError("vector integration diverged from scalar");
+        return false;
+    }
+    g_theConsole->PrintString(Rgba8::GREEN, "results identical");
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// counts what a game listener would see, one subscription per body
+struct ContactEventCounter
+{
+    int m_counts[4] = {};
+
+    void OnStart(Collision2D const&)    { m_counts[CONTACT_EVENT_BEGIN]++; }
+    void OnStay(Collision2D const&)     { m_counts[CONTACT_EVENT_STAY]++; }
+    void OnStop(Collision2D const&)     { m_counts[CONTACT_EVENT_END]++; }
+    void OnHit(Collision2D const&)      { m_counts[CONTACT_EVENT_HIT]++; }
+};
+
+//////////////////////////////////////////////////////////////////////////
+COMMAND(physics_event_benchmark, "step time of a pile with contact delegates fired inline and with deferred event buffers drained per step, bodies=2000 steps=240", eEventFlag::EVENT_CONSOLE)
+{
+    int bodyCount = args.GetValue("bodies", 2000);
+    int stepCount = args.GetValue("steps", 240);
+    if (bodyCount <= 0 || stepCount <= 0) {
+        g_theConsole->PrintError(Stringf("bodies %i or steps %i invalid", bodyCount, stepCount));
+        return false;
+    }
+
+    char const* modeNames[2] = { "inline", "deferred" };
+    int counts[2][4] = {};
+    g_theConsole->PrintString(Rgba8(255, 255, 0), Stringf("%-10s %10s %10s %10s %10s %10s", "events", "begin", "stay", "end", "hit", "ms/step"));
+    for (int modeIdx = 0; modeIdx < 2; modeIdx++) {
+        Physics2D* physics = new Physics2D();
+        physics->Startup();
+        physics->SetEventsDeferred(modeIdx == 1);
+        BuildPileBenchmarkScene(*physics, bodyCount, PhysicsMaterial(0.f, .5f));
+
+        ContactEventCounter counter;
+        if (modeIdx == 0) {
+            for (Rigidbody2D* rigidbody : physics->m_rigidbodies) {
+                rigidbody->onOverlapStart.SubscribeMethod(&counter, &ContactEventCounter::OnStart);
+                rigidbody->onOverlapStay.SubscribeMethod(&counter, &ContactEventCounter::OnStay);
+                rigidbody->onOverlapStop.SubscribeMethod(&counter, &ContactEventCounter::OnStop);
+                rigidbody->onCollision.SubscribeMethod(&counter, &ContactEventCounter::OnHit);
+            }
+        }
+
+        //deferred events are one per pair, counted twice to match a listener on both bodies
+        std::vector<ContactEvent2D> events;
+        double startTime = GetCurrentTimeSeconds();
+        for (int stepIdx = 0; stepIdx < stepCount; stepIdx++) {
+            physics->AdvanceSimulation((float)physics->GetFixedDeltaTime());
+            physics->DrainContactEvents(events);
+            for (ContactEvent2D const& contactEvent : events) {
+                counter.m_counts[contactEvent.type] += 2;
+            }
+        }
+        double elapsed = GetCurrentTimeSeconds() - startTime;
+        delete physics;
+
+        memcpy(counts[modeIdx], counter.m_counts, sizeof(counter.m_counts));
+        g_theConsole->PrintString(Rgba8::WHITE, Stringf("%-10s %10i %10i %10i %10i %10.3f", modeNames[modeIdx], counts[modeIdx][CONTACT_EVENT_BEGIN],
+            counts[modeIdx][CONTACT_EVENT_STAY], counts[modeIdx][CONTACT_EVENT_END], counts[modeIdx][CONTACT_EVENT_HIT], elapsed * 1000.0 / (double)stepCount));
+    }
+
+    if (memcmp(counts[0], counts[1], sizeof(counts[0])) != 0) {
+        g_theConsole->PrintError("deferred events don't match the delegates");
+        return false;
+    }
+    g_theConsole->PrintString(Rgba8::GREEN, "event counts match");
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+COMMAND(physics_ccd_benchmark, "fast discs fired at a thin wall without and with continuous collision, bodies=1000 speed=200 steps=120", eEventFlag::EVENT_CONSOLE)
+{
+    int bodyCount = args.GetValue("bodies", 1000);
+    float speed = args.GetValue("speed", 200.f);
+    int stepCount = args.GetValue("steps", 120);
+    if (bodyCount <= 0 || stepCount <= 0 || speed <= 0.f) {
+        g_theConsole->PrintError(Stringf("bodies %i, speed %.1f or steps %i invalid", bodyCount, speed, stepCount));
+        return false;
+    }
+
+    //one disc per row so they only meet the wall, a few steps away from it at random offsets
+    float wallHeight = (float)bodyCount + 2.f;
+    Vec2 wallPoints[4] = { Vec2(0.f, -1.f), Vec2(.1f, -1.f), Vec2(.1f, wallHeight), Vec2(0.f, wallHeight) };
+
+    char const* modeNames[2] = { "discrete", "continuous" };
+    int tunnelledCounts[2] = {};
+    g_theConsole->PrintString(Rgba8(255, 255, 0), Stringf("%-12s %10s %10s %10s", "collision", "tunnelled", "toi hits", "ms/step"));
+    for (int modeIdx = 0; modeIdx < 2; modeIdx++) {
+        Physics2D* physics = new Physics2D();
+        physics->Startup();
+        physics->SetSceneGravity(0.f);
+        physics->SetSleepingEnabled(false);
+        CreateBenchmarkBody(*physics, physics->CreatePolygonCollider(wallPoints, 4), Vec2::ZERO, eSimulationMode::STATIC);
+        float stepMove = speed * (float)physics->GetFixedDeltaTime();
+        RandomNumberGenerator rng;
+        rng.Reset(1234);
+        for (int bodyIdx = 0; bodyIdx < bodyCount; bodyIdx++) {
+            Vec2 position(-rng.RollRandomFloatInRange(3.f, 4.f) * stepMove, (float)bodyIdx);
+            Rigidbody2D* rigidbody = CreateBenchmarkBody(*physics, physics->CreateDiscCollider(Vec2::ZERO, .25f), position, eSimulationMode::DYNAMIC);
+            rigidbody->SetVelocity(Vec2(speed, 0.f));
+            rigidbody->SetContinuousCollision(modeIdx == 1);
+        }
+
+        int hitCount = 0;
+        double startTime = GetCurrentTimeSeconds();
+        for (int stepIdx = 0; stepIdx < stepCount; stepIdx++) {
+            physics->AdvanceSimulation((float)physics->GetFixedDeltaTime());
+            hitCount += physics->GetContinuousHitCount();
+        }
+        double elapsed = GetCurrentTimeSeconds() - startTime;
+
+        for (Rigidbody2D const* rigidbody : physics->m_rigidbodies) {
+            if (rigidbody != nullptr && rigidbody->GetSimulationMode() == eSimulationMode::DYNAMIC && rigidbody->GetWorldPosition().x > 0.f) {
+                tunnelledCounts[modeIdx]++;
+            }
+        }
+        delete physics;
+        g_theConsole->PrintString(Rgba8::WHITE, Stringf("%-12s %10i %10i %10.3f", modeNames[modeIdx], tunnelledCounts[modeIdx], hitCount, elapsed * 1000.0 / (double)stepCount));
+    }
+
+    if (tunnelledCounts[1] != 0) {
+        g_theConsole->PrintError(Stringf("%i discs went through the wall with continuous collision", tunnelledCounts[1]));
+        return false;
+    }
+    g_theConsole->PrintString(Rgba8::GREEN, "no disc tunnelled with continuous collision");
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// what game code did before scene queries, every collider tested in turn
+static bool RaycastAllColliders(Physics2D const& physics, RaycastQuery2D const& query, RaycastHit2D& outHit)
+{
+    outHit = RaycastHit2D();
+    Vec2 end = query.start + query.maxDistance * query.direction.GetNormalized();
+    float hitFraction = 1.f;
+    for (Collider2D* collider : physics.m_colliders) {
+        if (collider == nullptr || collider->IsTrigger() || !collider->m_rigidbody->IsEnabled()) {
+            continue;
+        }
+        float fraction = 0.f;
+        Vec2 normal;
+        if (collider->Raycast(query.start, end, 0.f, fraction, normal) && (fraction < hitFraction || outHit.collider == nullptr)) {
+            hitFraction = fraction;
+            outHit.collider = collider;
+        }
+    }
+    outHit.distance = hitFraction * query.maxDistance;
+    return outHit.DidHit();
+}
+
+//////////////////////////////////////////////////////////////////////////
+COMMAND(physics_query_benchmark, "line of sight rays and box overlaps per broad phase, against testing every collider, bodies=10000 rays=1000 length=30 steps=30", eEventFlag::EVENT_CONSOLE)
+{
+    int bodyCount = args.GetValue("bodies", 10000);
+    int rayCount = args.GetValue("rays", 1000);
+    float rayLength = args.GetValue("length", 30.f);
+    int stepCount = args.GetValue("steps", 30);
+    if (bodyCount <= 0 || rayCount <= 0 || rayLength <= 0.f || stepCount < 0) {
+        g_theConsole->PrintError(Stringf("bodies %i, rays %i, length %.1f or steps %i invalid", bodyCount, rayCount, rayLength, stepCount));
+        return false;
+    }
+
+    //rays between points over the scene, boxes around the starts
+    float width = SqrtFloat((float)bodyCount) * 8.f;
+    RandomNumberGenerator rng;
+    rng.Reset(4321);
+    std::vector<RaycastQuery2D> queries((size_t)rayCount);
+    for (RaycastQuery2D& query : queries) {
+        query.start = Vec2(rng.RollRandomFloatInRange(-.5f * width, .5f * width), rng.RollRandomFloatInRange(0.f, .5f * width));
+        query.direction = Vec2::MakeFromPolarDegrees(rng.RollRandomFloatInRange(0.f, 360.f));
+        query.maxDistance = rng.RollRandomFloatInRange(.1f, 1.f) * rayLength;
+    }
+
+    char const* broadPhaseNames[NUM_BROAD_PHASE_TYPES] = { "all pairs", "aabb tree", "spatial hash" };
+    std::vector<RaycastHit2D> referenceHits((size_t)rayCount);
+    std::vector<RaycastHit2D> hits((size_t)rayCount);
+    std::vector<Collider2D*> overlaps;
+    g_theConsole->PrintString(Rgba8(255, 255, 0), Stringf("%-12s %8s %12s %12s %12s %12s", "broad phase", "hits", "us/ray all", "us/ray", "us/ray batch", "us/overlap"));
+    for (int typeIdx = 0; typeIdx < NUM_BROAD_PHASE_TYPES; typeIdx++) {
+        Physics2D* physics = new Physics2D();
+        physics->Startup((eBroadPhase2DType)typeIdx);
+        BuildBroadPhaseBenchmarkScene(*physics, bodyCount);
+        for (int stepIdx = 0; stepIdx < stepCount; stepIdx++) {
+            physics->AdvanceSimulation((float)physics->GetFixedDeltaTime());
+        }
+        physics->OverlapAABB(AABB2(Vec2::ZERO, Vec2::ZERO), overlaps);    //first query after a step updates the broad phase, keep it out of the timings
+
+        double startTime = GetCurrentTimeSeconds();
+        int hitCount = 0;
+        for (int rayIdx = 0; rayIdx < rayCount; rayIdx++) {
+            hitCount += RaycastAllColliders(*physics, queries[rayIdx], referenceHits[rayIdx]) ? 1 : 0;
+        }
+        double allTime = GetCurrentTimeSeconds() - startTime;
+
+        startTime = GetCurrentTimeSeconds();
+        for (int rayIdx = 0; rayIdx < rayCount; rayIdx++) {
+            RaycastQuery2D const& query = queries[rayIdx];
+            physics->Raycast(query.start, query.direction, query.maxDistance, hits[rayIdx], query.layerMask);
+        }
+        double singleTime = GetCurrentTimeSeconds() - startTime;
+        for (int rayIdx = 0; rayIdx < rayCount; rayIdx++) {
+            if (hits[rayIdx].collider != referenceHits[rayIdx].collider) {
+                g_theConsole->PrintError(Stringf("%s ray %i hit another collider than testing all of them", broadPhaseNames[typeIdx], rayIdx));
+                delete physics;
+                return false;
+            }
+        }
+
+        startTime = GetCurrentTimeSeconds();
+        physics->RaycastBatch(queries.data(), rayCount, hits.data());
+        double batchTime = GetCurrentTimeSeconds() - startTime;
+        for (int rayIdx = 0; rayIdx < rayCount; rayIdx++) {
+            if (hits[rayIdx].collider != referenceHits[rayIdx].collider) {
+                g_theConsole->PrintError(Stringf("%s batched ray %i differs from the single query", broadPhaseNames[typeIdx], rayIdx));
+                delete physics;
+                return false;
+            }
+        }
+
+        startTime = GetCurrentTimeSeconds();
+        for (RaycastQuery2D const& query : queries) {
+            physics->OverlapAABB(AABB2(query.start - Vec2(2.f, 2.f), query.start + Vec2(2.f, 2.f)), overlaps);
+        }
+        double overlapTime = GetCurrentTimeSeconds() - startTime;
+        delete physics;
+
+        double rayScale = 1000000.0 / (double)rayCount;
+        g_theConsole->PrintString(Rgba8::WHITE, Stringf("%-12s %8i %12.2f %12.2f %12.2f %12.2f", broadPhaseNames[typeIdx], hitCount,
+            allTime * rayScale, singleTime * rayScale, batchTime * rayScale, overlapTime * rayScale));
+    }
+    g_theConsole->PrintString(Rgba8::GREEN, "scene queries hit the same colliders as testing every one");
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+COMMAND(physics_scene_benchmark, "ms and contacts per step of the canned pile, rain and tower scenes, scene=all bodies=2000 steps=300 broadphase=1 profile=false", eEventFlag::EVENT_CONSOLE)
+{
+    std::string sceneName = args.GetValue("scene", "all");
+    PhysicsSceneSettings2D settings;
+    settings.bodyCount = args.GetValue("bodies", settings.bodyCount);
+    settings.stepCount = args.GetValue("steps", settings.stepCount);
+    int broadPhaseType = args.GetValue("broadphase", (int)settings.broadPhaseType);
+    settings.isProfiled = args.GetValue("profile", false);
+    if (settings.bodyCount <= 0 || settings.stepCount <= 0 || broadPhaseType < 0 || broadPhaseType >= NUM_BROAD_PHASE_TYPES) {
+        g_theConsole->PrintError(Stringf("bodies %i, steps %i or broadphase %i invalid", settings.bodyCount, settings.stepCount, broadPhaseType));
+        return false;
+    }
+    settings.broadPhaseType = (eBroadPhase2DType)broadPhaseType;
+
+    int firstScene = 0;
+    int lastScene = NUM_PHYSICS_BENCHMARK_SCENES - 1;
+    if (sceneName != "all") {
+        firstScene = lastScene = GetBenchmarkSceneFromName(sceneName.c_str());
+        if (firstScene == NUM_PHYSICS_BENCHMARK_SCENES) {
+            g_theConsole->PrintError(Stringf("unknown scene %s, try pile, rain, tower or all", sceneName.c_str()));
+            return false;
+        }
+    }
+
+    g_theConsole->PrintString(Rgba8(255, 255, 0), Stringf("%-8s %8s %8s %10s %12s %8s %18s", "scene", "bodies", "steps", "ms/step", "contacts", "awake", "state hash"));
+    for (int sceneIdx = firstScene; sceneIdx <= lastScene; sceneIdx++) {
+        settings.scene = (ePhysicsBenchmarkScene2D)sceneIdx;
+        PhysicsSceneResult2D result = RunBenchmarkScene(settings);
+        g_theConsole->PrintString(Rgba8::WHITE, Stringf("%-8s %8i %8i %10.3f %12.1f %8i   %016llx", GetBenchmarkSceneName(settings.scene),
+            settings.bodyCount, result.stepCount, result.msPerStep, result.contactsPerStep, result.awakeBodyCount, result.stateHash));
+        if (settings.isProfiled) {
+            for (int phaseIdx = STEP_PHASE_TOTAL + 1; phaseIdx < NUM_STEP_PHASES; phaseIdx++) {
+                g_theConsole->PrintString(Rgba8(180, 180, 180), Stringf("    %-14s %8.3f ms", StepProfiler2D::GetPhaseName((eStepPhase2D)phaseIdx), result.phaseAverageMs[phaseIdx]));
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,209 @@
+#include "Engine/Physics2D/Physics2DBenchmarkScenes.hpp"
+#include "Engine/Physics2D/Physics2D.hpp"
+#include "Engine/Physics2D/Rigidbody2D.hpp"
+#include "Engine/Physics2D/DiscCollider2D.hpp"
+#include "Engine/Physics2D/PolygonCollider2D.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include <cstring>
+
+static constexpr int TOWER_BENCHMARK_HEIGHT = 10;   //boxes per column
+
+//////////////////////////////////////////////////////////////////////////
+Rigidbody2D* CreateBenchmarkBody(Physics2D& physics, Collider2D* collider, Vec2 const& position, eSimulationMode mode,
+    PhysicsMaterial const& material)
+{
+    Rigidbody2D* rigidbody = physics.CreateRigidbody();
+    collider->m_rigidbody = rigidbody;
+    collider->m_physicsMaterial = material;
+    rigidbody->TakeCollider(collider);
+    rigidbody->SetSimulationMode(mode);
+    rigidbody->SetPosition(position);
+    return rigidbody;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// discs and boxes packed in a bin, touching their neighbours from the start
+void BuildPileBenchmarkScene(Physics2D& physics, int bodyCount, PhysicsMaterial const& material)
+{
+    int columnCount = RoundDownToInt(SqrtFloat((float)bodyCount));
+    float width = (float)columnCount;
+    Vec2 floorPoints[4] = { Vec2(-.5f * width - 1.f, -1.f), Vec2(.5f * width + 1.f, -1.f), Vec2(.5f * width + 1.f, 0.f), Vec2(-.5f * width - 1.f, 0.f) };
+    CreateBenchmarkBody(physics, physics.CreatePolygonCollider(floorPoints, 4), Vec2::ZERO, eSimulationMode::STATIC, material);
+    float wallHeight = (float)(bodyCount / columnCount + 2);
+    Vec2 wallPoints[4] = { Vec2(-.5f, 0.f), Vec2(.5f, 0.f), Vec2(.5f, wallHeight), Vec2(-.5f, wallHeight) };
+    CreateBenchmarkBody(physics, physics.CreatePolygonCollider(wallPoints, 4), Vec2(-.5f * width - .5f, 0.f), eSimulationMode::STATIC, material);
+    CreateBenchmarkBody(physics, physics.CreatePolygonCollider(wallPoints, 4), Vec2(.5f * width + .5f, 0.f), eSimulationMode::STATIC, material);
+
+    RandomNumberGenerator rng;
+    rng.Reset(5678);
+    Vec2 boxPoints[4] = { Vec2(-.45f, -.45f), Vec2(.45f, -.45f), Vec2(.45f, .45f), Vec2(-.45f, .45f) };
+    for (int bodyIdx = 0; bodyIdx < bodyCount; bodyIdx++) {
+        Collider2D* collider = nullptr;
+        if (bodyIdx % 3 == 2) {
+            collider = physics.CreatePolygonCollider(boxPoints, 4);
+        }
+        else {
+            collider = physics.CreateDiscCollider(Vec2::ZERO, .5f);
+        }
+        Vec2 position(-.5f * width + .5f + (float)(bodyIdx % columnCount) + rng.RollRandomFloatInRange(-.02f, .02f),
+            .5f + (float)(bodyIdx / columnCount));
+        CreateBenchmarkBody(physics, collider, position, eSimulationMode::DYNAMIC, material);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// a square band of small discs and boxes thrown down on rows of pegs over a
+// floor. The top of the band lands a few seconds after the bottom, so
+// contacts keep starting and ending for most of the run
+void BuildRainBenchmarkScene(Physics2D& physics, int bodyCount)
+{
+    PhysicsMaterial material(.3f, .3f);
+    float width = SqrtFloat((float)bodyCount) * 1.5f + 4.f;
+    Vec2 floorPoints[4] = { Vec2(-.5f * width - 1.f, -1.f), Vec2(.5f * width + 1.f, -1.f), Vec2(.5f * width + 1.f, 0.f), Vec2(-.5f * width - 1.f, 0.f) };
+    CreateBenchmarkBody(physics, physics.CreatePolygonCollider(floorPoints, 4), Vec2::ZERO, eSimulationMode::STATIC, material);
+
+    Vec2 pegPoints[3] = { Vec2(-.5f, 0.f), Vec2(.5f, 0.f), Vec2(0.f, .5f) };
+    for (float pegY = 4.f; pegY < 12.f; pegY += 4.f) {
+        float rowOffset = pegY == 8.f ? 1.5f : 0.f;
+        for (float pegX = -.5f * width + 1.5f + rowOffset; pegX < .5f * width - 1.f; pegX += 3.f) {
+            CreateBenchmarkBody(physics, physics.CreatePolygonCollider(pegPoints, 3), Vec2(pegX, pegY), eSimulationMode::STATIC, material);
+        }
+    }
+
+    RandomNumberGenerator rng;
+    rng.Reset(2468);
+    Vec2 boxPoints[4] = { Vec2(-.25f, -.25f), Vec2(.25f, -.25f), Vec2(.25f, .25f), Vec2(-.25f, .25f) };
+    for (int bodyIdx = 0; bodyIdx < bodyCount; bodyIdx++) {
+        Collider2D* collider = nullptr;
+        if (bodyIdx % 4 == 3) {
+            collider = physics.CreatePolygonCollider(boxPoints, 4);
+        }
+        else {
+            collider = physics.CreateDiscCollider(Vec2::ZERO, .25f);
+        }
+        Vec2 position(rng.RollRandomFloatInRange(-.5f * width + .5f, .5f * width - .5f), 14.f + rng.RollRandomFloatInRange(0.f, width));
+        Rigidbody2D* rigidbody = CreateBenchmarkBody(physics, collider, position, eSimulationMode::DYNAMIC, material);
+        rigidbody->SetVelocity(Vec2(rng.RollRandomFloatInRange(-1.f, 1.f), -rng.RollRandomFloatInRange(10.f, 20.f)));
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// columns of unit boxes resting exactly on each other. How long they stand
+// before toppling and whether they ever sleep depend on the solver, a fallen
+// column costs about as much per step as a standing one
+void BuildTowerBenchmarkScene(Physics2D& physics, int bodyCount)
+{
+    PhysicsMaterial material(0.f, .8f);
+    int towerCount = (bodyCount + TOWER_BENCHMARK_HEIGHT - 1) / TOWER_BENCHMARK_HEIGHT;
+    float width = (float)towerCount * 2.f;
+    Vec2 floorPoints[4] = { Vec2(-1.f, -1.f), Vec2(width + 1.f, -1.f), Vec2(width + 1.f, 0.f), Vec2(-1.f, 0.f) };
+    CreateBenchmarkBody(physics, physics.CreatePolygonCollider(floorPoints, 4), Vec2::ZERO, eSimulationMode::STATIC, material);
+
+    Vec2 boxPoints[4] = { Vec2(-.5f, -.5f), Vec2(.5f, -.5f), Vec2(.5f, .5f), Vec2(-.5f, .5f) };
+    for (int bodyIdx = 0; bodyIdx < bodyCount; bodyIdx++) {
+        int towerIdx = bodyIdx / TOWER_BENCHMARK_HEIGHT;
+        int levelIdx = bodyIdx % TOWER_BENCHMARK_HEIGHT;
+        Vec2 position(.5f + (float)towerIdx * 2.f, .5f + (float)levelIdx);
+        CreateBenchmarkBody(physics, physics.CreatePolygonCollider(boxPoints, 4), position, eSimulationMode::DYNAMIC, material);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void BuildBenchmarkScene(Physics2D& physics, ePhysicsBenchmarkScene2D scene, int bodyCount)
+{
+    switch (scene) {
+    case PHYSICS_SCENE_PILE:
+        BuildPileBenchmarkScene(physics, bodyCount);
+        break;
+    case PHYSICS_SCENE_RAIN:
+        BuildRainBenchmarkScene(physics, bodyCount);
+        break;
+    case PHYSICS_SCENE_TOWER:
+        BuildTowerBenchmarkScene(physics, bodyCount);
+        break;
+    default:
+        break;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+PhysicsSceneResult2D RunBenchmarkScene(PhysicsSceneSettings2D const& settings)
+{
+    PhysicsSceneResult2D result;
+    if (settings.bodyCount <= 0 || settings.stepCount <= 0) {
+        return result;
+    }
+
+    Physics2D* physics = new Physics2D();
+    physics->Startup(settings.broadPhaseType);
+    physics->GetProfiler().SetName(GetBenchmarkSceneName(settings.scene));
+    physics->GetProfiler().SetEnabled(settings.isProfiled);
+    BuildBenchmarkScene(*physics, settings.scene, settings.bodyCount);
+
+    double contactCount = 0.0;
+    double pairCount = 0.0;
+    double startTime = GetCurrentTimeSeconds();
+    for (int stepIdx = 0; stepIdx < settings.stepCount; stepIdx++) {
+        physics->AdvanceSimulation((float)physics->GetFixedDeltaTime());
+        contactCount += (double)physics->GetCollisionCount();
+        pairCount += (double)physics->GetCandidatePairCount();
+    }
+    double elapsed = GetCurrentTimeSeconds() - startTime;
+
+    result.stepCount = settings.stepCount;
+    result.msPerStep = elapsed * 1000.0 / (double)settings.stepCount;
+    result.contactsPerStep = contactCount / (double)settings.stepCount;
+    result.pairsPerStep = pairCount / (double)settings.stepCount;
+    result.awakeBodyCount = physics->GetAwakeBodyCount();
+    result.stateHash = HashPhysicsState(*physics);
+    if (settings.isProfiled) {
+        for (int phaseIdx = 0; phaseIdx < NUM_STEP_PHASES; phaseIdx++) {
+            result.phaseAverageMs[phaseIdx] = physics->GetProfiler().GetPhaseStats((eStepPhase2D)phaseIdx).averageMs;
+        }
+    }
+    delete physics;
+    return result;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FNV-1a over the bits of every live body's position and rotation, equal
+// hashes mean the runs matched bit for bit
+unsigned long long HashPhysicsState(Physics2D const& physics)
+{
+    unsigned long long hash = 14695981039346656037ull;
+    for (Rigidbody2D const* rigidbody : physics.m_rigidbodies) {
+        if (rigidbody == nullptr) {
+            continue;
+        }
+
+        float values[3] = { rigidbody->GetWorldPosition().x, rigidbody->GetWorldPosition().y, rigidbody->GetRotationRadians() };
+        unsigned char bytes[sizeof(values)];
+        memcpy(bytes, values, sizeof(values));
+        for (unsigned char byte : bytes) {
+            hash = (hash ^ byte) * 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+//////////////////////////////////////////////////////////////////////////
+static char const* sSceneNames[NUM_PHYSICS_BENCHMARK_SCENES] = { "pile", "rain", "tower" };
+
+//////////////////////////////////////////////////////////////////////////
+char const* GetBenchmarkSceneName(ePhysicsBenchmarkScene2D scene)
+{
+    return scene < NUM_PHYSICS_BENCHMARK_SCENES ? sSceneNames[scene] : "unknown";
+}
+
+//////////////////////////////////////////////////////////////////////////
+ePhysicsBenchmarkScene2D GetBenchmarkSceneFromName(char const* name)
+{
+    for (int sceneIdx = 0; sceneIdx < NUM_PHYSICS_BENCHMARK_SCENES; sceneIdx++) {
+        if (strcmp(name, sSceneNames[sceneIdx]) == 0) {
+            return (ePhysicsBenchmarkScene2D)sceneIdx;
+        }
+    }
+    return NUM_PHYSICS_BENCHMARK_SCENES;
+}
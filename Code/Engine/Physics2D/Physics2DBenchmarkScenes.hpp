@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Engine/Physics2D/BroadPhase2D.hpp"
+#include "Engine/Physics2D/PhysicsMaterial.hpp"
+#include "Engine/Physics2D/StepProfiler2D.hpp"
+
+class Physics2D;
+class Collider2D;
+class Rigidbody2D;
+enum eSimulationMode : int;
+
+//////////////////////////////////////////////////////////////////////////
+// canned scenes built from fixed seeds, the same bodies in the same order on
+// every run and platform. No console or renderer calls here, but there is no
+// headless runner: the tree only builds the Windows Engine library, Time and
+// ErrorWarningAssert need Windows.h, and Job, Rigidbody2D and EventSystem
+// report through g_theConsole, which needs the renderer. Until Core gets a
+// console-free log sink and a Linux build, run the scenes from the
+// physics_scene_benchmark command
+enum ePhysicsBenchmarkScene2D
+{
+    PHYSICS_SCENE_PILE,     //discs and boxes packed in a walled bin, settling
+    PHYSICS_SCENE_RAIN,     //discs and boxes falling from a tall band onto pegs and a floor
+    PHYSICS_SCENE_TOWER,    //columns of stacked boxes that have to stand still
+
+    NUM_PHYSICS_BENCHMARK_SCENES
+};
+
+struct PhysicsSceneSettings2D
+{
+    ePhysicsBenchmarkScene2D scene = PHYSICS_SCENE_PILE;
+    int bodyCount = 2000;
+    int stepCount = 300;
+    eBroadPhase2DType broadPhaseType = BROAD_PHASE_AABB_TREE;
+    bool isProfiled = false;    //fills phaseAverageMs, the timers cost a little
+};
+
+struct PhysicsSceneResult2D
+{
+    int stepCount = 0;
+    double msPerStep = 0.0;
+    double contactsPerStep = 0.0;
+    double pairsPerStep = 0.0;
+    int awakeBodyCount = 0;         //after the last step
+    unsigned long long stateHash = 0;   //positions and rotations after the last step
+    double phaseAverageMs[NUM_STEP_PHASES] = {};    //over the last STEP_PROFILE_WINDOW steps
+};
+
+//////////////////////////////////////////////////////////////////////////
+Rigidbody2D* CreateBenchmarkBody(Physics2D& physics, Collider2D* collider, Vec2 const& position, eSimulationMode mode,
+    PhysicsMaterial const& material = PhysicsMaterial());
+void BuildPileBenchmarkScene(Physics2D& physics, int bodyCount, PhysicsMaterial const& material = PhysicsMaterial());
+void BuildRainBenchmarkScene(Physics2D& physics, int bodyCount);
+void BuildTowerBenchmarkScene(Physics2D& physics, int bodyCount);
+void BuildBenchmarkScene(Physics2D& physics, ePhysicsBenchmarkScene2D scene, int bodyCount);
+
+PhysicsSceneResult2D RunBenchmarkScene(PhysicsSceneSettings2D const& settings);
+unsigned long long HashPhysicsState(Physics2D const& physics);
+char const* GetBenchmarkSceneName(ePhysicsBenchmarkScene2D scene);
+ePhysicsBenchmarkScene2D GetBenchmarkSceneFromName(char const* name);    //NUM_PHYSICS_BENCHMARK_SCENES if unknown
@@ -5,8 +5,9 @@
 #include "Engine/Math/LineSegment2.hpp"
 #include "Engine/Core/Vertex_PCU.hpp"
 #include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/AABB2.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
-#include "Engine/Renderer/RenderContext.hpp"
+#include <cfloat>
 
 //////////////////////////////////////////////////////////////////////////
 PolygonCollider2D::PolygonCollider2D( Vec2 const* points, unsigned int pointCount)
@@ -131,6 +132,130 @@ bool PolygonCollider2D::Contains( Vec2 pos ) const
 	return m_polygon.Contains( localPos );
 }
 
+//////////////////////////////////////////////////////////////////////////
+bool PolygonCollider2D::OverlapsBounds(AABB2 const& bounds) const
+{
+	//separating axis, the bounds' two axes and then each edge normal
+	float rotationRadians = m_rigidbody->GetRotationRadians();
+	Vec2 boundsCenter = .5f * (bounds.mins + bounds.maxs) - m_worldPosition;
+	Vec2 boundsHalfDimensions = .5f * (bounds.maxs - bounds.mins);
+	Vec2 localCenter = boundsCenter.GetRotatedRadians(-rotationRadians);
+	Vec2 localI = Vec2(1.f, 0.f).GetRotatedRadians(-rotationRadians);
+	Vec2 localJ = localI.GetRotated90Degrees();
+
+	int vertexCount = m_polygon.GetVertexCount();
+	Vec2 worldMins(FLT_MAX, FLT_MAX);
+	Vec2 worldMaxs(-FLT_MAX, -FLT_MAX);
+	for (int edgeIdx = 0; edgeIdx < vertexCount; edgeIdx++) {
+		Vec2 edgeStart;
+		Vec2 edgeEnd;
+		m_polygon.GetEdge(edgeIdx, &edgeStart, &edgeEnd);
+		Vec2 offset(DotProduct2D(edgeStart, localI), DotProduct2D(edgeStart, localJ));		//from the polygon origin, world axes
+		worldMins = Vec2(MinFloat(worldMins.x, offset.x), MinFloat(worldMins.y, offset.y));
+		worldMaxs = Vec2(MaxFloat(worldMaxs.x, offset.x), MaxFloat(worldMaxs.y, offset.y));
+
+		//counter clockwise, outward normal on the right. Polygon spans up to the edge along it
+		Vec2 normal = (edgeEnd - edgeStart).GetRotatedMinus90Degrees();
+		float boundsRadius = boundsHalfDimensions.x * AbsFloat(DotProduct2D(normal, localI)) + boundsHalfDimensions.y * AbsFloat(DotProduct2D(normal, localJ));
+		if (DotProduct2D(normal, localCenter - edgeStart) > boundsRadius) {
+			return false;
+		}
+	}
+	return worldMins.x <= boundsCenter.x + boundsHalfDimensions.x && worldMaxs.x >= boundsCenter.x - boundsHalfDimensions.x &&
+		worldMins.y <= boundsCenter.y + boundsHalfDimensions.y && worldMaxs.y >= boundsCenter.y - boundsHalfDimensions.y;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// in local space. A ray clips the segment by every edge's half plane, the last
+// edge it enters through is hit. A swept disc hits the polygon grown by its
+// radius, the first of the edges pushed out along their normals and the
+// discs around the corners it reaches
+bool PolygonCollider2D::Raycast(Vec2 const& start, Vec2 const& end, float radius, float& outFraction, Vec2& outNormal) const
+{
+	float rotationRadians = m_rigidbody->GetRotationRadians();
+	Vec2 localStart = (start - m_worldPosition).GetRotatedRadians(-rotationRadians);
+	Vec2 localEnd = (end - m_worldPosition).GetRotatedRadians(-rotationRadians);
+	Vec2 localDelta = localEnd - localStart;
+	int vertexCount = m_polygon.GetVertexCount();
+
+	if (radius > 0.f) {
+		if (m_polygon.Contains(localStart) || GetDistanceSquared2D(localStart, m_polygon.GetClosestPoint(localStart)) <= radius * radius) {
+			return false;
+		}
+
+		float hitFraction = 2.f;
+		Vec2 hitNormal;
+		for (int edgeIdx = 0; edgeIdx < vertexCount; edgeIdx++) {
+			Vec2 edgeStart;
+			Vec2 edgeEnd;
+			m_polygon.GetEdge(edgeIdx, &edgeStart, &edgeEnd);
+			Vec2 edge = edgeEnd - edgeStart;
+			Vec2 normal = edge.GetRotatedMinus90Degrees().GetNormalized();
+			float speed = DotProduct2D(normal, localDelta);
+			if (speed < 0.f) {
+				float fraction = (DotProduct2D(normal, localStart - edgeStart) - radius) / -speed;
+				float edgeFraction = DotProduct2D(localStart + fraction * localDelta - edgeStart, edge) / edge.GetLengthSquared();
+				if (fraction >= 0.f && fraction < hitFraction && edgeFraction >= 0.f && edgeFraction <= 1.f) {
+					hitFraction = fraction;
+					hitNormal = normal;
+				}
+			}
+
+			float cornerFraction = 0.f;
+			if (DoesRayHitDisc2D(localStart, localEnd, edgeStart, radius, cornerFraction) && cornerFraction < hitFraction) {
+				hitFraction = cornerFraction;
+				hitNormal = (localStart + cornerFraction * localDelta - edgeStart).GetNormalized();
+			}
+		}
+		if (hitFraction > 1.f) {
+			return false;
+		}
+
+		outFraction = hitFraction;
+		outNormal = hitNormal.GetRotatedRadians(rotationRadians);
+		return true;
+	}
+
+	float enter = 0.f;
+	float exit = 1.f;
+	Vec2 enterNormal;
+	bool isEntering = false;
+	for (int edgeIdx = 0; edgeIdx < vertexCount; edgeIdx++) {
+		Vec2 edgeStart;
+		Vec2 edgeEnd;
+		m_polygon.GetEdge(edgeIdx, &edgeStart, &edgeEnd);
+		Vec2 normal = (edgeEnd - edgeStart).GetRotatedMinus90Degrees();	//counter clockwise, outward on the right
+		float distance = DotProduct2D(normal, edgeStart - localStart);		//negative when start is outside this edge
+		float speed = DotProduct2D(normal, localDelta);
+		if (speed == 0.f) {
+			if (distance < 0.f) {
+				return false;
+			}
+			continue;
+		}
+
+		float fraction = distance / speed;
+		if (speed < 0.f && fraction > enter) {
+			enter = fraction;
+			enterNormal = normal;
+			isEntering = true;
+		}
+		else if (speed > 0.f && fraction < exit) {
+			exit = fraction;
+		}
+		if (enter > exit) {
+			return false;
+		}
+	}
+	if (!isEntering) {
+		return false;
+	}
+
+	outFraction = enter;
+	outNormal = enterNormal.GetNormalized().GetRotatedRadians(rotationRadians);
+	return true;
+}
+
 //////////////////////////////////////////////////////////////////////////
 float PolygonCollider2D::CalculateMomentInertia(float mass) const
 {
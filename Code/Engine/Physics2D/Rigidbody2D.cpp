@@ -13,31 +13,17 @@ void Rigidbody2D::Destroy()
 	m_system->DestroyRigidbody( this );
 }
 
-//////////////////////////////////////////////////////////////////////////
-void Rigidbody2D::Simulate(float deltaSeconds)
-{
-	if (m_mode != KINEMATIC)
-	{
-        Vec2 acceleration = m_frameForce * m_massInverse;
-        m_velocity += acceleration * deltaSeconds;
-
-		float angularAcceleration = m_frameTorque / GetMomentInertia();
-		m_angularVelocity += angularAcceleration * deltaSeconds;
-	}
-	Move( m_velocity * deltaSeconds);
-	m_rotationInRadius += m_angularVelocity * deltaSeconds;
-}
-
 //////////////////////////////////////////////////////////////////////////
 void Rigidbody2D::ApplyForce(Vec2 const& newForce)
 {
-	m_frameForce += newForce;
+	WakeUp();
+	m_store->SetForce(m_storeIdx, m_store->GetForce(m_storeIdx) + newForce);
 }
 
 //////////////////////////////////////////////////////////////////////////
 void Rigidbody2D::ApplyGravityForce(Vec2 const& gravityAcceleration)
 {
-	Vec2 gravityForce = m_mass * gravityAcceleration;
+	Vec2 gravityForce = GetMass() * gravityAcceleration;
 	ApplyForce(gravityForce);
 }
 
@@ -45,15 +31,16 @@ void Rigidbody2D::ApplyGravityForce(Vec2 const& gravityAcceleration)
 void Rigidbody2D::ApplyDragForce()
 {
     Vec2 velocity = GetVelocity(); // GetVerletVelocity
-    Vec2 dragForce = -velocity * m_drag;
+    Vec2 dragForce = -velocity * GetDrag();
     ApplyForce(dragForce);
 }
 
 //////////////////////////////////////////////////////////////////////////
 void Rigidbody2D::ApplyImpulseAt(Vec2 const& impulse, Vec2 const& pos)
 {
-	m_velocity += impulse * m_massInverse;
-	m_angularVelocity += DotProduct2D((pos - m_worldPosition).GetRotated90Degrees(), impulse) / GetMomentInertia();
+	WakeUp();
+	m_store->SetVelocity(m_storeIdx, GetVelocity() + impulse * m_store->m_massInverse[m_storeIdx]);
+	m_store->m_angularVelocity[m_storeIdx] += DotProduct2D((pos - GetWorldPosition()).GetRotated90Degrees(), impulse) / GetMomentInertia();
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -72,12 +59,14 @@ void Rigidbody2D::SetRotationLocked(bool isLocked)
 void Rigidbody2D::SetXAxisLocked(bool isLocked)
 {
 	m_xAxisLocked = isLocked;
+	UpdateStoreFlags();
 }
 
 //////////////////////////////////////////////////////////////////////////
 void Rigidbody2D::SetYAxisLocked(bool isLocked)
 {
 	m_yAxisLocked = isLocked;
+	UpdateStoreFlags();
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -89,27 +78,28 @@ void Rigidbody2D::TakeCollider( Collider2D* collider )
 	}
 
 	m_collider = collider;
-	m_momentInertia = CalculateMomentInertia();
-}
-
-//////////////////////////////////////////////////////////////////////////
-void Rigidbody2D::BeginSimulation()
-{
-	m_lastWorldPos = m_worldPosition;
-    m_frameForce = Vec2::ZERO;
-    m_frameTorque = 0.f;
+	m_store->m_momentInertia[m_storeIdx] = CalculateMomentInertia();
 }
 
 //////////////////////////////////////////////////////////////////////////
 void Rigidbody2D::SetPosition( Vec2 newPosition )
 {
-	m_worldPosition = newPosition;
+	if (m_mode != DYNAMIC) {
+		m_system->WakeTouchingBodies(this);	//sleeping bodies resting on it must react
+	}
+	WakeUp();
+	m_store->SetPosition(m_storeIdx, newPosition);
 	m_collider->UpdateWorldShape();
+	m_system->m_isBroadPhaseStale = true;
 }
 
 //////////////////////////////////////////////////////////////////////////
 void Rigidbody2D::Move(Vec2 const& deltaMove)
 {
+	if (m_mode != DYNAMIC) {
+		m_system->WakeTouchingBodies(this);
+	}
+	WakeUp();
 	Vec2 actualMove = deltaMove;
 	if (m_xAxisLocked) {
 		actualMove.x = 0.f;
@@ -117,26 +107,38 @@ void Rigidbody2D::Move(Vec2 const& deltaMove)
 	if (m_yAxisLocked) {
 		actualMove.y = 0.f;
 	}
-	m_worldPosition += actualMove;
+	m_store->SetPosition(m_storeIdx, GetWorldPosition() + actualMove);
 	m_collider->UpdateWorldShape();
+	m_system->m_isBroadPhaseStale = true;
 }
 
 //////////////////////////////////////////////////////////////////////////
 void Rigidbody2D::SetEnable(bool isEnabled)
 {
+	if (m_isEnabled && !isEnabled) {
+		m_system->WakeTouchingBodies(this);
+	}
+	WakeUp();
 	m_isEnabled = isEnabled;
+	UpdateStoreFlags();
 }
 
 //////////////////////////////////////////////////////////////////////////
 void Rigidbody2D::SetVelocity(Vec2 const& velocity)
 {
-	m_velocity = velocity;
+	WakeUp();
+	m_store->SetVelocity(m_storeIdx, velocity);
 }
 
 //////////////////////////////////////////////////////////////////////////
 void Rigidbody2D::SetSimulationMode(eSimulationMode mode)
 {
+	if (mode != m_mode) {
+		m_system->WakeTouchingBodies(this);
+	}
+	WakeUp();
 	m_mode = mode;
+	UpdateStoreFlags();
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -156,8 +158,7 @@ void Rigidbody2D::SetFriction(float newFriction)
 //////////////////////////////////////////////////////////////////////////
 void Rigidbody2D::SetDrag(float newDrag)
 {
-	m_drag = m_drag < 0.f ? 0.f : m_drag;
-	m_drag = newDrag;
+	m_store->m_drag[m_storeIdx] = newDrag < 0.f ? 0.f : newDrag;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -168,34 +169,78 @@ void Rigidbody2D::SetMass(float newMass)
 		return;
 	}
 
-	m_momentInertia *= newMass / m_mass;
-	m_mass = newMass;
-	m_massInverse = 1.f / newMass;
+	m_store->m_momentInertia[m_storeIdx] *= newMass / GetMass();
+	m_store->m_mass[m_storeIdx] = newMass;
+	m_store->m_massInverse[m_storeIdx] = 1.f / newMass;
 }
 
 //////////////////////////////////////////////////////////////////////////
 void Rigidbody2D::SetMomentInertia(float newMomentInertia)
 {
-	m_momentInertia = newMomentInertia;
+	m_store->m_momentInertia[m_storeIdx] = newMomentInertia;
 }
 
 //////////////////////////////////////////////////////////////////////////
 void Rigidbody2D::SetAngularVelocity(float newAngularVelocityDegrees)
 {
-	m_angularVelocity = ConvertDegreesToRadians(newAngularVelocityDegrees);
+	WakeUp();
+	m_store->m_angularVelocity[m_storeIdx] = ConvertDegreesToRadians(newAngularVelocityDegrees);
 }
 
 //////////////////////////////////////////////////////////////////////////
 void Rigidbody2D::SetRotationInRadius(float newRotationDegrees)
 {
-	m_rotationInRadius = ConvertDegreesToRadians(newRotationDegrees);
+	if (m_mode != DYNAMIC) {
+		m_system->WakeTouchingBodies(this);
+	}
+	WakeUp();
+	m_store->m_rotation[m_storeIdx] = ConvertDegreesToRadians(newRotationDegrees);
+	m_system->m_isBroadPhaseStale = true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Rigidbody2D::WakeUp()
+{
+	if (!m_isAwake) {
+		m_system->WakeSleepingIsland(m_sleepingIslandIdx);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Rigidbody2D::SetCanSleep(bool canSleep)
+{
+	m_canSleep = canSleep;
+	if (!canSleep) {
+		WakeUp();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Rigidbody2D::SetContinuousCollision(bool isContinuous)
+{
+	m_isContinuous = isContinuous;
+	UpdateStoreFlags();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// the store's integration pass only reads flags, mirror everything it needs
+void Rigidbody2D::UpdateStoreFlags()
+{
+	bool isActive = m_isAwake && !m_isDestroyed;
+	bool isIntegrating = isActive && m_isEnabled && m_mode != STATIC;
+	m_store->SetFlag(m_storeIdx, BODY_FLAG_ACTIVE, isActive);
+	m_store->SetFlag(m_storeIdx, BODY_FLAG_INTEGRATE, isIntegrating);
+	m_store->SetFlag(m_storeIdx, BODY_FLAG_FORCES, isIntegrating && m_mode == DYNAMIC);
+	m_store->SetFlag(m_storeIdx, BODY_FLAG_LOCK_X, m_xAxisLocked);
+	m_store->SetFlag(m_storeIdx, BODY_FLAG_LOCK_Y, m_yAxisLocked);
+	m_store->SetFlag(m_storeIdx, BODY_FLAG_CONTINUOUS, isIntegrating && m_isContinuous);
 }
 
 //////////////////////////////////////////////////////////////////////////
 float Rigidbody2D::CalculateMomentInertia()
 {
 	if (m_collider != nullptr) {
-		return m_collider->CalculateMomentInertia(m_mass);
+		return m_collider->CalculateMomentInertia(GetMass());
 	}
 	else {
 		return 0.f;
@@ -205,21 +250,21 @@ float Rigidbody2D::CalculateMomentInertia()
 //////////////////////////////////////////////////////////////////////////
 Vec2 Rigidbody2D::GetVerletVelocity() const
 {
-	return (m_worldPosition - m_lastWorldPos) / (float)m_system->GetFixedDeltaTime();
+	return (GetWorldPosition() - m_store->GetLastPosition(m_storeIdx)) / (float)m_system->GetFixedDeltaTime();
 }
 
 //////////////////////////////////////////////////////////////////////////
 Vec2 Rigidbody2D::GetImpactVelocity(Vec2 const& contactPos) const
 {
-	Vec2 centerToP = contactPos - m_worldPosition;
-	Vec2 angularVel = m_angularVelocity * centerToP.GetRotated90Degrees();
-	return m_velocity + angularVel;
+	Vec2 centerToP = contactPos - GetWorldPosition();
+	Vec2 angularVel = m_store->m_angularVelocity[m_storeIdx] * centerToP.GetRotated90Degrees();
+	return GetVelocity() + angularVel;
 }
 
 //////////////////////////////////////////////////////////////////////////
 float Rigidbody2D::GetMass() const
 {
-	return m_mass;
+	return m_store->m_mass[m_storeIdx];
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -237,19 +282,19 @@ float Rigidbody2D::GetFriction() const
 //////////////////////////////////////////////////////////////////////////
 float Rigidbody2D::GetRotationDegrees() const
 {
-	return ConvertRadiansToDegrees(m_rotationInRadius);
+	return ConvertRadiansToDegrees(GetRotationRadians());
 }
 
 //////////////////////////////////////////////////////////////////////////
 float Rigidbody2D::GetAngularVelocityDegrees() const
 {
-	return ConvertRadiansToDegrees(m_angularVelocity);
+	return ConvertRadiansToDegrees(m_store->m_angularVelocity[m_storeIdx]);
 }
 
 //////////////////////////////////////////////////////////////////////////
 float Rigidbody2D::GetMomentInertia() const
 {
-	return m_rotationLocked ? FLT_MAX : m_momentInertia;
+	return m_rotationLocked ? FLT_MAX : m_store->m_momentInertia[m_storeIdx];
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Engine/Math/Vec2.hpp"
+#include "Engine/Physics2D/RigidbodyStore2D.hpp"
 #include "Engine/Core/Delegate.hpp"
 #include "Engine/Core/NamedProperties.hpp"
 
@@ -8,7 +9,7 @@ class Collider2D;
 class Physics2D;
 struct Collision2D;
 
-enum eSimulationMode 
+enum eSimulationMode : int
 {
 	STATIC,
 	KINEMATIC,
@@ -16,9 +17,12 @@ enum eSimulationMode
 };
 
 //////////////////////////////////////////////////////////////////////////
+// motion state lives packed in the owning Physics2D's RigidbodyStore2D,
+// this object keeps the rest and reads and writes its slot there
 class Rigidbody2D
 {
 	friend class Physics2D;
+	friend class RigidbodyStore2D;
 
 public:
 	Delegate<Collision2D const&> onOverlapStart;
@@ -29,10 +33,8 @@ public:
 public:
 	void Destroy(); // helper for destroying myself (uses owner to destroy self)
 	void TakeCollider(Collider2D* collider); // takes ownership of a collider (destroying my current one if present)
-	void BeginSimulation();
 
-	void Simulate(float deltaSeconds);
-	void ApplyForce(Vec2 const& newForce);
+	void ApplyForce(Vec2 const& newForce);	//accumulates until the next step
 	void ApplyGravityForce(Vec2 const& gravityAcceleration);
 	void ApplyDragForce();
 	void ApplyImpulseAt(Vec2 const& impulse, Vec2 const& pos);
@@ -56,6 +58,13 @@ public:
 	void SetAngularVelocity(float newAngularVelocityDegrees);
 	void SetRotationInRadius(float newRotationDegrees);
 
+	// sleeping, forces, impulses and teleports wake the body and everything it slept with
+	void WakeUp();
+	void SetCanSleep(bool canSleep);
+
+	// swept against static and kinematic polygons when moving more than half its radius a step, discs only
+	void SetContinuousCollision(bool isContinuous);
+
 	//Calculate const
 	float CalculateMomentInertia();
 
@@ -68,47 +77,52 @@ public:
     float			GetRotationDegrees() const;
 	float			GetAngularVelocityDegrees() const;
 	float			GetMomentInertia() const;
-	float			GetRotationRadians() const  { return m_rotationInRadius; }
-    float			GetDrag() const				{ return m_drag; }	
+	float			GetRotationRadians() const  { return m_store->m_rotation[m_storeIdx]; }
+    float			GetDrag() const				{ return m_store->m_drag[m_storeIdx]; }
 	Collider2D*		GetCollider() const			{ return m_collider; }
-	Vec2			GetWorldPosition() const	{ return m_worldPosition; }
-	Vec2			GetVelocity() const			{ return m_velocity; }
+	Vec2			GetWorldPosition() const	{ return m_store->GetPosition(m_storeIdx); }
+	Vec2			GetVelocity() const			{ return m_store->GetVelocity(m_storeIdx); }
+	RigidbodyHandle2D GetHandle() const			{ return m_handle; }
 	eSimulationMode	GetSimulationMode() const	{ return m_mode; }
 	bool			IsRotationLocked() const	{ return m_rotationLocked; }
 	bool			IsXAxisLocked() const		{ return m_xAxisLocked; }
 	bool			IsYAxisLocked() const		{ return m_yAxisLocked; }
 	bool			IsDestroyed() const			{ return m_isDestroyed; }
 	bool			IsEnabled() const			{ return m_isEnabled; }
+	bool			IsAwake() const				{ return m_isAwake; }
+	bool			CanSleep() const			{ return m_canSleep; }
+	bool			IsContinuousCollision() const	{ return m_isContinuous; }
+	int				GetIslandIndex() const		{ return m_islandIdx; }
 
 public:
 	Physics2D* m_system = nullptr;     // which scene created/owns this object
 	Collider2D* m_collider = nullptr;
 
-	Vec2 m_worldPosition;   // where in the world is this rigidbody
 	NamedProperties m_userProperties;
 
 private:
-	float m_drag = 0.f;
-	float m_mass = 1.f;
-	float m_massInverse = 1.f;
+	void UpdateStoreFlags();
 
-	float m_rotationInRadius = 0.f; //Radians
-	float m_angularVelocity = 0.f;
-	float m_frameTorque = 0.f;
-	float m_momentInertia = 0.f;
+private:
+	RigidbodyStore2D* m_store = nullptr;
+	int m_storeIdx = -1;	//dense, moves when other bodies are removed
+	RigidbodyHandle2D m_handle;
 
-	Vec2 m_frameForce;
-	Vec2 m_velocity;
 	eSimulationMode m_mode = DYNAMIC;
 	unsigned int m_layerIndex = 0;
 
-	Vec2 m_lastWorldPos;
-
 	bool m_rotationLocked = false;
 	bool m_xAxisLocked = false;
 	bool m_yAxisLocked = false;
 	bool m_isEnabled = true;
 	bool m_isDestroyed = false;
+	bool m_isContinuous = false;
+
+	bool m_isAwake = true;			//static and kinematic bodies never sleep
+	bool m_canSleep = true;
+	float m_sleepSeconds = 0.f;		//time spent slow enough to sleep
+	int m_islandIdx = -1;			//this step's island while awake and dynamic
+	int m_sleepingIslandIdx = -1;	//island it fell asleep with
 
 private:
 	~Rigidbody2D(); // destroys the collider
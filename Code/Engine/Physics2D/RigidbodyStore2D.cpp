@@ -0,0 +1,273 @@
+#include "Engine/Physics2D/RigidbodyStore2D.hpp"
+#include "Engine/Physics2D/Rigidbody2D.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include <cstring>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define RIGIDBODY_STORE_SSE
+#include <emmintrin.h>
+#endif
+
+static constexpr int BODY_LANE_COUNT = 4;
+
+//////////////////////////////////////////////////////////////////////////
+RigidbodyHandle2D RigidbodyStore2D::Add(Rigidbody2D* owner)
+{
+    int bodyIdx = m_count++;
+    if ((int)m_flags.size() < m_count) {
+        ResizeArrays((int)m_flags.size() + BODY_LANE_COUNT);
+    }
+    ResetBody(bodyIdx);
+    m_owners[bodyIdx] = owner;
+
+    int slotIdx = m_freeHandleSlot;
+    if (slotIdx == -1) {
+        slotIdx = (int)m_handleSlots.size();
+        m_handleSlots.emplace_back();
+    }
+    else {
+        m_freeHandleSlot = m_handleSlots[slotIdx].bodyIdx;
+    }
+    HandleSlot& slot = m_handleSlots[slotIdx];
+    slot.bodyIdx = bodyIdx;
+    slot.isUsed = true;
+    m_bodyToHandle[bodyIdx] = (unsigned int)slotIdx;
+
+    if (owner != nullptr) {
+        owner->m_storeIdx = bodyIdx;
+    }
+
+    RigidbodyHandle2D handle;
+    handle.index = (unsigned int)slotIdx;
+    handle.generation = slot.generation;
+    return handle;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void RigidbodyStore2D::Remove(RigidbodyHandle2D handle)
+{
+    GUARANTEE_OR_DIE(handle.index < m_handleSlots.size() && m_handleSlots[handle.index].isUsed &&
+        m_handleSlots[handle.index].generation == handle.generation, "removing a rigidbody that is not in the store");
+
+    HandleSlot& slot = m_handleSlots[handle.index];
+    int bodyIdx = slot.bodyIdx;
+    int lastIdx = m_count - 1;
+    if (bodyIdx != lastIdx) {
+        MoveBody(lastIdx, bodyIdx);
+    }
+    ResetBody(lastIdx);
+    m_owners[lastIdx] = nullptr;
+    m_count--;
+
+    slot.generation++;
+    slot.isUsed = false;
+    slot.bodyIdx = m_freeHandleSlot;
+    m_freeHandleSlot = (int)handle.index;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void RigidbodyStore2D::Clear()
+{
+    while (m_count > 0) {
+        unsigned int slotIdx = m_bodyToHandle[m_count - 1];
+        Remove(RigidbodyHandle2D{ slotIdx, m_handleSlots[slotIdx].generation });
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+Rigidbody2D* RigidbodyStore2D::Resolve(RigidbodyHandle2D handle) const
+{
+    if (handle.index >= m_handleSlots.size()) {
+        return nullptr;
+    }
+    HandleSlot const& slot = m_handleSlots[handle.index];
+    if (!slot.isUsed || slot.generation != handle.generation) {
+        return nullptr;
+    }
+    return m_owners[slot.bodyIdx];
+}
+
+//////////////////////////////////////////////////////////////////////////
+void RigidbodyStore2D::SetFlag(int bodyIdx, unsigned char flag, bool isSet)
+{
+    if (isSet) {
+        m_flags[bodyIdx] |= flag;
+    }
+    else {
+        m_flags[bodyIdx] &= (unsigned char)~flag;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// same operations in the same order as IntegrateScalar, the vector path is
+// bit identical to it. Masked out lanes keep their old values
+void RigidbodyStore2D::Integrate(Vec2 const& gravityAcceleration, float deltaSeconds)
+{
+#if defined(RIGIDBODY_STORE_SSE)
+    __m128 const gravityX = _mm_set1_ps(gravityAcceleration.x);
+    __m128 const gravityY = _mm_set1_ps(gravityAcceleration.y);
+    __m128 const dt = _mm_set1_ps(deltaSeconds);
+    __m128 const signBit = _mm_set1_ps(-0.f);
+    __m128i const zero = _mm_setzero_si128();
+    __m128i const activeBit = _mm_set1_epi32(BODY_FLAG_ACTIVE);
+    __m128i const integrateBit = _mm_set1_epi32(BODY_FLAG_INTEGRATE);
+    __m128i const forcesBit = _mm_set1_epi32(BODY_FLAG_FORCES);
+    __m128i const lockXBit = _mm_set1_epi32(BODY_FLAG_LOCK_X);
+    __m128i const lockYBit = _mm_set1_epi32(BODY_FLAG_LOCK_Y);
+
+    int paddedCount = (int)m_flags.size();
+    for (int bodyIdx = 0; bodyIdx < paddedCount; bodyIdx += BODY_LANE_COUNT) {
+        //4 flag bytes widened to one int per lane, then a full lane mask per flag
+        int packedFlags = 0;
+        memcpy(&packedFlags, &m_flags[bodyIdx], sizeof(packedFlags));
+        if (packedFlags == 0) {
+            continue;
+        }
+        __m128i flags = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packedFlags), zero), zero);
+        __m128 isActive = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(flags, activeBit), activeBit));
+        __m128 isIntegrating = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(flags, integrateBit), integrateBit));
+        __m128 hasForces = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(flags, forcesBit), forcesBit));
+        __m128 isLockedX = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(flags, lockXBit), lockXBit));
+        __m128 isLockedY = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(flags, lockYBit), lockYBit));
+
+        __m128 positionX = _mm_loadu_ps(&m_positionX[bodyIdx]);
+        __m128 positionY = _mm_loadu_ps(&m_positionY[bodyIdx]);
+        __m128 lastPositionX = _mm_loadu_ps(&m_lastPositionX[bodyIdx]);
+        __m128 lastPositionY = _mm_loadu_ps(&m_lastPositionY[bodyIdx]);
+        _mm_storeu_ps(&m_lastPositionX[bodyIdx], _mm_or_ps(_mm_and_ps(isActive, positionX), _mm_andnot_ps(isActive, lastPositionX)));
+        _mm_storeu_ps(&m_lastPositionY[bodyIdx], _mm_or_ps(_mm_and_ps(isActive, positionY), _mm_andnot_ps(isActive, lastPositionY)));
+
+        //gravity and drag on top of accumulated forces
+        __m128 velocityX = _mm_loadu_ps(&m_velocityX[bodyIdx]);
+        __m128 velocityY = _mm_loadu_ps(&m_velocityY[bodyIdx]);
+        __m128 forceX = _mm_loadu_ps(&m_forceX[bodyIdx]);
+        __m128 forceY = _mm_loadu_ps(&m_forceY[bodyIdx]);
+        __m128 mass = _mm_loadu_ps(&m_mass[bodyIdx]);
+        __m128 massInverse = _mm_loadu_ps(&m_massInverse[bodyIdx]);
+        __m128 drag = _mm_loadu_ps(&m_drag[bodyIdx]);
+        __m128 totalForceX = _mm_add_ps(_mm_add_ps(forceX, _mm_mul_ps(mass, gravityX)), _mm_mul_ps(_mm_xor_ps(velocityX, signBit), drag));
+        __m128 totalForceY = _mm_add_ps(_mm_add_ps(forceY, _mm_mul_ps(mass, gravityY)), _mm_mul_ps(_mm_xor_ps(velocityY, signBit), drag));
+        __m128 newVelocityX = _mm_add_ps(velocityX, _mm_mul_ps(_mm_mul_ps(totalForceX, massInverse), dt));
+        __m128 newVelocityY = _mm_add_ps(velocityY, _mm_mul_ps(_mm_mul_ps(totalForceY, massInverse), dt));
+        velocityX = _mm_or_ps(_mm_and_ps(hasForces, newVelocityX), _mm_andnot_ps(hasForces, velocityX));
+        velocityY = _mm_or_ps(_mm_and_ps(hasForces, newVelocityY), _mm_andnot_ps(hasForces, velocityY));
+        _mm_storeu_ps(&m_velocityX[bodyIdx], velocityX);
+        _mm_storeu_ps(&m_velocityY[bodyIdx], velocityY);
+        _mm_storeu_ps(&m_forceX[bodyIdx], _mm_andnot_ps(isActive, forceX));
+        _mm_storeu_ps(&m_forceY[bodyIdx], _mm_andnot_ps(isActive, forceY));
+
+        //locked axes still add a zero move, like Rigidbody2D::Move
+        __m128 moveX = _mm_andnot_ps(isLockedX, _mm_mul_ps(velocityX, dt));
+        __m128 moveY = _mm_andnot_ps(isLockedY, _mm_mul_ps(velocityY, dt));
+        positionX = _mm_or_ps(_mm_and_ps(isIntegrating, _mm_add_ps(positionX, moveX)), _mm_andnot_ps(isIntegrating, positionX));
+        positionY = _mm_or_ps(_mm_and_ps(isIntegrating, _mm_add_ps(positionY, moveY)), _mm_andnot_ps(isIntegrating, positionY));
+        _mm_storeu_ps(&m_positionX[bodyIdx], positionX);
+        _mm_storeu_ps(&m_positionY[bodyIdx], positionY);
+
+        __m128 rotation = _mm_loadu_ps(&m_rotation[bodyIdx]);
+        __m128 newRotation = _mm_add_ps(rotation, _mm_mul_ps(_mm_loadu_ps(&m_angularVelocity[bodyIdx]), dt));
+        _mm_storeu_ps(&m_rotation[bodyIdx], _mm_or_ps(_mm_and_ps(isIntegrating, newRotation), _mm_andnot_ps(isIntegrating, rotation)));
+    }
+#else
+    IntegrateScalar(gravityAcceleration, deltaSeconds);
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+void RigidbodyStore2D::IntegrateScalar(Vec2 const& gravityAcceleration, float deltaSeconds)
+{
+    for (int bodyIdx = 0; bodyIdx < m_count; bodyIdx++) {
+        unsigned char flags = m_flags[bodyIdx];
+        if ((flags & BODY_FLAG_ACTIVE) == 0) {
+            continue;
+        }
+        m_lastPositionX[bodyIdx] = m_positionX[bodyIdx];
+        m_lastPositionY[bodyIdx] = m_positionY[bodyIdx];
+
+        if ((flags & BODY_FLAG_FORCES) != 0) {
+            float forceX = m_forceX[bodyIdx] + m_mass[bodyIdx] * gravityAcceleration.x + -m_velocityX[bodyIdx] * m_drag[bodyIdx];
+            float forceY = m_forceY[bodyIdx] + m_mass[bodyIdx] * gravityAcceleration.y + -m_velocityY[bodyIdx] * m_drag[bodyIdx];
+            m_velocityX[bodyIdx] += forceX * m_massInverse[bodyIdx] * deltaSeconds;
+            m_velocityY[bodyIdx] += forceY * m_massInverse[bodyIdx] * deltaSeconds;
+        }
+        m_forceX[bodyIdx] = 0.f;
+        m_forceY[bodyIdx] = 0.f;
+
+        if ((flags & BODY_FLAG_INTEGRATE) != 0) {
+            float moveX = (flags & BODY_FLAG_LOCK_X) != 0 ? 0.f : m_velocityX[bodyIdx] * deltaSeconds;
+            float moveY = (flags & BODY_FLAG_LOCK_Y) != 0 ? 0.f : m_velocityY[bodyIdx] * deltaSeconds;
+            m_positionX[bodyIdx] += moveX;
+            m_positionY[bodyIdx] += moveY;
+            m_rotation[bodyIdx] += m_angularVelocity[bodyIdx] * deltaSeconds;
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void RigidbodyStore2D::ResizeArrays(int paddedCount)
+{
+    m_positionX.resize(paddedCount, 0.f);
+    m_positionY.resize(paddedCount, 0.f);
+    m_lastPositionX.resize(paddedCount, 0.f);
+    m_lastPositionY.resize(paddedCount, 0.f);
+    m_velocityX.resize(paddedCount, 0.f);
+    m_velocityY.resize(paddedCount, 0.f);
+    m_forceX.resize(paddedCount, 0.f);
+    m_forceY.resize(paddedCount, 0.f);
+    m_rotation.resize(paddedCount, 0.f);
+    m_angularVelocity.resize(paddedCount, 0.f);
+    m_mass.resize(paddedCount, 1.f);
+    m_massInverse.resize(paddedCount, 1.f);
+    m_momentInertia.resize(paddedCount, 0.f);
+    m_drag.resize(paddedCount, 0.f);
+    m_flags.resize(paddedCount, 0);
+    m_owners.resize(paddedCount, nullptr);
+    m_bodyToHandle.resize(paddedCount, 0);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void RigidbodyStore2D::MoveBody(int fromIdx, int toIdx)
+{
+    m_positionX[toIdx] = m_positionX[fromIdx];
+    m_positionY[toIdx] = m_positionY[fromIdx];
+    m_lastPositionX[toIdx] = m_lastPositionX[fromIdx];
+    m_lastPositionY[toIdx] = m_lastPositionY[fromIdx];
+    m_velocityX[toIdx] = m_velocityX[fromIdx];
+    m_velocityY[toIdx] = m_velocityY[fromIdx];
+    m_forceX[toIdx] = m_forceX[fromIdx];
+    m_forceY[toIdx] = m_forceY[fromIdx];
+    m_rotation[toIdx] = m_rotation[fromIdx];
+    m_angularVelocity[toIdx] = m_angularVelocity[fromIdx];
+    m_mass[toIdx] = m_mass[fromIdx];
+    m_massInverse[toIdx] = m_massInverse[fromIdx];
+    m_momentInertia[toIdx] = m_momentInertia[fromIdx];
+    m_drag[toIdx] = m_drag[fromIdx];
+    m_flags[toIdx] = m_flags[fromIdx];
+    m_owners[toIdx] = m_owners[fromIdx];
+    m_bodyToHandle[toIdx] = m_bodyToHandle[fromIdx];
+
+    m_handleSlots[m_bodyToHandle[toIdx]].bodyIdx = toIdx;
+    if (m_owners[toIdx] != nullptr) {
+        m_owners[toIdx]->m_storeIdx = toIdx;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void RigidbodyStore2D::ResetBody(int bodyIdx)
+{
+    m_positionX[bodyIdx] = 0.f;
+    m_positionY[bodyIdx] = 0.f;
+    m_lastPositionX[bodyIdx] = 0.f;
+    m_lastPositionY[bodyIdx] = 0.f;
+    m_velocityX[bodyIdx] = 0.f;
+    m_velocityY[bodyIdx] = 0.f;
+    m_forceX[bodyIdx] = 0.f;
+    m_forceY[bodyIdx] = 0.f;
+    m_rotation[bodyIdx] = 0.f;
+    m_angularVelocity[bodyIdx] = 0.f;
+    m_mass[bodyIdx] = 1.f;
+    m_massInverse[bodyIdx] = 1.f;
+    m_momentInertia[bodyIdx] = 0.f;
+    m_drag[bodyIdx] = 0.f;
+    m_flags[bodyIdx] = 0;
+}
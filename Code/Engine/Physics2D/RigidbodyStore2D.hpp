@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Engine/Math/Vec2.hpp"
+#include <vector>
+
+class Rigidbody2D;
+
+//////////////////////////////////////////////////////////////////////////
+// stays valid while the body lives, resolves to nothing once it was cleaned
+// up even if the slot got reused, safe for game code to keep around
+struct RigidbodyHandle2D
+{
+    static constexpr unsigned int INVALID_INDEX = 0xffffffff;
+
+    unsigned int index = INVALID_INDEX;     //slot in the store's handle table
+    unsigned int generation = 0;
+
+    bool IsValid() const { return index != INVALID_INDEX; }
+    bool operator==(RigidbodyHandle2D const& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(RigidbodyHandle2D const& other) const { return !(*this == other); }
+};
+
+//////////////////////////////////////////////////////////////////////////
+enum eRigidbodyStoreFlag : unsigned char
+{
+    BODY_FLAG_ACTIVE = 1 << 0,      //awake and not destroyed, starts a new step
+    BODY_FLAG_INTEGRATE = 1 << 1,   //active, enabled and not static, moves
+    BODY_FLAG_FORCES = 1 << 2,      //integrating and dynamic, gets gravity, drag and forces
+    BODY_FLAG_LOCK_X = 1 << 3,
+    BODY_FLAG_LOCK_Y = 1 << 4,
+    BODY_FLAG_CONTINUOUS = 1 << 5,  //integrating and asked for continuous collision
+};
+
+//////////////////////////////////////////////////////////////////////////
+// rigid body state the step touches for every body, packed one array per
+// field so gravity, drag and integration run 4 bodies at a time. Removing a
+// body moves the last one into its place, dense indices are not stable,
+// handles and Rigidbody2D are.
+class RigidbodyStore2D
+{
+public:
+    RigidbodyHandle2D Add(Rigidbody2D* owner);
+    void Remove(RigidbodyHandle2D handle);
+    void Clear();
+
+    Rigidbody2D* Resolve(RigidbodyHandle2D handle) const;   //nullptr once removed
+    int GetCount() const { return m_count; }
+
+    //forces accumulated since the last step are applied and cleared
+    void Integrate(Vec2 const& gravityAcceleration, float deltaSeconds);
+    void IntegrateScalar(Vec2 const& gravityAcceleration, float deltaSeconds);  //reference for the vector path
+
+    Vec2 GetPosition(int bodyIdx) const             { return Vec2(m_positionX[bodyIdx], m_positionY[bodyIdx]); }
+    Vec2 GetLastPosition(int bodyIdx) const         { return Vec2(m_lastPositionX[bodyIdx], m_lastPositionY[bodyIdx]); }
+    Vec2 GetVelocity(int bodyIdx) const             { return Vec2(m_velocityX[bodyIdx], m_velocityY[bodyIdx]); }
+    Vec2 GetForce(int bodyIdx) const                { return Vec2(m_forceX[bodyIdx], m_forceY[bodyIdx]); }
+    void SetPosition(int bodyIdx, Vec2 const& position) { m_positionX[bodyIdx] = position.x; m_positionY[bodyIdx] = position.y; }
+    void SetLastPosition(int bodyIdx, Vec2 const& position) { m_lastPositionX[bodyIdx] = position.x; m_lastPositionY[bodyIdx] = position.y; }
+    void SetVelocity(int bodyIdx, Vec2 const& velocity) { m_velocityX[bodyIdx] = velocity.x; m_velocityY[bodyIdx] = velocity.y; }
+    void SetForce(int bodyIdx, Vec2 const& force)   { m_forceX[bodyIdx] = force.x; m_forceY[bodyIdx] = force.y; }
+    void SetFlag(int bodyIdx, unsigned char flag, bool isSet);
+
+public:
+    //dense, m_count bodies padded with inactive ones to a multiple of 4
+    std::vector<float> m_positionX;
+    std::vector<float> m_positionY;
+    std::vector<float> m_lastPositionX;     //at the start of the last step
+    std::vector<float> m_lastPositionY;
+    std::vector<float> m_velocityX;
+    std::vector<float> m_velocityY;
+    std::vector<float> m_forceX;
+    std::vector<float> m_forceY;
+    std::vector<float> m_rotation;          //radians
+    std::vector<float> m_angularVelocity;   //radians per second
+    std::vector<float> m_mass;
+    std::vector<float> m_massInverse;
+    std::vector<float> m_momentInertia;
+    std::vector<float> m_drag;
+    std::vector<unsigned char> m_flags;
+    std::vector<Rigidbody2D*> m_owners;
+
+private:
+    void ResizeArrays(int paddedCount);
+    void MoveBody(int fromIdx, int toIdx);
+    void ResetBody(int bodyIdx);
+
+    struct HandleSlot
+    {
+        int bodyIdx = -1;               //next free slot while free
+        unsigned int generation = 0;
+        bool isUsed = false;
+    };
+
+    int m_count = 0;
+    std::vector<HandleSlot> m_handleSlots;
+    std::vector<unsigned int> m_bodyToHandle;   //handle slot per dense body
+    int m_freeHandleSlot = -1;
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Engine/Math/Vec2.hpp"
+
+class Collider2D;
+
+static constexpr unsigned int PHYSICS_ALL_LAYERS = 0xffffffff;    //bit per Rigidbody2D layer
+
+//////////////////////////////////////////////////////////////////////////
+struct RaycastQuery2D
+{
+    Vec2 start;
+    Vec2 direction;             //normalized by the query
+    float maxDistance = 0.f;
+    unsigned int layerMask = PHYSICS_ALL_LAYERS;
+
+    RaycastQuery2D() = default;
+    RaycastQuery2D(Vec2 const& rayStart, Vec2 const& rayDirection, float rayMaxDistance, unsigned int rayLayerMask = PHYSICS_ALL_LAYERS)
+        : start(rayStart), direction(rayDirection), maxDistance(rayMaxDistance), layerMask(rayLayerMask) {}
+};
+
+//////////////////////////////////////////////////////////////////////////
+// first thing a ray or cast ran into, ties go to the lower collider slot
+struct RaycastHit2D
+{
+    Collider2D* collider = nullptr;     //nullptr on a miss
+    Vec2 point;
+    Vec2 normal;                        //surface normal of the collider hit
+    float distance = 0.f;               //along the direction
+
+    bool DidHit() const { return collider != nullptr; }
+};
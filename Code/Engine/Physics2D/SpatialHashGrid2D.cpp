@@ -0,0 +1,285 @@
+#include "Engine/Physics2D/SpatialHashGrid2D.hpp"
+#include "Engine/Physics2D/Collider2D.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+
+static constexpr int MAX_CELLS_PER_COLLIDER = 16;      //bigger ones go to the oversized list
+static constexpr unsigned int MIN_BUCKET_COUNT = 16;
+
+//////////////////////////////////////////////////////////////////////////
+SpatialHashGrid2D::SpatialHashGrid2D(float cellSize)
+    : m_configCellSize(cellSize)
+{
+    if (cellSize > 0.f) {
+        m_cellSize = cellSize;
+        m_invCellSize = 1.f / cellSize;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void SpatialHashGrid2D::Update(std::vector<Collider2D*> const& colliders)
+{
+    m_bounds.resize(colliders.size());
+    m_isOversized.assign(colliders.size(), false);
+    m_live.clear();
+    m_oversized.clear();
+    for (unsigned int colliderIdx = 0; colliderIdx < (unsigned int)colliders.size(); colliderIdx++) {
+        Collider2D const* collider = colliders[colliderIdx];
+        if (collider == nullptr || collider->m_rigidbody == nullptr) {   //empty slot or not attached yet
+            continue;
+        }
+        m_bounds[colliderIdx] = GetColliderBounds(collider);
+        m_live.push_back(colliderIdx);
+    }
+
+    if (m_configCellSize <= 0.f) {
+        m_cellSize = PickCellSize();
+        m_invCellSize = 1.f / m_cellSize;
+    }
+
+    //count entries first so buckets are sized for this step
+    size_t entryCount = 0;
+    for (unsigned int colliderIdx : m_live) {
+        AABB2 const& bounds = m_bounds[colliderIdx];
+        int spanX = RoundDownToInt(bounds.maxs.x * m_invCellSize) - RoundDownToInt(bounds.mins.x * m_invCellSize) + 1;
+        int spanY = RoundDownToInt(bounds.maxs.y * m_invCellSize) - RoundDownToInt(bounds.mins.y * m_invCellSize) + 1;
+        if (spanX > MAX_CELLS_PER_COLLIDER || spanY > MAX_CELLS_PER_COLLIDER || spanX * spanY > MAX_CELLS_PER_COLLIDER) {
+            m_isOversized[colliderIdx] = true;
+            m_oversized.push_back(colliderIdx);
+            continue;
+        }
+        entryCount += (size_t)(spanX * spanY);
+    }
+
+    unsigned int bucketCount = MIN_BUCKET_COUNT;
+    while (bucketCount < 2 * entryCount) {
+        bucketCount <<= 1;
+    }
+    m_bucketMask = bucketCount - 1;
+    m_bucketStarts.assign(bucketCount + 1, 0);
+    m_entries.resize(entryCount);
+
+    //counting sort into buckets, starts[b] ends up one past bucket b, then
+    //filling backwards walks it down to the first entry of bucket b
+    for (int pass = 0; pass < 2; pass++) {
+        for (unsigned int colliderIdx : m_live) {
+            if (m_isOversized[colliderIdx]) {
+                continue;
+            }
+            AABB2 const& bounds = m_bounds[colliderIdx];
+            int minX = RoundDownToInt(bounds.mins.x * m_invCellSize);
+            int minY = RoundDownToInt(bounds.mins.y * m_invCellSize);
+            int maxX = RoundDownToInt(bounds.maxs.x * m_invCellSize);
+            int maxY = RoundDownToInt(bounds.maxs.y * m_invCellSize);
+            for (int cellY = minY; cellY <= maxY; cellY++) {
+                for (int cellX = minX; cellX <= maxX; cellX++) {
+                    unsigned int bucketIdx = GetBucketIdx(cellX, cellY);
+                    if (pass == 0) {
+                        m_bucketStarts[bucketIdx]++;
+                        continue;
+                    }
+                    Entry& entry = m_entries[--m_bucketStarts[bucketIdx]];
+                    entry.bounds = bounds;
+                    entry.cellX = cellX;
+                    entry.cellY = cellY;
+                    entry.colliderIdx = colliderIdx;
+                }
+            }
+        }
+
+        if (pass == 0) {
+            for (unsigned int bucketIdx = 1; bucketIdx <= bucketCount; bucketIdx++) {
+                m_bucketStarts[bucketIdx] += m_bucketStarts[bucketIdx - 1];
+            }
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void SpatialHashGrid2D::FindPairs(std::vector<ColliderPair2D>& outPairs)
+{
+    outPairs.clear();
+    m_pairKeys.clear();
+
+    unsigned int bucketCount = m_bucketMask + 1;
+    for (unsigned int bucketIdx = 0; bucketIdx < bucketCount; bucketIdx++) {
+        unsigned int end = m_bucketStarts[bucketIdx + 1];
+        for (unsigned int i = m_bucketStarts[bucketIdx]; i < end; i++) {
+            Entry const& a = m_entries[i];
+            for (unsigned int j = i + 1; j < end; j++) {
+                Entry const& b = m_entries[j];
+                if (a.cellX != b.cellX || a.cellY != b.cellY || !a.bounds.IsBoundsOverlap(b.bounds)) {   //hash collision or apart
+                    continue;
+                }
+
+                //a pair shares every cell its overlap touches, only the one holding the overlap's min corner reports it
+                int refX = RoundDownToInt(std::max(a.bounds.mins.x, b.bounds.mins.x) * m_invCellSize);
+                int refY = RoundDownToInt(std::max(a.bounds.mins.y, b.bounds.mins.y) * m_invCellSize);
+                if (refX != a.cellX || refY != a.cellY) {
+                    continue;
+                }
+                unsigned int first = std::min(a.colliderIdx, b.colliderIdx);
+                unsigned int second = std::max(a.colliderIdx, b.colliderIdx);
+                m_pairKeys.push_back(((uint64_t)first << 32) | second);
+            }
+        }
+    }
+
+    for (unsigned int oversizedIdx : m_oversized) {
+        AABB2 const& bounds = m_bounds[oversizedIdx];
+        for (unsigned int colliderIdx : m_live) {
+            if (colliderIdx == oversizedIdx || (m_isOversized[colliderIdx] && colliderIdx < oversizedIdx)) {
+                continue;
+            }
+            if (bounds.IsBoundsOverlap(m_bounds[colliderIdx])) {
+                unsigned int first = std::min(oversizedIdx, colliderIdx);
+                unsigned int second = std::max(oversizedIdx, colliderIdx);
+                m_pairKeys.push_back(((uint64_t)first << 32) | second);
+            }
+        }
+    }
+
+    //same order as an all pairs loop
+    std::sort(m_pairKeys.begin(), m_pairKeys.end());
+    outPairs.reserve(m_pairKeys.size());
+    for (uint64_t key : m_pairKeys) {
+        outPairs.emplace_back((unsigned int)(key >> 32), (unsigned int)(key & 0xffffffff));
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void SpatialHashGrid2D::Query(AABB2 const& bounds, std::vector<unsigned int>& outColliderIdxs) const
+{
+    outColliderIdxs.clear();
+    int minX = RoundDownToInt(bounds.mins.x * m_invCellSize);
+    int minY = RoundDownToInt(bounds.mins.y * m_invCellSize);
+    int maxX = RoundDownToInt(bounds.maxs.x * m_invCellSize);
+    int maxY = RoundDownToInt(bounds.maxs.y * m_invCellSize);
+    float cellCount = (float)(maxX - minX + 1) * (float)(maxY - minY + 1);
+
+    if (cellCount > (float)m_live.size()) {     //covers most of the grid, a linear scan is cheaper
+        for (unsigned int colliderIdx : m_live) {
+            if (bounds.IsBoundsOverlap(m_bounds[colliderIdx])) {
+                outColliderIdxs.push_back(colliderIdx);
+            }
+        }
+        return;
+    }
+
+    for (int cellY = minY; cellY <= maxY; cellY++) {
+        for (int cellX = minX; cellX <= maxX; cellX++) {
+            unsigned int bucketIdx = GetBucketIdx(cellX, cellY);
+            unsigned int end = m_bucketStarts[bucketIdx + 1];
+            for (unsigned int i = m_bucketStarts[bucketIdx]; i < end; i++) {
+                Entry const& entry = m_entries[i];
+                if (entry.cellX != cellX || entry.cellY != cellY || !entry.bounds.IsBoundsOverlap(bounds)) {
+                    continue;
+                }
+                //once, from the cell holding the overlap's min corner
+                int refX = RoundDownToInt(std::max(entry.bounds.mins.x, bounds.mins.x) * m_invCellSize);
+                int refY = RoundDownToInt(std::max(entry.bounds.mins.y, bounds.mins.y) * m_invCellSize);
+                if (refX == cellX && refY == cellY) {
+                    outColliderIdxs.push_back(entry.colliderIdx);
+                }
+            }
+        }
+    }
+    for (unsigned int colliderIdx : m_oversized) {
+        if (bounds.IsBoundsOverlap(m_bounds[colliderIdx])) {
+            outColliderIdxs.push_back(colliderIdx);
+        }
+    }
+    std::sort(outColliderIdxs.begin(), outColliderIdxs.end());
+}
+
+//////////////////////////////////////////////////////////////////////////
+// walks the cells the segment crosses in order, an entry spanning several of
+// them is found more than once and deduplicated at the end
+void SpatialHashGrid2D::QueryRay(Vec2 const& start, Vec2 const& end, std::vector<unsigned int>& outColliderIdxs) const
+{
+    outColliderIdxs.clear();
+    int cellX = RoundDownToInt(start.x * m_invCellSize);
+    int cellY = RoundDownToInt(start.y * m_invCellSize);
+    int endCellX = RoundDownToInt(end.x * m_invCellSize);
+    int endCellY = RoundDownToInt(end.y * m_invCellSize);
+    int cellCount = abs(endCellX - cellX) + abs(endCellY - cellY) + 1;
+
+    if (cellCount > (int)m_live.size()) {
+        for (unsigned int colliderIdx : m_live) {
+            if (DoesSegmentHitBounds(start, end, m_bounds[colliderIdx])) {
+                outColliderIdxs.push_back(colliderIdx);
+            }
+        }
+        return;
+    }
+
+    //distance along the segment, in fractions of it, to the next cell border on each axis
+    Vec2 delta = end - start;
+    int stepX = delta.x > 0.f ? 1 : -1;
+    int stepY = delta.y > 0.f ? 1 : -1;
+    float nextBorderX = delta.x != 0.f ? ((float)(cellX + (stepX > 0 ? 1 : 0)) * m_cellSize - start.x) / delta.x : FLT_MAX;
+    float nextBorderY = delta.y != 0.f ? ((float)(cellY + (stepY > 0 ? 1 : 0)) * m_cellSize - start.y) / delta.y : FLT_MAX;
+    float borderStepX = delta.x != 0.f ? m_cellSize / fabsf(delta.x) : FLT_MAX;
+    float borderStepY = delta.y != 0.f ? m_cellSize / fabsf(delta.y) : FLT_MAX;
+
+    //the walk ends on the end cell, the spare step only guards float drift at corners
+    for (int cellIdx = 0; cellIdx < cellCount + 1; cellIdx++) {
+        unsigned int bucketIdx = GetBucketIdx(cellX, cellY);
+        unsigned int bucketEnd = m_bucketStarts[bucketIdx + 1];
+        for (unsigned int i = m_bucketStarts[bucketIdx]; i < bucketEnd; i++) {
+            Entry const& entry = m_entries[i];
+            if (entry.cellX == cellX && entry.cellY == cellY && DoesSegmentHitBounds(start, end, entry.bounds)) {
+                outColliderIdxs.push_back(entry.colliderIdx);
+            }
+        }
+
+        if (cellX == endCellX && cellY == endCellY) {
+            break;
+        }
+        //an axis already on its end cell never steps past it
+        bool isXDone = cellX == endCellX;
+        bool isYDone = cellY == endCellY;
+        if (isYDone || (!isXDone && nextBorderX < nextBorderY)) {
+            cellX += stepX;
+            nextBorderX += borderStepX;
+        }
+        else {
+            cellY += stepY;
+            nextBorderY += borderStepY;
+        }
+    }
+    for (unsigned int colliderIdx : m_oversized) {
+        if (DoesSegmentHitBounds(start, end, m_bounds[colliderIdx])) {
+            outColliderIdxs.push_back(colliderIdx);
+        }
+    }
+    std::sort(outColliderIdxs.begin(), outColliderIdxs.end());
+    outColliderIdxs.erase(std::unique(outColliderIdxs.begin(), outColliderIdxs.end()), outColliderIdxs.end());
+}
+
+//////////////////////////////////////////////////////////////////////////
+float SpatialHashGrid2D::PickCellSize()
+{
+    //median rather than mean so one huge floor doesn't blow the cells up
+    m_sizeScratch.clear();
+    for (unsigned int colliderIdx : m_live) {
+        AABB2 const& bounds = m_bounds[colliderIdx];
+        m_sizeScratch.push_back(std::max(bounds.maxs.x - bounds.mins.x, bounds.maxs.y - bounds.mins.y));
+    }
+    if (m_sizeScratch.empty()) {
+        return m_cellSize;
+    }
+
+    std::vector<float>::iterator median = m_sizeScratch.begin() + m_sizeScratch.size() / 2;
+    std::nth_element(m_sizeScratch.begin(), median, m_sizeScratch.end());
+    return *median > 0.f ? 2.f * *median : m_cellSize;
+}
+
+//////////////////////////////////////////////////////////////////////////
+unsigned int SpatialHashGrid2D::GetBucketIdx(int cellX, int cellY) const
+{
+    return (((unsigned int)cellX * 73856093u) ^ ((unsigned int)cellY * 19349663u)) & m_bucketMask;
+}
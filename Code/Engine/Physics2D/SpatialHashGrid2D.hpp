@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Engine/Physics2D/BroadPhase2D.hpp"
+#include <cstdint>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+// uniform grid hashed into a power of two bucket array, rebuilt from scratch
+// every step. Works best when colliders are of similar size like piles of
+// discs, colliders spanning too many cells (floors, walls) are kept aside
+// and tested against everything instead of being inserted.
+class SpatialHashGrid2D : public BroadPhase2D
+{
+public:
+    explicit SpatialHashGrid2D(float cellSize = 0.f);   //0 picks twice the median collider size each step
+    virtual ~SpatialHashGrid2D() override {}
+
+    virtual void Update(std::vector<Collider2D*> const& colliders) override;
+    virtual void FindPairs(std::vector<ColliderPair2D>& outPairs) override;
+    virtual void Query(AABB2 const& bounds, std::vector<unsigned int>& outColliderIdxs) const override;
+    virtual void QueryRay(Vec2 const& start, Vec2 const& end, std::vector<unsigned int>& outColliderIdxs) const override;
+
+    float GetCellSize() const           { return m_cellSize; }
+    int GetOversizedCount() const       { return (int)m_oversized.size(); }
+
+private:
+    struct Entry
+    {
+        AABB2 bounds;                   //copied in so a bucket scan stays in one array
+        int cellX = 0;
+        int cellY = 0;
+        unsigned int colliderIdx = 0;
+    };
+
+    float PickCellSize();
+    unsigned int GetBucketIdx(int cellX, int cellY) const;
+
+private:
+    float m_configCellSize = 0.f;
+    float m_cellSize = 1.f;
+    float m_invCellSize = 1.f;
+    unsigned int m_bucketMask = 0;
+
+    std::vector<AABB2> m_bounds;            //by collider slot
+    std::vector<unsigned int> m_live;       //slots with a collider this step
+    std::vector<unsigned int> m_oversized;
+    std::vector<bool> m_isOversized;        //by collider slot
+    std::vector<unsigned int> m_bucketStarts;   //bucket count + 1, entries of bucket i are [starts[i], starts[i+1])
+    std::vector<Entry> m_entries;
+    std::vector<float> m_sizeScratch;
+    std::vector<uint64_t> m_pairKeys;
+};
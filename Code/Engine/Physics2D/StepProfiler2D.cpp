@@ -0,0 +1,134 @@
+#include "Engine/Physics2D/StepProfiler2D.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include <algorithm>
+
+static std::vector<StepProfiler2D*> sProfilers;    //physics scenes live on the main thread
+
+//////////////////////////////////////////////////////////////////////////
+StepProfiler2D::StepProfiler2D()
+{
+    sProfilers.push_back(this);
+}
+
+//////////////////////////////////////////////////////////////////////////
+StepProfiler2D::~StepProfiler2D()
+{
+    sProfilers.erase(std::remove(sProfilers.begin(), sProfilers.end(), this), sProfilers.end());
+}
+
+//////////////////////////////////////////////////////////////////////////
+std::vector<StepProfiler2D*> const& StepProfiler2D::GetLiveProfilers()
+{
+    return sProfilers;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void StepProfiler2D::SetEnabled(bool isEnabled)
+{
+    if (isEnabled && !m_isEnabled) {
+        m_samples.assign((size_t)STEP_PROFILE_WINDOW * NUM_STEP_PHASES, 0.0);
+        m_sampleCount = 0;
+        m_nextSample = 0;
+        m_isStepStarted = false;    //a step already running is not recorded
+    }
+    m_isEnabled = isEnabled;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void StepProfiler2D::BeginStep()
+{
+    if (m_isEnabled) {
+        std::fill(m_currentStep, m_currentStep + NUM_STEP_PHASES, 0.0);
+        m_stepStartTime = GetCurrentTimeSeconds();
+        m_isStepStarted = true;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+void StepProfiler2D::EndStep()
+{
+    if (!m_isEnabled || !m_isStepStarted) {
+        return;
+    }
+
+    m_isStepStarted = false;
+    m_currentStep[STEP_PHASE_TOTAL] = GetCurrentTimeSeconds() - m_stepStartTime;
+    std::copy(m_currentStep, m_currentStep + NUM_STEP_PHASES, m_samples.begin() + (size_t)m_nextSample * NUM_STEP_PHASES);
+    m_nextSample = (m_nextSample + 1) % STEP_PROFILE_WINDOW;
+    m_sampleCount = std::min(m_sampleCount + 1, STEP_PROFILE_WINDOW);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void StepProfiler2D::AddPhaseTime(eStepPhase2D phase, double seconds)
+{
+    m_currentStep[phase] += seconds;     //a phase may run in several pieces per step
+}
+
+//////////////////////////////////////////////////////////////////////////
+StepPhaseStats2D StepProfiler2D::GetPhaseStats(eStepPhase2D phase) const
+{
+    StepPhaseStats2D stats;
+    if (m_sampleCount == 0) {
+        return stats;
+    }
+
+    std::vector<double> times((size_t)m_sampleCount);
+    double sum = 0.0;
+    for (int sampleIdx = 0; sampleIdx < m_sampleCount; sampleIdx++) {
+        times[sampleIdx] = m_samples[(size_t)sampleIdx * NUM_STEP_PHASES + phase] * 1000.0;
+        sum += times[sampleIdx];
+    }
+    int lastSample = (m_nextSample + STEP_PROFILE_WINDOW - 1) % STEP_PROFILE_WINDOW;
+    stats.lastMs = m_samples[(size_t)lastSample * NUM_STEP_PHASES + phase] * 1000.0;
+    stats.averageMs = sum / (double)m_sampleCount;
+    std::sort(times.begin(), times.end());
+    stats.medianMs = times[times.size() / 2];
+    stats.maxMs = times.back();
+    return stats;
+}
+
+//////////////////////////////////////////////////////////////////////////
+std::vector<std::string> StepProfiler2D::GetReport() const
+{
+    std::vector<std::string> lines;
+    lines.push_back(Stringf("%-14s %9s %9s %9s %9s %7s", "phase", "last ms", "avg ms", "p50 ms", "max ms", "share"));
+    double totalMs = GetPhaseStats(STEP_PHASE_TOTAL).averageMs;
+    for (int phaseIdx = 0; phaseIdx < NUM_STEP_PHASES; phaseIdx++) {
+        StepPhaseStats2D stats = GetPhaseStats((eStepPhase2D)phaseIdx);
+        double share = totalMs > 0.0 ? stats.averageMs * 100.0 / totalMs : 0.0;
+        lines.push_back(Stringf("%-14s %9.3f %9.3f %9.3f %9.3f %6.1f%%", GetPhaseName((eStepPhase2D)phaseIdx),
+            stats.lastMs, stats.averageMs, stats.medianMs, stats.maxMs, share));
+    }
+    return lines;
+}
+
+//////////////////////////////////////////////////////////////////////////
+char const* StepProfiler2D::GetPhaseName(eStepPhase2D phase)
+{
+    static char const* sPhaseNames[NUM_STEP_PHASES] = {
+        "step", "fixed update", "broad phase", "narrow phase", "solver",
+        "integrate", "continuous", "events", "sleep", "cleanup"
+    };
+    return sPhaseNames[phase];
+}
+
+//////////////////////////////////////////////////////////////////////////
+ScopedStepPhase2D::ScopedStepPhase2D(StepProfiler2D& profiler, eStepPhase2D phase)
+    : m_profiler(profiler)
+    , m_phase(phase)
+{
+    m_isTimed = m_profiler.IsEnabled();
+    if (m_isTimed) {
+        m_startTime = GetCurrentTimeSeconds();
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+ScopedStepPhase2D::~ScopedStepPhase2D()
+{
+    //enabled while this phase ran, it has no start time
+    if (m_isTimed && m_profiler.IsEnabled()) {
+        m_profiler.AddPhaseTime(m_phase, GetCurrentTimeSeconds() - m_startTime);
+    }
+}
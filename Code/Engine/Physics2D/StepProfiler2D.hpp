@@ -0,0 +1,84 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+enum eStepPhase2D
+{
+    STEP_PHASE_TOTAL,           //whole AdvanceSimulation
+    STEP_PHASE_FIXED_UPDATE,    //onFixedUpdate subscribers
+    STEP_PHASE_BROAD_PHASE,
+    STEP_PHASE_NARROW_PHASE,
+    STEP_PHASE_SOLVER,          //islands, impulses and the contact cache
+    STEP_PHASE_INTEGRATE,
+    STEP_PHASE_CONTINUOUS,
+    STEP_PHASE_EVENTS,          //overlap, trigger and collision callbacks or queued events
+    STEP_PHASE_SLEEP,
+    STEP_PHASE_CLEANUP,
+
+    NUM_STEP_PHASES
+};
+
+struct StepPhaseStats2D
+{
+    double lastMs = 0.0;
+    double averageMs = 0.0;
+    double medianMs = 0.0;
+    double maxMs = 0.0;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// time per step phase over the last STEP_PROFILE_WINDOW steps. Off by
+// default, a disabled scope is one branch. Every live profiler is listed for
+// the physics_profile console commands.
+constexpr int STEP_PROFILE_WINDOW = 240;
+
+class StepProfiler2D
+{
+public:
+    StepProfiler2D();
+    ~StepProfiler2D();
+    StepProfiler2D(StepProfiler2D const&) = delete;
+    StepProfiler2D& operator=(StepProfiler2D const&) = delete;
+
+    void SetEnabled(bool isEnabled);    //enabling starts a new window
+    bool IsEnabled() const                      { return m_isEnabled; }
+    void SetName(std::string const& name)       { m_name = name; }
+    std::string const& GetName() const          { return m_name; }
+
+    void BeginStep();   //times STEP_PHASE_TOTAL up to EndStep
+    void EndStep();
+    void AddPhaseTime(eStepPhase2D phase, double seconds);
+
+    int GetSampleCount() const                  { return m_sampleCount; }
+    StepPhaseStats2D GetPhaseStats(eStepPhase2D phase) const;
+    std::vector<std::string> GetReport() const;     //a line per phase
+
+    static char const* GetPhaseName(eStepPhase2D phase);
+    static std::vector<StepProfiler2D*> const& GetLiveProfilers();
+
+private:
+    bool m_isEnabled = false;
+    std::string m_name;
+    int m_sampleCount = 0;          //steps in the window, up to STEP_PROFILE_WINDOW
+    int m_nextSample = 0;
+    bool m_isStepStarted = false;   //BeginStep ran while enabled
+    double m_stepStartTime = 0.0;
+    double m_currentStep[NUM_STEP_PHASES] = {};
+    std::vector<double> m_samples;  //ring of NUM_STEP_PHASES seconds per step
+};
+
+//////////////////////////////////////////////////////////////////////////
+class ScopedStepPhase2D
+{
+public:
+    ScopedStepPhase2D(StepProfiler2D& profiler, eStepPhase2D phase);
+    ~ScopedStepPhase2D();
+
+private:
+    StepProfiler2D& m_profiler;
+    eStepPhase2D m_phase;
+    bool m_isTimed = false;
+    double m_startTime = 0.0;
+};
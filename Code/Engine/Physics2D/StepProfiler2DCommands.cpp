@@ -0,0 +1,43 @@
+#include "Engine/Physics2D/StepProfiler2D.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/NamedProperties.hpp"
+#include "Engine/Core/StringUtils.hpp"
+
+//////////////////////////////////////////////////////////////////////////
+COMMAND(physics_profile, "start or stop timing step phases of every physics scene, enable=true", eEventFlag::EVENT_CONSOLE)
+{
+    bool isEnabled = args.GetValue("enable", true);
+    isEnabled = args.GetValue("0", isEnabled);
+    std::vector<StepProfiler2D*> const& profilers = StepProfiler2D::GetLiveProfilers();
+    for (StepProfiler2D* profiler : profilers) {
+        profiler->SetEnabled(isEnabled);
+    }
+    g_theConsole->PrintString(Rgba8::WHITE, Stringf("step profiling %s for %i physics scenes", isEnabled ? "started" : "stopped", (int)profilers.size()));
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+COMMAND(physics_profile_dump, "print step phase times of every profiled physics scene", eEventFlag::EVENT_CONSOLE)
+{
+    UNUSED(args);
+    int dumpedCount = 0;
+    for (StepProfiler2D const* profiler : StepProfiler2D::GetLiveProfilers()) {
+        if (profiler->GetSampleCount() == 0) {
+            continue;
+        }
+        std::string name = profiler->GetName().empty() ? Stringf("scene %i", dumpedCount) : profiler->GetName();
+        g_theConsole->PrintString(Rgba8(255, 255, 0), Stringf("%s, last %i steps", name.c_str(), profiler->GetSampleCount()));
+        for (std::string const& line : profiler->GetReport()) {
+            g_theConsole->PrintString(Rgba8::WHITE, line);
+        }
+        dumpedCount++;
+    }
+    if (dumpedCount == 0) {
+        g_theConsole->PrintError("no profiled physics steps, run physics_profile first");
+        return false;
+    }
+    return true;
+}
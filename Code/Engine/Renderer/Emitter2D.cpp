@@ -48,15 +48,29 @@ Emitter2D::Emitter2D(unsigned int particleNum, Vec2 const& position, Vec2 const&
 
     size_t totalParticleNum = particleNum > MAX_PARTICLE_PER_EMITTER ? MAX_PARTICLE_PER_EMITTER : particleNum;
     m_particles.reserve(totalParticleNum);
-    for (size_t i = 0; i < totalParticleNum; i++) {
-        float orientDir = m_rng->RollRandomFloatZeroToAlmostOne()>=.5f ? 1.f:-1.f;
-        float orientDegrees = m_orientDegrees + orientDir * m_deltaStartOrientDegrees.GetRandomInRange(*m_rng);
+
+    //every roll up front in batches, one run of rolls per particle property
+    int particleCount = (int)totalParticleNum;
+    std::vector<float> rolls(totalParticleNum * 5);
+    float* flipRolls = rolls.data();
+    float* orientRolls = flipRolls + particleCount;
+    float* speedRolls = orientRolls + particleCount;
+    float* scaleRolls = speedRolls + particleCount;
+    float* ageRolls = scaleRolls + particleCount;
+    m_rng->FillRandomFloatsInRange(flipRolls, particleCount, 0.f, 1.f);
+    m_rng->FillRandomFloatsInRange(orientRolls, particleCount, m_deltaStartOrientDegrees.minimum, m_deltaStartOrientDegrees.maximum);
+    m_rng->FillRandomFloatsInRange(speedRolls, particleCount, m_deltaStartSpeed.minimum, m_deltaStartSpeed.maximum);
+    m_rng->FillRandomFloatsInRange(scaleRolls, particleCount, m_deltaStartScaleFraction.minimum, m_deltaStartScaleFraction.maximum);
+    m_rng->FillRandomFloatsInRange(ageRolls, particleCount, m_deltaMaxAgeFraction.minimum, m_deltaMaxAgeFraction.maximum);
+    for (int i = 0; i < particleCount; i++) {
+        float orientDir = flipRolls[i]>=.5f ? 1.f:-1.f;
+        float orientDegrees = m_orientDegrees + orientDir * orientRolls[i];
         Vec2 startDir = Vec2::MakeFromPolarDegrees(orientDegrees);
         m_particles.emplace_back(m_startPos, 
             orientDegrees, 
-            m_velocity + startDir*m_deltaStartSpeed.GetRandomInRange(*m_rng), 
-            m_initScale*m_deltaStartScaleFraction.GetRandomInRange(*m_rng), 
-            m_maxAge*m_deltaMaxAgeFraction.GetRandomInRange(*m_rng), 
+            m_velocity + startDir*speedRolls[i], 
+            m_initScale*scaleRolls[i], 
+            m_maxAge*ageRolls[i], 
             m_tint);
     }
 }
@@ -4,6 +4,7 @@
 #include "Engine/Renderer/RenderContext.hpp"
 #include "Engine/Renderer/Sampler.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/FileParseJob.hpp"
 
 //////////////////////////////////////////////////////////////////////////
 Material::~Material()
@@ -21,7 +22,7 @@ Material::~Material()
 void Material::SetFromFile(char const* filePath, RenderContext* context)
 {
     XmlDocument matFile;
-    XmlError code = matFile.LoadFile(filePath);
+    XmlError code = LoadXmlFile(filePath, matFile);
     GUARANTEE_OR_DIE(code == XmlError::XML_SUCCESS, Stringf("Error when loading %s", filePath));
 
     XmlElement* root = matFile.RootElement();
@@ -35,12 +36,22 @@ void Material::SetFromFile(char const* filePath, RenderContext* context)
     std::string normalPath = ParseXmlAttribute(*root, "normal", "Flat");
     std::string specPath = ParseXmlAttribute(*root, "spec", "White");
     std::string emsvPath = ParseXmlAttribute(*root, "emissive", "Black");
+
+    //decode every texture of this material in one batch, the lookups below hit the cache
+    std::vector<std::string> texturePaths = { diffusePath, normalPath, specPath, emsvPath };
+    XmlElement* textures = root->FirstChildElement("Textures");
+    if (textures != nullptr) {
+        for (XmlElement* tex = textures->FirstChildElement("Texture"); tex != nullptr; tex = tex->NextSiblingElement("Texture")) {
+            texturePaths.push_back(ParseXmlAttribute(*tex, "file", "White"));
+        }
+    }
+    context->PreloadTexturesFromFiles(texturePaths);
+
     m_diffuseTexture = context->CreateOrGetTextureFromFile(diffusePath.c_str());
     m_normalTexture = context->CreateOrGetTextureFromFile(normalPath.c_str());
     m_specularTexture = context->CreateOrGetTextureFromFile(specPath.c_str());
     m_emissiveTexture = context->CreateOrGetTextureFromFile(emsvPath.c_str());
 
-    XmlElement* textures = root->FirstChildElement("Textures");
     if (textures != nullptr) {
         XmlElement* tex = textures->FirstChildElement("Texture");
         while (tex != nullptr) {
@@ -20,8 +20,10 @@
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Core/Time.hpp"
 #include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/FileParseJob.hpp"
 #include "Engine/Platform/Window.hpp"
 #include "Engine/Renderer/D3D11Common.hpp"
+#include <algorithm>
 
 #pragma comment( lib, "d3d11.lib" )         // needed a01
 #pragma comment( lib, "dxgi.lib" )          // needed a01
@@ -577,6 +579,35 @@ Texture* RenderContext::CreateOrGetTextureFromFile(const char* filePath, bool re
 		return nullptr;
 }
 
+//////////////////////////////////////////////////////////////////////////
+void RenderContext::PreloadTexturesFromFiles(std::vector<std::string> const& filePaths, bool flipVertical/*true*/)
+{
+	std::vector<std::string> pathsToLoad;
+	for (std::string const& filePath : filePaths) {
+		bool isKnown = std::find(pathsToLoad.begin(), pathsToLoad.end(), filePath) != pathsToLoad.end();
+		for (size_t textureID = 0; textureID < m_loadedTextures.size() && !isKnown; textureID++) {
+			isKnown = m_loadedTextures[textureID]->GetTexturePath() == filePath;
+		}
+		if (!isKnown) {
+			pathsToLoad.push_back(filePath);
+		}
+	}
+	if (pathsToLoad.empty()) {
+		return;
+	}
+
+	std::vector<Texture*> newTextures;
+	Texture::CreateTexturesFromFiles(this, pathsToLoad, flipVertical, newTextures);
+	for (size_t fileIdx = 0; fileIdx < pathsToLoad.size(); fileIdx++) {
+		if (newTextures[fileIdx] != nullptr) {
+			m_loadedTextures.push_back(newTextures[fileIdx]);
+		}
+		else {
+			g_theConsole->PrintError(Stringf("load %s failed", pathsToLoad[fileIdx].c_str()));
+		}
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////
 BitmapFont* RenderContext::CreateOrGetBitmapFont( const char* filePathNoExtension )
 {
@@ -604,7 +635,7 @@ BitmapFont* RenderContext::CreateBitmapFontFromFile( const char* filePath )
 ShaderState* RenderContext::CreateShaderStateFromFile(char const* filePath)
 {
 	XmlDocument shaderStateDoc;
-	XmlError code = shaderStateDoc.LoadFile(filePath);
+	XmlError code = LoadXmlFile(filePath, shaderStateDoc);
 	GUARANTEE_OR_DIE(code == XmlError::XML_SUCCESS, Stringf("Error when loading %s", filePath));
 
 	ShaderState* newState = new ShaderState(this);
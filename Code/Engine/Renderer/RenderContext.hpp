@@ -114,6 +114,8 @@ public:
 	ShaderState* CreateOrGetShaderState(char const* filename);
 	Shader* CreateOrGetShader( char const* filename );
 	Texture* CreateOrGetTextureFromFile( const char* filePath, bool reload=false, bool flipVertical=true);
+	//loads every path not yet cached in one batch, reads on the JOB_DISK lane and decodes on workers
+	void PreloadTexturesFromFiles( std::vector<std::string> const& filePaths, bool flipVertical=true );
 	BitmapFont* CreateOrGetBitmapFont( const char* filePathNoExtension );
 
 	void Draw( int numVertexes, int vertexOffset = 0 );
@@ -6,6 +6,8 @@
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/DevConsole.hpp"
 #include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/FileParseJob.hpp"
+#include <string.h>
 
 #pragma warning(push)
 #pragma warning(disable:4100)
@@ -14,6 +16,57 @@
 #pragma  warning(pop)
 
 
+//////////////////////////////////////////////////////////////////////////
+// RGBA texels of one file, filled by a decode job on a CPU worker
+struct DecodedTexels
+{
+    std::vector<unsigned char> texels;
+    IntVec2 size;
+    int numComponents = 0;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// decodes a texture file once the disk lane read it. The stb flip flag is
+// global, so rows are flipped here and the flag stays off while decoding
+class TextureDecodeJob : public FileParseJob
+{
+public:
+    TextureDecodeJob(std::string const& filePath, bool flipVertical, DecodedTexels* outTexels)
+        : FileParseJob(filePath, true)
+        , m_flipVertical(flipVertical)
+        , m_outTexels(outTexels) {}
+
+    virtual void ParseFile(char const* fileData, size_t fileSize) override
+    {
+        if (fileData == nullptr) {
+            return;
+        }
+
+        int sizeX = 0;
+        int sizeY = 0;
+        int numComponents = 0;
+        unsigned char* imageData = stbi_load_from_memory((unsigned char const*)fileData, (int)fileSize, &sizeX, &sizeY, &numComponents, 4);
+        if (imageData == nullptr || sizeX <= 0 || sizeY <= 0) {
+            stbi_image_free(imageData);
+            return;
+        }
+
+        size_t rowBytes = (size_t)sizeX * 4;
+        m_outTexels->texels.resize(rowBytes * (size_t)sizeY);
+        for (int rowIdx = 0; rowIdx < sizeY; rowIdx++) {
+            int srcRow = m_flipVertical ? sizeY - 1 - rowIdx : rowIdx;
+            memcpy(&m_outTexels->texels[rowBytes * rowIdx], imageData + rowBytes * srcRow, rowBytes);
+        }
+        m_outTexels->size = IntVec2(sizeX, sizeY);
+        m_outTexels->numComponents = numComponents;
+        stbi_image_free(imageData);
+    }
+
+private:
+    bool m_flipVertical = true;
+    DecodedTexels* m_outTexels = nullptr;
+};
+
 //////////////////////////////////////////////////////////////////////////
 Texture* Texture::CreateTextureFromFile(RenderContext* ctx, char const* filePath, bool flipVertical)
 {
@@ -33,10 +86,47 @@ Texture* Texture::CreateTextureFromFile(RenderContext* ctx, char const* filePath
         g_theConsole->PrintString(Rgba8::RED, Stringf("picture %s has %i channels", filePath, numComponents));
     }
 
+    Texture* newTexture = CreateTextureFromTexels(ctx, imageData, IntVec2(imageTexelSizeX, imageTexelSizeY), filePath);
+
+    // Free the raw image texel data now that we've sent a copy of it down to the GPU to be stored in video memory
+    stbi_image_free(imageData);
+    return newTexture;
+}
+
+//////////////////////////////////////////////////////////////////////////
+void Texture::CreateTexturesFromFiles(RenderContext* ctx, std::vector<std::string> const& filePaths, bool flipVertical, std::vector<Texture*>& outTextures)
+{
+    std::vector<DecodedTexels> decoded(filePaths.size());
+    std::vector<FileParseJob*> jobs;
+    for (size_t fileIdx = 0; fileIdx < filePaths.size(); fileIdx++) {
+        jobs.push_back(new TextureDecodeJob(filePaths[fileIdx], flipVertical, &decoded[fileIdx]));
+    }
+    stbi_set_flip_vertically_on_load(0);
+    RunFileParseJobs(jobs);
+
+    //device calls stay on this thread
+    outTextures.assign(filePaths.size(), nullptr);
+    for (size_t fileIdx = 0; fileIdx < filePaths.size(); fileIdx++) {
+        DecodedTexels const& texels = decoded[fileIdx];
+        char const* filePath = filePaths[fileIdx].c_str();
+        if (texels.texels.empty()) {
+            g_theConsole->PrintString(Rgba8::RED, Stringf("picture %s reading failed", filePath));
+            continue;
+        }
+        if (texels.numComponents < 3 || texels.numComponents > 4) {
+            g_theConsole->PrintString(Rgba8::RED, Stringf("picture %s has %i channels", filePath, texels.numComponents));
+        }
+        outTextures[fileIdx] = CreateTextureFromTexels(ctx, texels.texels.data(), texels.size, filePath);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+Texture* Texture::CreateTextureFromTexels(RenderContext* ctx, unsigned char const* rgbaTexels, IntVec2 const& texelSize, char const* filePath)
+{
     //DirectX create
     D3D11_TEXTURE2D_DESC desc;
-    desc.Width = imageTexelSizeX;
-    desc.Height = imageTexelSizeY;
+    desc.Width = texelSize.x;
+    desc.Height = texelSize.y;
     desc.MipLevels = 1;//2^ dimension, smoothed
     desc.ArraySize = 1;
     desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
@@ -48,16 +138,12 @@ Texture* Texture::CreateTextureFromFile(RenderContext* ctx, char const* filePath
     desc.MiscFlags = 0;
 
     D3D11_SUBRESOURCE_DATA initialData;
-    initialData.pSysMem = imageData;
-    initialData.SysMemPitch = imageTexelSizeX * 4;//continuous could be 0
+    initialData.pSysMem = rgbaTexels;
+    initialData.SysMemPitch = texelSize.x * 4;//continuous could be 0
     initialData.SysMemSlicePitch = 0;
 
     ID3D11Texture2D* texHandle = nullptr;
     ctx->m_device->CreateTexture2D(&desc, &initialData, &texHandle);
-
-    // Free the raw image texel data now that we've sent a copy of it down to the GPU to be stored in video memory
-    stbi_image_free(imageData);
-
     return new Texture(ctx, texHandle, filePath);
 }
 
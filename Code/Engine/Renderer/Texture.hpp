@@ -2,6 +2,7 @@
 
 #include "Engine/Math/IntVec2.hpp"
 #include <string>
+#include <vector>
 
 struct ID3D11Texture2D;
 struct ID3D11Resource;
@@ -12,6 +13,9 @@ class Texture
 {
 public:
 	static Texture* CreateTextureFromFile(RenderContext* ctx, char const* filePath, bool flipVertical=true);
+	//files read on the JOB_DISK lane and decoded on CPU workers, device calls on this thread. nullptr for failed files
+	static void CreateTexturesFromFiles(RenderContext* ctx, std::vector<std::string> const& filePaths, bool flipVertical, std::vector<Texture*>& outTextures);
+	static Texture* CreateTextureFromTexels(RenderContext* ctx, unsigned char const* rgbaTexels, IntVec2 const& texelSize, char const* filePath);
 	static Texture* CreateDepthStencilTexture(RenderContext* ctx, IntVec2 const& outputSize);
 
 	explicit Texture(RenderContext* ctx, ID3D11Texture2D* handle );